@@ -0,0 +1,156 @@
+/*_############################################################################
+ * _##
+ * _##  benchDecode.cpp
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+/*
+ * Compare decoding a response with SnmpMessage::unload() when the raw
+ * pdu is allocated from the heap and from an SnmpArena, as done by the
+ * message queue for received responses.
+ *
+ * usage: benchDecode [vb count] [iterations]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <libsnmp.h>
+#include <snmp_pp/snmp_pp.h>
+#include <snmp_pp/snmpmsg.h>
+
+using namespace Snmp_pp;
+
+static void create_pdu(Pdu& pdu, const int vb_count)
+{
+    pdu.set_type(sNMP_PDU_RESPONSE);
+    pdu.set_request_id(1234567);
+
+    for (int i = 0; i < vb_count; i++)
+    {
+        Vb  vb;
+        Oid oid("1.3.6.1.2.1.2.2.1");
+
+        oid += (unsigned long)(2 + (i % 20));
+        oid += (unsigned long)(i + 1);
+        vb.set_oid(oid);
+        switch (i % 5)
+        {
+        case 0: vb.set_value(OctetStr("eth0 - network interface")); break;
+        case 1: vb.set_value(Counter32(4000000000U - i)); break;
+        case 2: vb.set_value(Counter64(0x123456789ULL * (i + 1))); break;
+        case 3: vb.set_value(SnmpInt32(-i * 1000)); break;
+        default: vb.set_value(Oid("1.3.6.1.4.1.4976.1.2.3"));
+        }
+        pdu += vb;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int vb_count   = 50;
+    int iterations = 100000;
+
+    if (argc > 1)
+    {
+        vb_count = atoi(argv[1]);
+    }
+    if (argc > 2)
+    {
+        iterations = atoi(argv[2]);
+    }
+
+    Pdu pdu;
+    create_pdu(pdu, vb_count);
+
+    SnmpMessage    msg;
+    OctetStr const community("public");
+    if (msg.load(pdu, community, version2c) != SNMP_CLASS_SUCCESS)
+    {
+        std::cerr << "Encoding failed, reduce the number of vbs"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    uint32_t const len = msg.len();
+    unsigned char* buf = new unsigned char[len];
+    memcpy(buf, msg.data(), len);
+
+    std::cout << "Message with " << vb_count << " vbs: " << len
+              << " bytes, " << iterations << " iterations" << std::endl;
+
+    SnmpArena arena;
+    Pdu       received;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        auto const start = std::chrono::steady_clock::now();
+
+        unsigned long const allocations = arena.get_allocation_count();
+        for (int i = 0; i < iterations; i++)
+        {
+            SnmpMessage  in;
+            OctetStr     in_community;
+            snmp_version in_version = version1;
+
+            in.load(buf, len);
+            if (pass == 1)
+            {
+                in.set_arena(&arena);
+            }
+            received.clear();
+            if ((in.unload(received, in_community, in_version)
+                    != SNMP_CLASS_SUCCESS)
+                || (received.get_vb_count() != vb_count))
+            {
+                std::cerr << "Decoding failed" << std::endl;
+                delete[] buf;
+                return EXIT_FAILURE;
+            }
+            arena.reset();
+        }
+
+        std::chrono::duration<double> const elapsed =
+            std::chrono::steady_clock::now() - start;
+        double const seconds = elapsed.count() > 0 ? elapsed.count() : 1e-9;
+
+        std::cout << (pass == 0 ? "heap:  " : "arena: ")
+                  << iterations / seconds << " messages/s";
+        if (pass == 1)
+        {
+            double const per_message =
+                (double)(arena.get_allocation_count() - allocations)
+                / iterations;
+
+            std::cout << ", " << per_message
+                      << " allocations per message from "
+                      << arena.get_block_count() << " heap block(s)";
+        }
+        std::cout << std::endl;
+    }
+
+    delete[] buf;
+    return EXIT_SUCCESS;
+}
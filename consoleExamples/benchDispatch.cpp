@@ -0,0 +1,182 @@
+/*_############################################################################
+ * _##
+ * _##  benchDispatch.cpp
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+
+/*
+ * Measure the lookup of outstanding requests by request id, which is
+ * done for each received response. GetEntry() and DeleteEntry() of the
+ * message queue use a hash index, they are compared to a scan of a list
+ * of the same messages, as done before the index was added.
+ *
+ * usage: benchDispatch [lookups] [outstanding requests...]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <libsnmp.h>
+#include <list>
+#include <snmp_pp/msgqueue.h>
+#include <snmp_pp/snmp_pp.h>
+#include <vector>
+
+using namespace Snmp_pp;
+
+static void report(const char* name, const int ops,
+    const std::chrono::steady_clock::time_point& start)
+{
+    std::chrono::duration<double> const elapsed =
+        std::chrono::steady_clock::now() - start;
+    double const seconds = elapsed.count() > 0 ? elapsed.count() : 1e-9;
+
+    std::cout << name << ops / seconds << " ops/s" << std::endl;
+}
+
+// the lookup before the index: walk the list until the id matches
+static CSNMPMessage* scan(
+    const std::list<CSNMPMessage*>& messages, const uint32_t id)
+{
+    for (auto* msg : messages)
+    {
+        if (msg->GetId() == id)
+        {
+            return msg;
+        }
+    }
+    return nullptr;
+}
+
+int main(int argc, char** argv)
+{
+    int              lookups = 100000;
+    std::vector<int> counts  = { 100, 1000, 20000 };
+
+    if (argc > 1)
+    {
+        lookups = atoi(argv[1]);
+    }
+    if (argc > 2)
+    {
+        counts.clear();
+        for (int i = 2; i < argc; i++) { counts.push_back(atoi(argv[i])); }
+    }
+    if (lookups <= 0)
+    {
+        std::cerr << "usage: benchDispatch [lookups] [outstanding requests...]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    DefaultLog::log()->set_profile("quiet");
+
+    int  status = 0;
+    Snmp snmp(status);
+    if (status != SNMP_CLASS_SUCCESS)
+    {
+        std::cerr << "Could not create session: " << snmp.error_msg(status)
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    CSNMPMessageQueue* queue = snmp.get_eventListHolder()->snmpEventList();
+    UdpAddress const   address("127.0.0.1/161");
+    CTarget const      target(address);
+    Pdu const          pdu;
+    unsigned char      raw[] = { 0x30, 0x00 };
+    unsigned           found = 0;
+
+    for (int count : counts)
+    {
+        if (count <= 0)
+        {
+            continue;
+        }
+        std::cout << count << " outstanding requests, " << lookups
+                  << " lookups" << std::endl;
+
+        // request ids are consecutive like the ones of Snmp::MyMakeReqId()
+        uint32_t const first = PDU_MIN_RID + (uint32_t)(rand() % 1000);
+
+        std::vector<uint32_t>    ids(count);
+        std::list<CSNMPMessage*> messages;
+        for (int i = 0; i < count; i++)
+        {
+            ids[i] = first + i;
+            messages.push_front(queue->AddEntry(ids[i], &snmp,
+                INVALID_SOCKET, target, pdu, raw, sizeof(raw), address,
+                nullptr, nullptr));
+        }
+
+        // responses arrive in random order
+        std::vector<uint32_t> order(ids);
+        for (int i = count - 1; i > 0; i--)
+        {
+            std::swap(order[i], order[rand() % (i + 1)]);
+        }
+
+        // the list scan is much slower, limit its time
+        int const scans = (lookups < 50000000 / count) ? lookups
+                                                       : 50000000 / count;
+        auto      start = std::chrono::steady_clock::now();
+        for (int i = 0; i < scans; i++)
+        {
+            found += scan(messages, order[i % count]) ? 1 : 0;
+        }
+        report("  list scan:     ", scans, start);
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t id : order)
+        {
+            auto it = messages.begin();
+            while ((it != messages.end()) && ((*it)->GetId() != id)) { ++it; }
+            if (it != messages.end())
+            {
+                messages.erase(it);
+                ++found;
+            }
+        }
+        report("  list remove:   ", count, start);
+
+        queue->lock();
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < lookups; i++)
+        {
+            found += queue->GetEntry(order[i % count]) ? 1 : 0;
+        }
+        report("  GetEntry():    ", lookups, start);
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t id : order)
+        {
+            found += (queue->DeleteEntry(id) == SNMP_CLASS_SUCCESS) ? 1 : 0;
+        }
+        report("  DeleteEntry(): ", count, start);
+        queue->unlock();
+    }
+
+    return (found > 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,209 @@
+/*_############################################################################
+ * _##
+ * _##  benchEncode.cpp
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+/*
+ * Compare the throughput of the reverse BER encoder used by snmp_build()
+ * with the forward encoder (build_vb() and build_data_pdu()), which
+ * builds nested objects in temporary buffers and copies them.
+ *
+ * usage: benchEncode [vb count] [iterations]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <libsnmp.h>
+#include <snmp_pp/asn1.h>
+#include <snmp_pp/snmp_pp.h>
+#include <snmp_pp/snmpmsg.h>
+
+using namespace Snmp_pp;
+
+// snmp_build() of SNMP++ 3.4.7, using the forward encoder
+static int forward_build(struct snmp_pdu* pdu, unsigned char* packet,
+    int* out_length, const snmp_version version,
+    const unsigned char* community, const int community_len)
+{
+    unsigned char  buf[MAX_SNMP_PACKET];
+    unsigned char* cp     = nullptr;
+    int            length = *out_length;
+
+    cp = build_vb(pdu, packet, &length);
+    if (cp == nullptr)
+    {
+        return -1;
+    }
+    int vb_length = SAFE_INT_CAST(cp - packet);
+
+    length = MAX_SNMP_PACKET;
+    cp     = build_data_pdu(pdu, buf, &length, packet, vb_length);
+    if (cp == nullptr)
+    {
+        return -1;
+    }
+    int const pdu_length = SAFE_INT_CAST(cp - buf);
+
+    SmiINT32 const v = version;
+    length           = *out_length;
+    cp               = asn_build_sequence(packet, &length, ASN_SEQ_CON,
+                      pdu_length + community_len + 5);
+    if (cp)
+    {
+        cp = asn_build_int(cp, &length, ASN_UNI_PRIM | ASN_INTEGER, &v);
+    }
+    if (cp)
+    {
+        cp = asn_build_string(cp, &length, ASN_UNI_PRIM | ASN_OCTET_STR,
+            community, community_len);
+    }
+    if ((cp == nullptr) || (length < pdu_length))
+    {
+        return -1;
+    }
+    memcpy(cp, buf, pdu_length);
+    *out_length = SAFE_INT_CAST(cp - packet) + pdu_length;
+    return 0;
+}
+
+static struct snmp_pdu* create_pdu(const int vb_count)
+{
+    struct snmp_pdu* raw_pdu = snmp_pdu_create(sNMP_PDU_RESPONSE);
+
+    raw_pdu->reqid    = 1234567;
+    raw_pdu->errstat  = 0;
+    raw_pdu->errindex = 0;
+
+    for (int i = 0; i < vb_count; i++)
+    {
+        Vb  vb;
+        Oid oid("1.3.6.1.2.1.2.2.1");
+
+        oid += (unsigned long)(2 + (i % 20));
+        oid += (unsigned long)(i + 1);
+        vb.set_oid(oid);
+        switch (i % 5)
+        {
+        case 0: vb.set_value(OctetStr("eth0 - network interface")); break;
+        case 1: vb.set_value(Counter32(4000000000U - i)); break;
+        case 2: vb.set_value(Counter64(0x123456789ULL * (i + 1))); break;
+        case 3: vb.set_value(SnmpInt32(-i * 1000)); break;
+        default: vb.set_value(Oid("1.3.6.1.4.1.4976.1.2.3"));
+        }
+
+        SmiVALUE smival;
+        if (convertVbToSmival(vb, &smival) != SNMP_CLASS_SUCCESS)
+        {
+            snmp_free_pdu(raw_pdu);
+            return nullptr;
+        }
+        snmp_add_var(raw_pdu, oid.oidval()->ptr, (int)oid.len(), &smival);
+        freeSmivalDescriptor(&smival);
+    }
+    return raw_pdu;
+}
+
+int main(int argc, char** argv)
+{
+    int vb_count   = 20;
+    int iterations = 100000;
+
+    if (argc > 1)
+    {
+        vb_count = atoi(argv[1]);
+    }
+    if (argc > 2)
+    {
+        iterations = atoi(argv[2]);
+    }
+
+    struct snmp_pdu* raw_pdu = create_pdu(vb_count);
+    if (!raw_pdu)
+    {
+        std::cerr << "Could not create the PDU" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const unsigned char community[] = "public";
+    unsigned char       forward[MAX_SNMP_PACKET];
+    unsigned char       reverse[MAX_SNMP_PACKET];
+    int                 forward_len = MAX_SNMP_PACKET;
+    int                 reverse_len = MAX_SNMP_PACKET;
+
+    // both encoders have to produce the same message
+    if ((forward_build(raw_pdu, forward, &forward_len, version2c, community,
+             6) != 0)
+        || (snmp_build(
+                raw_pdu, reverse, &reverse_len, version2c, community, 6)
+            != 0))
+    {
+        std::cerr << "Encoding failed, reduce the number of vbs"
+                  << std::endl;
+        snmp_free_pdu(raw_pdu);
+        return EXIT_FAILURE;
+    }
+    if ((forward_len != reverse_len)
+        || (memcmp(forward, reverse, forward_len) != 0))
+    {
+        std::cerr << "Encodings differ" << std::endl;
+        snmp_free_pdu(raw_pdu);
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Message with " << vb_count << " vbs: " << forward_len
+              << " bytes, " << iterations << " iterations" << std::endl;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        auto const start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < iterations; i++)
+        {
+            int len = MAX_SNMP_PACKET;
+            if (pass == 0)
+            {
+                forward_build(raw_pdu, forward, &len, version2c, community, 6);
+            }
+            else
+            {
+                snmp_build(raw_pdu, reverse, &len, version2c, community, 6);
+            }
+        }
+
+        std::chrono::duration<double> const elapsed =
+            std::chrono::steady_clock::now() - start;
+        double const seconds = elapsed.count() > 0 ? elapsed.count() : 1e-9;
+
+        std::cout << (pass == 0 ? "forward: " : "reverse: ")
+                  << (double)forward_len * iterations / seconds / 1e6
+                  << " MB/s, " << iterations / seconds << " messages/s"
+                  << std::endl;
+    }
+
+    snmp_free_pdu(raw_pdu);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,188 @@
+/*_############################################################################
+ * _##
+ * _##  benchLocalize.cpp
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+
+/*
+ * Compare the number of localized keys per second generated for many
+ * engine ids and a few passwords by a loop calling
+ * Auth::password_to_key(), a loop calling
+ * AuthPriv::password_to_key_auth() and by
+ * AuthPriv::password_to_keys_auth(). The run fails if the keys of the
+ * three methods differ.
+ *
+ * usage: benchLocalize [engine count] [password count]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <libsnmp.h>
+#include <snmp_pp/auth_priv.h>
+#include <snmp_pp/snmp_pp.h>
+#include <string>
+#include <vector>
+
+#ifdef _SNMPv3
+
+using namespace Snmp_pp;
+
+static double seconds_since(const std::chrono::steady_clock::time_point start)
+{
+    std::chrono::duration<double> const elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() > 0 ? elapsed.count() : 1e-9;
+}
+
+int main(int argc, char** argv)
+{
+    int engine_count   = 5000;
+    int password_count = 4;
+
+    if (argc > 1)
+    {
+        engine_count = atoi(argv[1]);
+    }
+    if (argc > 2)
+    {
+        password_count = atoi(argv[2]);
+    }
+    if ((engine_count <= 0) || (password_count <= 0))
+    {
+        std::cerr << "usage: benchLocalize [engine count] [password count]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int      construct_state = SNMPv3_USM_ERROR;
+    AuthPriv auth_priv(construct_state);
+
+    if ((construct_state != SNMPv3_USM_OK)
+        || (auth_priv.add_default_modules() != SNMP_CLASS_SUCCESS))
+    {
+        std::cerr << "Could not initialize the security protocols"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<OctetStr> passwords(engine_count);
+    std::vector<OctetStr> engine_ids(engine_count);
+    std::vector<OctetStr> keys(engine_count);
+
+    for (int i = 0; i < engine_count; i++)
+    {
+        unsigned char engine_id[12] = { 0x80, 0x00, 0x13, 0x70, 0x05 };
+
+        for (int b = 0; b < 4; b++) { engine_id[8 + b] = (i >> (8 * b)); }
+        std::string const password =
+            "password" + std::to_string(i % password_count);
+
+        engine_ids[i].set_data(engine_id, sizeof(engine_id));
+        passwords[i] = password.c_str();
+    }
+
+    int const auth_prot = SNMP_AUTHPROTOCOL_HMACSHA;
+    Auth*     auth      = auth_priv.get_auth(auth_prot);
+
+    std::cout << engine_count << " engine ids, " << password_count
+              << " password(s)" << std::endl;
+
+    // The uncached loop is limited, it needs about 10 ms per key
+    int const             uncached = (engine_count < 200) ? engine_count : 200;
+    std::vector<OctetStr> uncached_keys(uncached);
+    auto                  start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < uncached; i++)
+    {
+        unsigned char key[SNMPv3_USM_MAX_KEY_LEN];
+        unsigned int  key_len = SNMPv3_USM_MAX_KEY_LEN;
+
+        auth->password_to_key(passwords[i].data(), passwords[i].len(),
+            engine_ids[i].data(), engine_ids[i].len(), key, &key_len);
+        uncached_keys[i].set_data(key, key_len);
+    }
+    std::cout << "Auth::password_to_key loop:           "
+              << uncached / seconds_since(start) << " keys/s" << std::endl;
+
+    auth_priv.clear_key_cache();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < engine_count; i++)
+    {
+        unsigned char key[SNMPv3_USM_MAX_KEY_LEN];
+        unsigned int  key_len = SNMPv3_USM_MAX_KEY_LEN;
+
+        auth_priv.password_to_key_auth(auth_prot, passwords[i].data(),
+            passwords[i].len(), engine_ids[i].data(), engine_ids[i].len(),
+            key, &key_len);
+        keys[i].set_data(key, key_len);
+    }
+    std::cout << "AuthPriv::password_to_key_auth loop:  "
+              << engine_count / seconds_since(start) << " keys/s"
+              << std::endl;
+
+    std::vector<OctetStr> batch_keys(engine_count);
+
+    auth_priv.clear_key_cache();
+    start = std::chrono::steady_clock::now();
+    if (auth_priv.password_to_keys_auth(auth_prot, engine_count,
+            passwords.data(), engine_ids.data(), batch_keys.data())
+        != SNMPv3_USM_OK)
+    {
+        std::cerr << "Batch localization failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "AuthPriv::password_to_keys_auth:      "
+              << engine_count / seconds_since(start) << " keys/s"
+              << std::endl;
+
+    for (int i = 0; i < engine_count; i++)
+    {
+        if (keys[i] != batch_keys[i])
+        {
+            std::cerr << "Different key for engine " << i << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    for (int i = 0; i < uncached; i++)
+    {
+        if (uncached_keys[i] != batch_keys[i])
+        {
+            std::cerr << "Different uncached key for engine " << i
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    std::cout << "All keys are equal" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+#else
+
+int main() { std::cout << "This example needs _SNMPv3 defined.\n"; }
+
+#endif
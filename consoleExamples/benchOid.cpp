@@ -0,0 +1,127 @@
+/*_############################################################################
+ * _##
+ * _##  benchOid.cpp
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+
+/*
+ * Measure copying, comparing and appending Oids. Oids with up to
+ * SNMP_PP_OID_INLINE_LEN subidentifiers do not allocate memory.
+ *
+ * usage: benchOid [oid length] [iterations]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <libsnmp.h>
+#include <snmp_pp/snmp_pp.h>
+
+using namespace Snmp_pp;
+
+static void report(const char* name, const int iterations,
+    const std::chrono::steady_clock::time_point& start)
+{
+    std::chrono::duration<double> const elapsed =
+        std::chrono::steady_clock::now() - start;
+    double const seconds = elapsed.count() > 0 ? elapsed.count() : 1e-9;
+
+    std::cout << name << iterations / seconds << " ops/s" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    int oid_len    = 12;
+    int iterations = 10000000;
+
+    if (argc > 1)
+    {
+        oid_len = atoi(argv[1]);
+    }
+    if (argc > 2)
+    {
+        iterations = atoi(argv[2]);
+    }
+    if (oid_len < 2)
+    {
+        std::cerr << "The oid length must be at least 2" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Oid base("1.3.6.1.2.1.2.2.1");
+    while ((int)base.len() < oid_len - 1) { base += (SmiUINT32)base.len(); }
+
+    std::cout << "Oid " << base.get_printable() << ".x, " << iterations
+              << " iterations, inline length " << SNMP_PP_OID_INLINE_LEN
+              << std::endl;
+
+    Oid      copy;
+    unsigned sum   = 0;
+    auto     start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < iterations; i++)
+    {
+        Oid tmp(base);
+        sum += tmp.len();
+    }
+    report("copy construct: ", iterations, start);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        copy = base;
+        sum += copy.len();
+    }
+    report("assign:         ", iterations, start);
+
+    Oid other(base);
+    other += (SmiUINT32)1;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        other[other.len() - 1] = (SmiUINT32)i;
+        sum += (base < other) ? 1 : 0;
+    }
+    report("compare:        ", iterations, start);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        Oid tmp(base);
+        tmp += (SmiUINT32)i;
+        sum += tmp.len();
+    }
+    report("copy + append:  ", iterations, start);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        Vb vb(base);
+        sum += vb.get_syntax();
+    }
+    report("Vb construct:   ", iterations, start);
+
+    return (sum > 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -369,6 +369,14 @@ public:
      */
     IpAddress(const IpAddress& ipaddr);
 
+    /**
+     * Construct an IP address from another IP address, taking its
+     * friendly name.
+     *
+     * @param ipaddr - address to move
+     */
+    IpAddress(IpAddress&& ipaddr) noexcept;
+
     /**
      * Construct an IP address from a GenAddress.
      *
@@ -601,6 +609,14 @@ public:
      */
     UdpAddress(const UdpAddress& udpaddr);
 
+    /**
+     * Construct an UDP address from another UDP address, taking its
+     * friendly name.
+     *
+     * @param udpaddr - address to move
+     */
+    UdpAddress(UdpAddress&& udpaddr) noexcept;
+
     /**
      * Construct an UDP address from a GenAddress.
      *
@@ -638,6 +654,11 @@ public:
      */
     virtual UdpAddress& operator=(const UdpAddress& udpaddr);
 
+    /**
+     * Move assignment operator for UdpAddress.
+     */
+    UdpAddress& operator=(UdpAddress&& udpaddr) noexcept;
+
     /**
      * Overloaded assignment operator for IpAddress.
      */
@@ -1169,6 +1190,14 @@ public:
      */
     GenAddress(const GenAddress& addr);
 
+    /**
+     * Construct a generic address taking the address object of another
+     * generic address, which is invalid afterwards.
+     *
+     * @param addr - Generic address object to move
+     */
+    GenAddress(GenAddress&& addr) noexcept;
+
     /**
      * Destructor, free memory.
      */
@@ -1217,6 +1246,12 @@ public:
      */
     virtual GenAddress& operator=(const GenAddress& addr);
 
+    /**
+     * Move assignment operator for a GenAddress, the source is invalid
+     * afterwards.
+     */
+    GenAddress& operator=(GenAddress&& addr) noexcept;
+
     /**
      * Overloaded assignment operator for a Address.
      */
@@ -0,0 +1,172 @@
+/*_############################################################################
+ * _##
+ * _##  addresstable.h
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+
+#ifndef _SNMP_ADDRESSTABLE_H_
+#define _SNMP_ADDRESSTABLE_H_
+
+#include "snmp_pp/address.h"
+#include "snmp_pp/config_snmp_pp.h"
+
+#include <libsnmp.h>
+
+#ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#endif
+
+/**
+ * FNV-1a hash of the data, continuing the hash of previous data.
+ */
+inline uint32_t fnv1a_hash(
+    const unsigned char* data, const long len, uint32_t hash = 2166136261U)
+{
+    for (long i = 0; i < len; ++i) { hash = (hash ^ data[i]) * 16777619U; }
+    return hash;
+}
+
+/**
+ * Table of data kept for each address, keyed by the binary address
+ * including the port.
+ *
+ * Open addressing with linear probing, the size is a power of two and
+ * at least one quarter of the slots is kept empty. Entries are not
+ * removed. The table is not synchronized, the owner has to lock it.
+ *
+ * @param T - Data of an address, value initialized when it is added
+ */
+template <class T> class CAddressTable {
+public:
+    struct Entry : public T {
+        unsigned char addr[ADDRBUF]; // binary address including the port
+        int           addrLen;       // 0 for an unused slot
+    };
+
+    CAddressTable() : m_entries(nullptr), m_size(0), m_count(0) { }
+
+    ~CAddressTable() { delete[] m_entries; }
+
+    /**
+     * Get the entry of the address.
+     *
+     * @return The entry or nullptr if the address was not added
+     */
+    Entry* Find(const Address& address) const
+    {
+        unsigned char addr[ADDRBUF];
+        int const     addrLen = address.get_length();
+
+        if (!m_count || (addrLen <= 0) || (addrLen > ADDRBUF))
+        {
+            return nullptr;
+        }
+        for (int i = 0; i < addrLen; ++i) { addr[i] = address[i]; }
+
+        Entry* entry = Slot(addr, addrLen);
+        return entry->addrLen ? entry : nullptr;
+    }
+
+    /**
+     * Get the entry of the address and add it if it is not found.
+     *
+     * @param address - Address of the target
+     * @param added   - Set to true if the entry was added
+     * @return The entry or nullptr if the address can not be stored
+     */
+    Entry* FindOrAdd(const Address& address, bool& added)
+    {
+        unsigned char addr[ADDRBUF];
+        int const     addrLen = address.get_length();
+
+        added = false;
+        if ((addrLen <= 0) || (addrLen > ADDRBUF))
+        {
+            return nullptr;
+        }
+        for (int i = 0; i < addrLen; ++i) { addr[i] = address[i]; }
+
+        if ((m_count + 1) * 4 > m_size * 3)
+        {
+            Entry* const   oldEntries = m_entries;
+            uint32_t const oldSize    = m_size;
+
+            m_size    = (m_size > 0) ? m_size * 2 : 16;
+            m_entries = new Entry[m_size]();
+
+            for (uint32_t i = 0; i < oldSize; ++i)
+            {
+                if (oldEntries[i].addrLen)
+                {
+                    *Slot(oldEntries[i].addr, oldEntries[i].addrLen) =
+                        oldEntries[i];
+                }
+            }
+            delete[] oldEntries;
+        }
+
+        Entry* entry = Slot(addr, addrLen);
+        if (!entry->addrLen)
+        {
+            memcpy(entry->addr, addr, addrLen);
+            entry->addrLen = addrLen;
+            added          = true;
+            ++m_count;
+        }
+        return entry;
+    }
+
+private:
+    CAddressTable(const CAddressTable&);
+    CAddressTable& operator=(const CAddressTable&);
+
+    // Find the slot of the binary address, or the empty slot to insert it
+    Entry* Slot(const unsigned char* addr, const int addrLen) const
+    {
+        uint32_t slot = fnv1a_hash(addr, addrLen) & (m_size - 1);
+
+        while (m_entries[slot].addrLen)
+        {
+            if ((m_entries[slot].addrLen == addrLen)
+                && !memcmp(m_entries[slot].addr, addr, addrLen))
+            {
+                break;
+            }
+            slot = (slot + 1) & (m_size - 1);
+        }
+        return m_entries + slot;
+    }
+
+    Entry*   m_entries;
+    uint32_t m_size;
+    uint32_t m_count;
+};
+
+#ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#endif
+
+#endif // _SNMP_ADDRESSTABLE_H_
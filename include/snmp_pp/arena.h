@@ -0,0 +1,120 @@
+/*_############################################################################
+ * _##
+ * _##  arena.h
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+#ifndef _SNMP_ARENA_H_
+#define _SNMP_ARENA_H_
+
+#include "snmp_pp/config_snmp_pp.h"
+
+#include <libsnmp.h>
+
+#ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#endif
+
+/**
+ * Monotonic allocator for the data of one received message.
+ *
+ * Memory is taken from blocks in sequence and is only freed all at
+ * once by reset(). If a message needed more than one block, reset()
+ * replaces them by one block large enough for all of it, so decoding
+ * messages of the same size does not allocate memory again. The
+ * arena is not synchronized.
+ */
+class DLLOPT SnmpArena {
+public:
+    /**
+     * Create an empty arena, the first block is allocated on first use.
+     *
+     * @param block_size - Minimum size in bytes of the blocks
+     */
+    SnmpArena(const size_t block_size = SNMP_PP_ARENA_BLOCK_SIZE);
+
+    ~SnmpArena();
+
+    /**
+     * Allocate memory that stays valid until the next reset().
+     *
+     * @param size - Number of bytes, aligned to 8 bytes
+     * @return Pointer to the memory or nullptr if out of memory
+     */
+    void* allocate(const size_t size)
+    {
+        size_t const aligned = (size + 7) & ~(size_t)7;
+
+        ++m_allocations;
+        if (m_blocks && (m_used + aligned <= m_blocks->size))
+        {
+            void* ptr = (unsigned char*)(m_blocks + 1) + m_used;
+            m_used += aligned;
+            return ptr;
+        }
+        return allocate_block(aligned);
+    }
+
+    /**
+     * Free all memory allocated since the last reset.
+     */
+    void reset();
+
+    /**
+     * Get the number of calls of allocate() since the arena was created.
+     */
+    unsigned long get_allocation_count() const { return m_allocations; }
+
+    /**
+     * Get the number of blocks allocated from the heap since the arena
+     * was created.
+     */
+    unsigned long get_block_count() const { return m_blockAllocations; }
+
+private:
+    struct Block {
+        Block* next; // previous block, freed by reset()
+        size_t size; // usable bytes after the header
+    };
+
+    // start a new block with room for size bytes and allocate them
+    void* allocate_block(const size_t size);
+
+    SnmpArena(const SnmpArena&);
+    SnmpArena& operator=(const SnmpArena&);
+
+    Block*        m_blocks;    // current block, linked to older ones
+    size_t        m_used;      // bytes used in the current block
+    size_t        m_total;     // bytes used in all blocks
+    size_t        m_blockSize; // minimum block size
+    unsigned long m_allocations;
+    unsigned long m_blockAllocations;
+};
+
+#ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#endif
+
+#endif // _SNMP_ARENA_H_
@@ -28,6 +28,7 @@
 #ifndef _SNMP_ASN1_H_
 #define _SNMP_ASN1_H_
 
+#include "snmp_pp/arena.h"
 #include "snmp_pp/config_snmp_pp.h"
 #include "snmp_pp/target.h"
 
@@ -145,6 +146,9 @@ struct snmp_pdu {
 
     // vb list
     struct variable_list* variables;
+
+    // if set, the pdu and its content are allocated from the arena
+    SnmpArena* arena;
 };
 
 // vb list
@@ -251,7 +255,35 @@ DLLOPT unsigned char* asn_parse_unsigned_int64(unsigned char* data,
 DLLOPT unsigned char* asn_build_unsigned_int64(unsigned char* data,
     int* datalength, unsigned char type, struct counter64* cp);
 
-DLLOPT struct snmp_pdu* snmp_pdu_create(int command);
+// prototypes for reverse coding routines, these write each object in
+// front of data and return the start of the object (see asn1.cpp)
+DLLOPT unsigned char* asn_rbuild_length(
+    unsigned char* data, int* datalength, int length);
+
+DLLOPT unsigned char* asn_rbuild_header(
+    unsigned char* data, int* datalength, unsigned char type, int length);
+
+DLLOPT unsigned char* asn_rbuild_int(unsigned char* data, int* datalength,
+    const unsigned char type, const SmiINT32 value);
+
+DLLOPT unsigned char* asn_rbuild_unsigned_int(unsigned char* data,
+    int* datalength, const unsigned char type, const SmiUINT32 value);
+
+DLLOPT unsigned char* asn_rbuild_unsigned_int64(unsigned char* data,
+    int* datalength, const unsigned char type, const struct counter64* cp);
+
+DLLOPT unsigned char* asn_rbuild_string(unsigned char* data, int* datalength,
+    const unsigned char type, const unsigned char* string,
+    const int strlength);
+
+DLLOPT unsigned char* asn_rbuild_objid(unsigned char* data, int* datalength,
+    const unsigned char type, const oid_t* objid, int objidlength);
+
+DLLOPT unsigned char* asn_rbuild_null(
+    unsigned char* data, int* datalength, const unsigned char type);
+
+DLLOPT struct snmp_pdu* snmp_pdu_create(
+    int command, SnmpArena* arena = nullptr);
 
 DLLOPT void snmp_free_pdu(struct snmp_pdu* pdu);
 
@@ -276,6 +308,25 @@ DLLOPT unsigned char* snmp_build_var_op(unsigned char* data, oid_t* var_name,
     int* var_name_len, unsigned char var_val_type, int var_val_len,
     unsigned char* var_val, int* listlength);
 
+DLLOPT unsigned char* snmp_rbuild_var_op(unsigned char* data,
+    int* datalength, const struct variable_list* vp);
+
+/**
+ * Encode the variable bindings of the pdu in front of data.
+ *
+ * @return - Pointer to the start of the encoded list or NULL
+ */
+DLLOPT unsigned char* rbuild_vb(
+    struct snmp_pdu* pdu, unsigned char* data, int* datalength);
+
+/**
+ * Encode the pdu including its variable bindings in front of data.
+ *
+ * @return - Pointer to the start of the encoded pdu or NULL
+ */
+DLLOPT unsigned char* rbuild_data_pdu(
+    struct snmp_pdu* pdu, unsigned char* data, int* datalength);
+
 DLLOPT unsigned char* snmp_parse_var_op(unsigned char* data, oid_t* var_name,
     int* var_name_len, unsigned char* var_val_type, int* var_val_len,
     unsigned char** var_val, int* listlength);
@@ -397,6 +448,27 @@ DLLOPT unsigned char* asn1_build_scoped_pdu(unsigned char* outBuf,
     unsigned char* contextName, long contextNameLength, unsigned char* data,
     long dataLength);
 
+/**
+ * Encode the scopedPDU in front of the already encoded data, which
+ * must be located directly in front of the encoded PDU.
+ *
+ * @param data              - The already encoded data (PDU)
+ * @param datalength        - IN: free bytes in front of data
+ *                            OUT: free bytes left in front of the result
+ * @param contextEngineID   - The contextEngineID
+ * @param contextEngineIDLength - The length of the contextEngineID
+ * @param contextName       - The contextName
+ * @param contextNameLength - The length of the contextName
+ * @param dataLength        - The length of the data
+ *
+ * @return - Pointer to the start of the scopedPDU or
+ *           NULL if an error occured
+ */
+DLLOPT unsigned char* asn1_rbuild_scoped_pdu(unsigned char* data,
+    int* datalength, const unsigned char* contextEngineID,
+    long contextEngineIDLength, const unsigned char* contextName,
+    long contextNameLength, long dataLength);
+
 #ifdef SNMP_PP_NAMESPACE
 } // end of namespace Snmp_pp
 #endif
@@ -34,8 +34,11 @@
 
 #ifdef _SNMPv3
 
+#    include "snmp_pp/reentrant.h"
 #    include "snmp_pp/usm_v3.h"
 
+#    include <atomic>
+
 #    ifdef SNMP_PP_NAMESPACE
 namespace Snmp_pp
 {
@@ -57,6 +60,116 @@ namespace Snmp_pp
 
 class OctetStr;
 
+/**
+ * Keyed HMAC states of a localized authentication key.
+ *
+ * The hash states after processing the inner and the outer padded key
+ * are computed once by Auth::create_hmac_context(). Each message is
+ * authenticated starting from copies of these states, which saves two
+ * compression rounds per message. The USM user table keeps a context
+ * for each localized user and shares it through a reference count with
+ * the messages in progress.
+ */
+class DLLOPT AuthHMACContext {
+public:
+    AuthHMACContext(const int prot) : ref_count(1), auth_prot(prot) { }
+
+    virtual ~AuthHMACContext() { }
+
+    /**
+     * Get the id of the authentication protocol of the key.
+     */
+    int get_auth_prot() const { return auth_prot; }
+
+    /**
+     * Compute the HMAC of the given data.
+     *
+     * @param msg     - pointer to the data
+     * @param msg_len - the length of the data
+     * @param digest  - buffer for the digest, which is not truncated
+     *
+     * @return SNMPv3_USM_OK on success
+     */
+    virtual int hmac(const unsigned char* msg, const int msg_len,
+        unsigned char* digest) const = 0;
+
+    /**
+     * Add a reference to the context.
+     *
+     * @return this
+     */
+    AuthHMACContext* ref()
+    {
+        ++ref_count;
+        return this;
+    }
+
+    /**
+     * Release a reference to the context and set the pointer to nullptr.
+     * The context is deleted with its last reference.
+     */
+    static void unref(AuthHMACContext*& ctx)
+    {
+        if (ctx && (--ctx->ref_count == 0))
+        {
+            delete ctx;
+        }
+        ctx = nullptr;
+    }
+
+private:
+    std::atomic<int> ref_count;
+    int const        auth_prot;
+};
+
+/**
+ * Expanded key schedule of a localized privacy key.
+ *
+ * The key schedule is computed once by Priv::create_key_context(), so
+ * encrypting or decrypting a message only sets the initialization
+ * vector. Like the AuthHMACContext, the USM user table keeps a context
+ * for each localized user and shares it through a reference count.
+ */
+class DLLOPT PrivKeyContext {
+public:
+    PrivKeyContext(const int prot) : ref_count(1), priv_prot(prot) { }
+
+    virtual ~PrivKeyContext() { }
+
+    /**
+     * Get the id of the privacy protocol of the key.
+     */
+    int get_priv_prot() const { return priv_prot; }
+
+    /**
+     * Add a reference to the context.
+     *
+     * @return this
+     */
+    PrivKeyContext* ref()
+    {
+        ++ref_count;
+        return this;
+    }
+
+    /**
+     * Release a reference to the context and set the pointer to nullptr.
+     * The context is deleted with its last reference.
+     */
+    static void unref(PrivKeyContext*& ctx)
+    {
+        if (ctx && (--ctx->ref_count == 0))
+        {
+            delete ctx;
+        }
+        ctx = nullptr;
+    }
+
+private:
+    std::atomic<int> ref_count;
+    int const        priv_prot;
+};
+
 /**
  * Abstract class for auth modules.
  *
@@ -87,6 +200,49 @@ public:
         const unsigned int engine_id_len, unsigned char* key,
         unsigned int* key_len) = 0;
 
+    /**
+     * Generate the key for the given password before it is localized
+     * (Ku of RFC 3414). This is the expensive part of password_to_key(),
+     * so AuthPriv caches the result for each password.
+     *
+     * @param password      - the password
+     * @param password_len  - the length of the password
+     * @param ku            - buffer for the key
+     * @param ku_len        - IN: length of the buffer
+     *                        OUT: length of the key
+     *
+     * @return SNMPv3_USM_OK on success, SNMPv3_USM_ERROR if the protocol
+     *         supports only password_to_key()
+     */
+    virtual int password_to_ku(const unsigned char* /* password */,
+        const unsigned int /* password_len */, unsigned char* /* ku */,
+        unsigned int* /* ku_len */)
+    {
+        return SNMPv3_USM_ERROR;
+    }
+
+    /**
+     * Localize a key generated by password_to_ku() with the engine id.
+     *
+     * @param ku            - the key from password_to_ku()
+     * @param ku_len        - the length of the key
+     * @param engine_id     - pointer to snmpEngineID
+     * @param engine_id_len - length of snmpEngineID
+     * @param key           - buffer for the localized key
+     * @param key_len       - IN: length of the buffer
+     *                        OUT: length of the key
+     *
+     * @return SNMPv3_USM_OK on success
+     */
+    virtual int localize_key(const unsigned char* /* ku */,
+        const unsigned int /* ku_len */,
+        const unsigned char* /* engine_id */,
+        const unsigned int /* engine_id_len */, unsigned char* /* key */,
+        unsigned int* /* key_len */)
+    {
+        return SNMPv3_USM_ERROR;
+    }
+
     /**
      * Generate a hash value for the given data.
      *
@@ -145,6 +301,22 @@ public:
         const int msg_len, unsigned char* auth_par_ptr,
         const int auth_par_len) = 0;
 
+    /**
+     * Create the keyed HMAC states for a localized key.
+     *
+     * @param key     - pointer to the key
+     * @param key_len - the length of the key
+     *
+     * @return A new context with one reference, or nullptr if the
+     *         protocol authenticates messages only with the key
+     */
+    virtual AuthHMACContext* create_hmac_context(
+        const unsigned char* /* key */,
+        const unsigned int /* key_len */) const
+    {
+        return nullptr;
+    }
+
     /**
      * Get the unique id of the authentication protocol.
      */
@@ -241,6 +413,65 @@ public:
         const unsigned int privacy_params_len, const uint32_t engine_boots,
         const uint32_t engine_time) = 0;
 
+    /**
+     * Expand the key schedule of a localized key.
+     *
+     * @param key     - pointer to the key
+     * @param key_len - the length of the key
+     *
+     * @return A new context with one reference, or nullptr if the
+     *         protocol encrypts messages only with the key
+     */
+    virtual PrivKeyContext* create_key_context(
+        const unsigned char* /* key */,
+        const unsigned int /* key_len */) const
+    {
+        return nullptr;
+    }
+
+    /**
+     * Encrypt the buffer using the key schedule of the context.
+     *
+     * The key is still needed by protocols that derive the
+     * initialization vector from it. If ctx is nullptr or was not
+     * created by this protocol, encrypt() is used.
+     *
+     * @see encrypt()
+     */
+    virtual int encrypt_with_context(const PrivKeyContext* /* ctx */,
+        const unsigned char* key, const unsigned int key_len,
+        const unsigned char* buffer, const unsigned int buffer_len,
+        unsigned char* out_buffer, unsigned int* out_buffer_len,
+        unsigned char* privacy_params, unsigned int* privacy_params_len,
+        const uint32_t engine_boots, const uint32_t engine_time)
+    {
+        return encrypt(key, key_len, buffer, buffer_len, out_buffer,
+            out_buffer_len, privacy_params, privacy_params_len, engine_boots,
+            engine_time);
+    }
+
+    /**
+     * Decrypt the buffer using the key schedule of the context.
+     *
+     * The key is still needed by protocols that derive the
+     * initialization vector from it. If ctx is nullptr or was not
+     * created by this protocol, decrypt() is used.
+     *
+     * @see decrypt()
+     */
+    virtual int decrypt_with_context(const PrivKeyContext* /* ctx */,
+        const unsigned char* key, const unsigned int key_len,
+        const unsigned char* buffer, const unsigned int buffer_len,
+        unsigned char* out_buffer, unsigned int* out_buffer_len,
+        const unsigned char* privacy_params,
+        const unsigned int privacy_params_len, const uint32_t engine_boots,
+        const uint32_t engine_time)
+    {
+        return decrypt(key, key_len, buffer, buffer_len, out_buffer,
+            out_buffer_len, privacy_params, privacy_params_len, engine_boots,
+            engine_time);
+    }
+
     /**
      * Extend a localized key that is too short.
      *
@@ -380,7 +611,8 @@ public:
 
     /**
      * Call the password-to-key method of the specified authentication
-     * protocol.
+     * protocol. The key before localization is taken from the cache of
+     * the last SNMP_PP_KU_CACHE_SIZE passwords if possible.
      */
     int password_to_key_auth(const int auth_prot,
         const unsigned char* password, const unsigned int password_len,
@@ -396,6 +628,37 @@ public:
         const unsigned char* engine_id, const unsigned int engine_id_len,
         unsigned char* key, unsigned int* key_len);
 
+    /**
+     * Generate the localized authentication keys for many pairs of
+     * password and engine id at once.
+     *
+     * Each distinct password is expanded only once, the expansions of
+     * different passwords and the localizations are spread over one
+     * thread per CPU if threads are enabled.
+     *
+     * @param auth_prot  - The authentication protocol
+     * @param count      - Number of pairs
+     * @param passwords  - Array of count passwords
+     * @param engine_ids - Array of count engine ids
+     * @param keys       - Array of count keys that receive the results
+     *
+     * @return SNMPv3_USM_OK if all keys were generated, otherwise the
+     *         error of the first failed pair, whose key is cleared
+     */
+    int password_to_keys_auth(const int auth_prot, const int count,
+        const OctetStr* passwords, const OctetStr* engine_ids,
+        OctetStr* keys);
+
+    /**
+     * Generate the localized privacy keys for many pairs of password
+     * and engine id at once.
+     *
+     * @see password_to_keys_auth()
+     */
+    int password_to_keys_priv(const int auth_prot, const int priv_prot,
+        const int count, const OctetStr* passwords,
+        const OctetStr* engine_ids, OctetStr* keys);
+
     /**
      * Get the keyChange value for the specified keys using the given
      * authentication protocol.
@@ -403,6 +666,12 @@ public:
     int get_keychange_value(const int auth_prot, const OctetStr& old_key,
         const OctetStr& new_key, OctetStr& keychange_value);
 
+    /**
+     * Remove all passwords and keys from the cache used by
+     * password_to_key_auth().
+     */
+    void clear_key_cache();
+
     /**
      * Get a pointer to a privacy protocol object.
      */
@@ -451,6 +720,38 @@ public:
         const unsigned int privacy_params_len, const uint32_t engine_boots,
         const uint32_t engine_time);
 
+    /**
+     * Expand the key schedule of a localized privacy key.
+     *
+     * @return A new context with one reference, or nullptr if the
+     *         protocol is unknown or does not support it
+     */
+    PrivKeyContext* create_key_context(const int priv_prot,
+        const unsigned char* key, const unsigned int key_len);
+
+    /**
+     * Encrypt a message using the expanded key schedule of the context,
+     * or only the key if ctx is nullptr.
+     */
+    int encrypt_msg(const PrivKeyContext* ctx, const int priv_prot,
+        const unsigned char* key, const unsigned int key_len,
+        const unsigned char* buffer, const unsigned int buffer_len,
+        unsigned char* out_buffer, unsigned int* out_buffer_len,
+        unsigned char* privacy_params, unsigned int* privacy_params_len,
+        const uint32_t engine_boots, const uint32_t engine_time);
+
+    /**
+     * Decrypt a message using the expanded key schedule of the context,
+     * or only the key if ctx is nullptr.
+     */
+    int decrypt_msg(const PrivKeyContext* ctx, const int priv_prot,
+        const unsigned char* key, const unsigned int key_len,
+        const unsigned char* buffer, const unsigned int buffer_len,
+        unsigned char* out_buffer, unsigned int* out_buffer_len,
+        const unsigned char* privacy_params,
+        const unsigned int privacy_params_len, const uint32_t engine_boots,
+        const uint32_t engine_time);
+
     /**
      * Get the length of the authentication parameters field of the given
      * authentication protocol.
@@ -476,12 +777,60 @@ public:
         unsigned char* msg, const int msg_len, unsigned char* auth_par_ptr,
         const int auth_par_len);
 
+    /**
+     * Create the keyed HMAC states for a localized authentication key.
+     *
+     * @return A new context with one reference, or nullptr if the
+     *         protocol is unknown or does not support it
+     */
+    AuthHMACContext* create_hmac_context(const int auth_prot,
+        const unsigned char* key, const unsigned int key_len);
+
+    /**
+     * Fill in the authentication field of an outgoing message using the
+     * keyed HMAC states of the key.
+     */
+    int auth_out_msg(const AuthHMACContext* ctx, unsigned char* msg,
+        const int msg_len, unsigned char* auth_par_ptr);
+
+    /**
+     * Check the authentication field of an incoming message using the
+     * keyed HMAC states of the key.
+     */
+    int auth_inc_msg(const AuthHMACContext* ctx, unsigned char* msg,
+        const int msg_len, unsigned char* auth_par_ptr,
+        const int auth_par_len);
+
 private:
+    // Get the key of the password before localization from the cache,
+    // or generate and cache it.
+    int get_ku(Auth* a, const unsigned char* password,
+        const unsigned int password_len, unsigned char* ku,
+        unsigned int* ku_len);
+
+    // Common part of password_to_keys_auth() and password_to_keys_priv(),
+    // p is nullptr for authentication keys.
+    int password_to_keys(Auth* a, Priv* p, const int count,
+        const OctetStr* passwords, const OctetStr* engine_ids,
+        OctetStr* keys);
+
+    struct KuCacheEntry {
+        int            auth_prot; ///< 0 for an unused entry
+        unsigned char* password;
+        unsigned int   password_len;
+        unsigned char  ku[SNMPv3_USM_MAX_KEY_LEN];
+        unsigned int   ku_len;
+    };
+
     AuthPtr*  auth;      ///< Array of pointers to Auth-objects
     PrivPtr*  priv;      ///< Array of pointers to Priv-objects
     int       auth_size; ///< current size of the auth array
     int       priv_size; ///< current size of the priv array
     pp_uint64 salt;      ///< current salt value (64 bits)
+
+    KuCacheEntry     ku_cache[SNMP_PP_KU_CACHE_SIZE];
+    int              ku_cache_next; ///< entry replaced next
+    SnmpSynchronized ku_cache_lock;
 };
 
 /**
@@ -496,6 +845,14 @@ public:
         const unsigned int engine_id_len, unsigned char* key,
         unsigned int* key_len) override;
 
+    int password_to_ku(const unsigned char* password,
+        const unsigned int password_len, unsigned char* ku,
+        unsigned int* ku_len) override;
+
+    int localize_key(const unsigned char* ku, const unsigned int ku_len,
+        const unsigned char* engine_id, const unsigned int engine_id_len,
+        unsigned char* key, unsigned int* key_len) override;
+
     int hash(const unsigned char* data, const unsigned int data_len,
         unsigned char* digest) const override;
 
@@ -506,6 +863,9 @@ public:
         const int msg_len, unsigned char* auth_par_ptr,
         const int auth_par_len) override;
 
+    AuthHMACContext* create_hmac_context(const unsigned char* key,
+        const unsigned int key_len) const override;
+
     int get_id() const override { return SNMP_AUTHPROTOCOL_HMACMD5; }
 
     const char* get_id_string() const override { return "HMAC-MD5"; }
@@ -543,6 +903,24 @@ public:
         const unsigned int privacy_params_len, const uint32_t engine_boots,
         const uint32_t engine_time) override;
 
+    PrivKeyContext* create_key_context(const unsigned char* key,
+        const unsigned int key_len) const override;
+
+    int encrypt_with_context(const PrivKeyContext* ctx,
+        const unsigned char* key, const unsigned int key_len,
+        const unsigned char* buffer, const unsigned int buffer_len,
+        unsigned char* out_buffer, unsigned int* out_buffer_len,
+        unsigned char* privacy_params, unsigned int* privacy_params_len,
+        const uint32_t engine_boots, const uint32_t engine_time) override;
+
+    int decrypt_with_context(const PrivKeyContext* ctx,
+        const unsigned char* key, const unsigned int key_len,
+        const unsigned char* buffer, const unsigned int buffer_len,
+        unsigned char* out_buffer, unsigned int* out_buffer_len,
+        const unsigned char* privacy_params,
+        const unsigned int privacy_params_len, const uint32_t engine_boots,
+        const uint32_t engine_time) override;
+
     int extend_short_key(const unsigned char* password,
         const unsigned int password_len, const unsigned char* engine_id,
         const unsigned int engine_id_len, unsigned char* key,
@@ -644,6 +1022,24 @@ public:
         const unsigned int privacy_params_len, const uint32_t engine_boots,
         const uint32_t engine_time) override;
 
+    PrivKeyContext* create_key_context(const unsigned char* key,
+        const unsigned int key_len) const override;
+
+    int encrypt_with_context(const PrivKeyContext* ctx,
+        const unsigned char* key, const unsigned int key_len,
+        const unsigned char* buffer, const unsigned int buffer_len,
+        unsigned char* out_buffer, unsigned int* out_buffer_len,
+        unsigned char* privacy_params, unsigned int* privacy_params_len,
+        const uint32_t engine_boots, const uint32_t engine_time) override;
+
+    int decrypt_with_context(const PrivKeyContext* ctx,
+        const unsigned char* key, const unsigned int key_len,
+        const unsigned char* buffer, const unsigned int buffer_len,
+        unsigned char* out_buffer, unsigned int* out_buffer_len,
+        const unsigned char* privacy_params,
+        const unsigned int privacy_params_len, const uint32_t engine_boots,
+        const uint32_t engine_time) override;
+
     int extend_short_key(const unsigned char* password,
         const unsigned int password_len, const unsigned char* engine_id,
         const unsigned int engine_id_len, unsigned char* key,
@@ -778,6 +1174,14 @@ public:
         const unsigned int engine_id_len, unsigned char* key,
         unsigned int* key_len) override;
 
+    int password_to_ku(const unsigned char* password,
+        const unsigned int password_len, unsigned char* ku,
+        unsigned int* ku_len) override;
+
+    int localize_key(const unsigned char* ku, const unsigned int ku_len,
+        const unsigned char* engine_id, const unsigned int engine_id_len,
+        unsigned char* key, unsigned int* key_len) override;
+
     int hash(const unsigned char* data, const unsigned int data_len,
         unsigned char* digest) const override;
 
@@ -788,6 +1192,9 @@ public:
         const int msg_len, unsigned char* auth_par_ptr,
         const int auth_par_len) override;
 
+    AuthHMACContext* create_hmac_context(const unsigned char* key,
+        const unsigned int key_len) const override;
+
 protected:
     class Hasher {
     public:
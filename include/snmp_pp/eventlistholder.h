@@ -53,7 +53,7 @@ class Snmp;
 class DLLOPT EventListHolder {
 public:
     EventListHolder(Snmp* snmp_session);
-    ~EventListHolder() { }
+    ~EventListHolder();
 
     CSNMPMessageQueue*& snmpEventList() { return m_snmpMessageQueue; }
 
@@ -75,6 +75,52 @@ public:
     void SNMPGetFdSets(
         int& maxfds, fd_set& readfds, fd_set& writefds, fd_set& exceptfds);
 
+#ifdef HAVE_EPOLL_SYSCALL
+    /**
+     * Register a socket with the epoll backend. The socket stays
+     * registered until UnregisterFd() is called and only events found
+     * on it are passed to the HandleEvents() method of the owner.
+     * Registering an already registered socket replaces its events
+     * and owner.
+     *
+     * @param fd     - The socket or file descriptor to watch
+     * @param events - Poll events to wait for (POLLIN, POLLOUT, POLLPRI)
+     * @param owner  - The event queue that handles the socket
+     *
+     * @return true on success, false if epoll is not available
+     */
+    bool RegisterFd(const SnmpSocket fd, const short events, CEvents* owner);
+
+    /**
+     * Remove a socket from the epoll backend. Must be called before
+     * the socket is closed.
+     *
+     * @param fd - The socket or file descriptor to remove
+     */
+    void UnregisterFd(const SnmpSocket fd);
+
+    /**
+     * Get the epoll file descriptor, which becomes readable if any of
+     * the registered sockets has pending events. May be used to embed
+     * the session into an external event loop.
+     *
+     * @return The epoll file descriptor or -1 if epoll is not available
+     */
+    int GetEpollFd() const { return m_epollFd; }
+#endif
+
+    /**
+     * Block the processing of events, which receives from the sockets
+     * of the sessions, until UnlockEvents() is called. Must not be
+     * called from a callback, as the events are processed meanwhile.
+     */
+    void LockEvents() { pevents_mutex.lock(); }
+
+    /**
+     * Allow the processing of events again, see LockEvents().
+     */
+    void UnlockEvents() { pevents_mutex.unlock(); }
+
     //---------[ Main Loop ]------------------------------------------
 
     /**
@@ -135,13 +181,24 @@ public:
 #endif
 
 private:
+#ifdef HAVE_EPOLL_SYSCALL
+    int SNMPEpollProcessEvents(const int max_block_milliseconds);
+    int SNMPEpollProcessPendingEvents();
+
+    int              m_epollFd;         // epoll instance or -1 (use poll)
+    CEvents**        m_epollOwners;     // owner of each registered fd
+    int              m_epollOwnersSize; // number of slots in m_epollOwners
+    int              m_epollFdCount;    // number of registered fds
+    SnmpSynchronized m_epollLock;       // protects the members above
+#endif
+
     CSNMPMessageQueue* m_snmpMessageQueue; // contains all outstanding messages
     CNotifyEventQueue*
         m_notifyEventQueue; // contains all sessions waiting for notifications
 #ifdef _USER_DEFINED_EVENTS
     CUDEventQueue* m_udEventQueue; // contains all user-defined events
 #endif
-#ifdef _USER_DEFINED_TMEOUTS
+#ifdef _USER_DEFINED_TIMEOUTS
     CUTEventQueue* m_utEventQueue; // contains all user-defined timeouts
 #endif
     CEventList m_eventList;        // contains all expected events
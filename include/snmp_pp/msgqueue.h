@@ -71,11 +71,16 @@
 
 //----[ snmp++ includes ]----------------------------------------------
 #include "snmp_pp/address.h"
+#include "snmp_pp/arena.h"
 #include "snmp_pp/config_snmp_pp.h"
 #include "snmp_pp/eventlist.h"
 #include "snmp_pp/msec.h"
 #include "snmp_pp/pdu.h"
+#include "snmp_pp/pduview.h"
+#include "snmp_pp/rttestimator.h"
+#include "snmp_pp/sendlimiter.h"
 #include "snmp_pp/target.h"
+#include "snmp_pp/timeoutheap.h"
 #include "snmp_pp/uxsnmp.h"
 
 #ifdef SNMP_PP_NAMESPACE
@@ -85,25 +90,70 @@ namespace Snmp_pp
 
 //----[ CSNMPMessage class ]-------------------------------------------
 
+#ifdef POSIX_THREADS
+/*-----------------------------------------------------------*/
+/* CSNMPMessageWaiter                                        */
+/*   a thread blocked in CSNMPMessageQueue::WaitForResponse() */
+/*-----------------------------------------------------------*/
+struct CSNMPMessageWaiter {
+    pthread_cond_t cond;
+    bool           done; // response received or message deleted
+};
+#endif
+
 /*-----------------------------------------------------------*/
 /* CSNMPMessage					       */
 /*   a description of a single MIB access operation.	       */
 /*-----------------------------------------------------------*/
 class DLLOPT CSNMPMessage {
+    friend class CSendLimiter;
+
 public:
+    // state of the message regarding the limits of the CSendLimiter
+    enum LimiterState {
+        limiter_none,     // not limited (sync request or no limits set)
+        limiter_queued,   // queued by the limiter, not sent yet
+        limiter_in_flight // sent, holds a slot of the limiter
+    };
+
     CSNMPMessage(uint32_t id, Snmp* snmp, SnmpSocket socket,
-        const SnmpTarget& target, Pdu& pdu, unsigned char* rawPdu,
+        const SnmpTarget& target, const Pdu& pdu, unsigned char* rawPdu,
         size_t rawPduLen, const Address& address, snmp_callback callBack,
-        void* callData);
+        void* callData, snmp_view_callback viewCallBack = nullptr);
     virtual ~CSNMPMessage();
     uint32_t GetId() const { return m_uniqueId; }
 
+    // Do not use while the message is stored in a CSNMPMessageQueue,
+    // as the queue indexes its messages by id.
     void ResetId(const uint32_t newId) { m_uniqueId = newId; }
 
     void SetSendTime();
 
+    // Set the time a queued message is tried to be sent
+    void SetSendTime(const msec& sendTime) { m_sendTime = sendTime; }
+
     void GetSendTime(msec& sendTime) const { sendTime = m_sendTime; }
 
+    // Timeout in milliseconds until the next retransmission,
+    // initialized from the timeout of the target
+    void SetRetransmitTimeout(const uint32_t rto)
+    {
+        m_rto = rto;
+        SetSendTime();
+    }
+
+    uint32_t GetRetransmitTimeout() const { return m_rto; }
+
+    // Get the time since the first transmission, fails if the message
+    // was retransmitted, as the response cannot be matched to a send
+    bool GetRoundTripTime(uint32_t& rtt) const;
+
+    const Address& GetAddress() const { return *m_address; }
+
+    LimiterState GetLimiterState() const { return m_limiterState; }
+
+    void SetLimiterState(const LimiterState state) { m_limiterState = state; }
+
     SnmpSocket GetSocket() const { return m_socket; }
 
     int SetPdu(
@@ -118,8 +168,17 @@ public:
 
     int GetReceived() const { return m_received; }
 
+    // Mark a response delivered as a view as received, fails if the
+    // type does not match or a response was received already.
+    bool SetViewReceived(const unsigned short type);
+
+    // the request was sent with a snmp_view_callback
+    bool IsViewRequest() const { return m_viewRequest; }
+
+    int SendMessage();
     int ResendMessage();
     int Callback(const int reason);
+    int Callback(const int reason, const PduView& view);
 
     SnmpTarget* GetTarget() { return m_target; }
 
@@ -127,21 +186,39 @@ public:
 
     void SetLocked(const bool l) { m_locked = l; }
 
+#ifdef POSIX_THREADS
+    // The waiter is woken up when the response is set or the message
+    // is deleted. The message queue must be locked for both calls.
+    void SetWaiter(CSNMPMessageWaiter* waiter) { m_waiter = waiter; }
+    void WakeWaiter();
+#endif
+
 protected:
-    uint32_t       m_uniqueId;
-    msec           m_sendTime;
-    Snmp*          m_snmp;
-    SnmpSocket     m_socket;
-    SnmpTarget*    m_target;
-    Pdu            m_pdu;
-    unsigned char* m_rawPdu;
-    size_t         m_rawPduLen;
-    Address*       m_address;
-    snmp_callback  m_callBack;
-    void*          m_callData;
-    int            m_reason;
-    int            m_received;
-    bool           m_locked;
+    uint32_t           m_uniqueId;
+    msec               m_sendTime;
+    msec               m_firstSendTime;
+    uint32_t           m_rto;
+    bool               m_retransmitted;
+    Snmp*              m_snmp;
+    SnmpSocket         m_socket;
+    SnmpTarget*        m_target;
+    Pdu                m_pdu;
+    unsigned char*     m_rawPdu;
+    size_t             m_rawPduLen;
+    Address*           m_address;
+    snmp_callback      m_callBack;
+    snmp_view_callback m_viewCallBack;
+    bool               m_viewRequest;
+    void*              m_callData;
+    int                m_reason;
+    int                m_received;
+    bool               m_locked;
+    LimiterState       m_limiterState;
+    CSNMPMessage*      m_limiterNext; // queued messages to the same address
+    CSNMPMessage*      m_limiterPrev;
+#ifdef POSIX_THREADS
+    CSNMPMessageWaiter* m_waiter;
+#endif
 };
 
 /*-----------------------------------------------------------*/
@@ -152,10 +229,13 @@ class DLLOPT CSNMPMessageQueue : public CEvents {
 public:
     CSNMPMessageQueue(EventListHolder* holder, Snmp* session);
     virtual ~CSNMPMessageQueue();
+    // If queued is set to true, the message must not be sent by the
+    // caller, as it exceeds the limits set with SetLimits().
     CSNMPMessage* AddEntry(uint32_t id, Snmp* snmp, SnmpSocket socket,
-        const SnmpTarget& target, Pdu& pdu, unsigned char* rawPdu,
+        const SnmpTarget& target, const Pdu& pdu, unsigned char* rawPdu,
         size_t rawPduLen, const Address& address, snmp_callback callBack,
-        void* callData);
+        void* callData, bool* queued = nullptr,
+        snmp_view_callback viewCallBack = nullptr);
     CSNMPMessage* GetEntry(const uint32_t uniqueId);
     int           DeleteEntry(const uint32_t uniqueId);
     void          DeleteSocketEntry(const SnmpSocket socket);
@@ -186,13 +266,46 @@ public:
     int Done() override;
     int Done(uint32_t);
 
+    /**
+     * Wait until the response for the given request is received or the
+     * message is removed from the queue, without handling any events.
+     * This is only possible if the poll thread of the session is
+     * running, as it has to receive the response.
+     *
+     * @param id                     - Request id of the message
+     * @param max_block_milliseconds - Maximum time to wait
+     *
+     * @return false if the caller has to handle the events itself
+     */
+    bool WaitForResponse(const uint32_t id, const int max_block_milliseconds);
+
+    /**
+     * Limit the async requests to each address, see
+     * Snmp::set_destination_limits().
+     */
+    void SetLimits(
+        const int maxInFlight, const uint32_t maxRate, const uint32_t burst);
+
+    /**
+     * Get the number of currently queued async requests and the total
+     * number of requests that were queued because of the limits.
+     */
+    void GetLimiterCounters(uint32_t& queued, uint32_t& throttled);
+
+    /**
+     * Receive and process the responses pending on the given poll fd
+     * until none are left. The caller has to block the processing of
+     * events, see EventListHolder::LockEvents().
+     */
+    void DrainResponses(const SnmpSocket fd);
+
 protected:
     /*---------------------------------------------------------*/
     /* CSNMPMessageQueueElt				       */
     /*   a container for a single item on a linked lists of    */
     /*  CSNMPMessages.					       */
     /*---------------------------------------------------------*/
-    class DLLOPT CSNMPMessageQueueElt {
+    class DLLOPT CSNMPMessageQueueElt : public CTimeoutHeapEntry {
     public:
         CSNMPMessageQueueElt(CSNMPMessage* message, CSNMPMessageQueueElt* next,
             CSNMPMessageQueueElt* previous);
@@ -213,10 +326,64 @@ protected:
         class CSNMPMessageQueueElt* m_previous;
     };
 
+    /*---------------------------------------------------------*/
+    /* Index of the queue elements by request id. Open         */
+    /* addressing with linear probing, the size is always a    */
+    /* power of two. Deleted slots point to m_head.            */
+    /*---------------------------------------------------------*/
+    CSNMPMessageQueueElt* IndexFind(const uint32_t uniqueId);
+    void                  IndexAdd(CSNMPMessageQueueElt* elt);
+    void                  IndexRemove(CSNMPMessageQueueElt* elt);
+    void                  IndexResize(const uint32_t minEntries);
+
+    // receive the responses pending on the poll fd and process them,
+    // the fd is a socket or an io_uring, see Snmp::get_poll_fd().
+    // Returns the number of received datagrams.
+    int  ReceiveResponses(const SnmpSocket fd);
+    void HandleResponse(const int recv_status, Pdu& pdu,
+        const UdpAddress& fromaddress, const OctetStr& engine_id);
+
+    // deliver a response to a request with a view callback, returns
+    // false if the request has none and the Pdu has to be decoded
+    bool HandleViewResponse(const PduView& view);
+
+    // update the round trip time of the target with the response
+    void AddRttSample(CSNMPMessage* msg);
+
+    // send the queued messages to the address as far as the limits
+    // allow and schedule the next try
+    void SendQueued(const Address& address, const msec& now);
+
+    // the element of the message that will timeout next
+    CSNMPMessageQueueElt* GetNextTimeoutElt()
+    {
+        return static_cast<CSNMPMessageQueueElt*>(m_timeouts.Top());
+    }
+
     CSNMPMessageQueueElt m_head;
     int                  m_msgCount;
+    int                  m_viewCount; // messages with a view callback
     EventListHolder*     my_holder;
     Snmp*                m_snmpSession;
+
+    CSNMPMessageQueueElt** m_idIndex;
+    uint32_t               m_idIndexSize; // number of slots
+    uint32_t               m_idIndexUsed; // live and deleted slots
+
+    CTimeoutHeap m_timeouts; // all elements ordered by send time
+
+    CRttEstimator m_rtt;     // for targets using the adaptive timeout
+    CSendLimiter  m_limiter; // limits of async requests per address
+
+    // Receive buffers for ReceiveResponses(), allocated on first use and
+    // when the maximum message size of the session changes.
+    // HandleEvents() is serialized by the EventListHolder.
+    unsigned char* m_recvBuffers;
+    int            m_recvBufferSize; // of each buffer
+    long           m_recvLengths[SNMP_PP_RECV_BATCH_SIZE];
+    SocketAddrType m_recvFrom[SNMP_PP_RECV_BATCH_SIZE];
+    SnmpArena      m_recvArena; // raw pdu of the message being decoded
+    Pdu            m_recvPdu;   // keeps its vbs array between messages
 };
 
 #ifdef SNMP_PP_NAMESPACE
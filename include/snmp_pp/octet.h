@@ -105,6 +105,14 @@ public:
      */
     OctetStr(const OctetStr& octet);
 
+    /**
+     * Construct a OctetStr from another OctetStr, taking its data.
+     * The source object is empty afterwards.
+     *
+     * @param octet - Value for the new object
+     */
+    OctetStr(OctetStr&& octet) noexcept;
+
     /**
      * Destructor, frees allocated space.
      */
@@ -122,6 +130,11 @@ public:
      */
     OctetStr& operator=(const OctetStr& octet);
 
+    /**
+     * Move a OctetStr to a OctetStr, the source is empty afterwards.
+     */
+    OctetStr& operator=(OctetStr&& octet) noexcept;
+
     /**
      * Equal operator for two OctetStr.
      */
@@ -88,6 +88,11 @@ namespace Snmp_pp
  *       Oid object is modified. The functions get_printable(len) and
  *       get_printable(start, len) share the same buffer which is
  *       freed and newly allocated for each call.
+ *
+ * @note Values with up to SNMP_PP_OID_INLINE_LEN subidentifiers are
+ *       stored inside the object, so copying, comparing and appending
+ *       short Oids does not allocate memory. The pointer returned by
+ *       oidval() must therefore not be deleted or replaced.
  */
 class DLLOPT Oid : public SnmpSyntax {
 public:
@@ -131,20 +136,31 @@ public:
         smival.value.oid.len = 0;
         smival.value.oid.ptr = nullptr;
 
-        // allocate some memory for the oid
+        // get some memory for the oid
         // in this case the size to allocate is the same size as the source oid
         if (oid.smival.value.oid.len)
         {
-            smival.value.oid.ptr = new SmiUINT32[oid.smival.value.oid.len];
-            if (smival.value.oid.ptr)
-            {
-                // NOLINTNEXTLINE(clang-analyzer-optin.cplusplus.VirtualCall)
-                OidCopy(
-                    (SmiLPOID) & (oid.smival.value.oid), &smival.value.oid);
-            }
+            alloc_oid_ptr(oid.smival.value.oid.len);
+            // NOLINTNEXTLINE(clang-analyzer-optin.cplusplus.VirtualCall)
+            OidCopy((SmiLPOID) & (oid.smival.value.oid), &smival.value.oid);
         }
     }
 
+    /**
+     * Move constructor, takes the value of the source Oid, which is
+     * empty afterwards.
+     *
+     * @param oid - Source Oid
+     */
+    Oid(Oid&& oid) noexcept
+        : iv_str(nullptr), iv_part_str(nullptr), m_changed(true)
+    {
+        smival.syntax        = sNMP_SYNTAX_OID;
+        smival.value.oid.len = 0;
+        smival.value.oid.ptr = nullptr;
+        take_oid_ptr(oid);
+    }
+
     /**
      * Constructor from array.
      *
@@ -160,15 +176,10 @@ public:
 
         if (raw_oid && (oid_len > 0))
         {
-            smival.value.oid.ptr = new SmiUINT32[oid_len];
-            if (smival.value.oid.ptr)
-            {
-                smival.value.oid.len = oid_len;
-                for (int i = 0; i < oid_len; i++)
-                {
-                    smival.value.oid.ptr[i] = raw_oid[i];
-                }
-            }
+            alloc_oid_ptr(oid_len);
+            smival.value.oid.len = oid_len;
+            memcpy((SmiLPBYTE)smival.value.oid.ptr, (SmiLPBYTE)raw_oid,
+                (size_t)oid_len * sizeof(SmiUINT32));
         }
     }
 
@@ -211,20 +222,34 @@ public:
         {
             return *this; // protect against assignment from self
         }
-        delete_oid_ptr();
 
         // check for zero len on source
         if (oid.smival.value.oid.len == 0)
         {
+            delete_oid_ptr();
             return *this;
         }
 
-        // allocate some memory for the oid
-        smival.value.oid.ptr =
-            (SmiLPUINT32) new SmiUINT32[oid.smival.value.oid.len];
-        if (smival.value.oid.ptr)
+        // keep the memory if the value fits into it
+        if (oid_capacity() < oid.smival.value.oid.len)
         {
-            OidCopy((SmiLPOID) & (oid.smival.value.oid), &smival.value.oid);
+            delete_oid_ptr();
+            alloc_oid_ptr(oid.smival.value.oid.len);
+        }
+        OidCopy((SmiLPOID) & (oid.smival.value.oid), &smival.value.oid);
+        m_changed = true;
+        return *this;
+    }
+
+    /**
+     * Move one Oid to another, the source Oid is empty afterwards.
+     */
+    Oid& operator=(Oid&& oid) noexcept
+    {
+        if (this != &oid)
+        {
+            delete_oid_ptr();
+            take_oid_ptr(oid);
         }
         return *this;
     }
@@ -339,36 +364,44 @@ public:
      */
     Oid& operator+=(const Oid& o)
     {
-        SmiLPUINT32 new_oid = nullptr;
+        SmiLPUINT32 const old_oid = smival.value.oid.ptr;
+        SmiLPUINT32       new_oid = nullptr;
 
         if (o.smival.value.oid.len == 0)
         {
             return *this;
         }
 
-        new_oid = (SmiLPUINT32) new SmiUINT32[smival.value.oid.len
-            + o.smival.value.oid.len];
-        if (new_oid == nullptr)
+        uint32_t const new_len =
+            smival.value.oid.len + o.smival.value.oid.len;
+        if (!old_oid)
         {
-            delete_oid_ptr();
-            return *this;
+            new_oid = alloc_oid_ptr(new_len);
         }
-
-        if (smival.value.oid.ptr)
+        else if (oid_capacity() >= new_len)
         {
-            memcpy((SmiLPBYTE)new_oid, (SmiLPBYTE)smival.value.oid.ptr,
-                (smival.value.oid.len * sizeof(SmiUINT32)));
-
-            delete[] smival.value.oid.ptr;
+            new_oid = old_oid; // append in place
         }
+        else
+        {
+            new_oid = (SmiLPUINT32) new SmiUINT32[new_len];
 
-        // out with the old, in with the new...
-        smival.value.oid.ptr = new_oid;
+            memcpy((SmiLPBYTE)new_oid, (SmiLPBYTE)old_oid,
+                (smival.value.oid.len * sizeof(SmiUINT32)));
+        }
 
+        // o may be this object, so free the old value afterwards
         memcpy((SmiLPBYTE)&new_oid[smival.value.oid.len],
             (SmiLPBYTE)o.smival.value.oid.ptr,
             (o.smival.value.oid.len * sizeof(SmiUINT32)));
 
+        // out with the old, in with the new...
+        if (old_oid && (old_oid != new_oid) && (old_oid != m_inline))
+        {
+            delete[] old_oid;
+        }
+        smival.value.oid.ptr = new_oid;
+
         smival.value.oid.len += o.smival.value.oid.len;
 
         m_changed = true;
@@ -709,11 +742,62 @@ protected:
      */
     inline void delete_oid_ptr();
 
+    /**
+     * Set the internal oid pointer to memory for n values, the inline
+     * buffer if they fit into it. The old pointer must have been freed.
+     *
+     * @param n - Number of values
+     *
+     * @return The new pointer
+     */
+    SmiLPUINT32 alloc_oid_ptr(const uint32_t n)
+    {
+        smival.value.oid.ptr =
+            (n <= SNMP_PP_OID_INLINE_LEN) ? m_inline : new SmiUINT32[n];
+        return smival.value.oid.ptr;
+    }
+
+    /**
+     * Take the value of another Oid, which is empty afterwards. Values
+     * in the inline buffer are copied, others are moved. The internal
+     * oid pointer must have been freed.
+     *
+     * @param oid - Source Oid
+     */
+    void take_oid_ptr(Oid& oid) noexcept
+    {
+        if (oid.smival.value.oid.ptr == oid.m_inline)
+        {
+            memcpy(m_inline, oid.m_inline,
+                oid.smival.value.oid.len * sizeof(SmiUINT32));
+            smival.value.oid.ptr = m_inline;
+        }
+        else
+        {
+            smival.value.oid.ptr = oid.smival.value.oid.ptr;
+        }
+        smival.value.oid.len     = oid.smival.value.oid.len;
+        oid.smival.value.oid.ptr = nullptr;
+        oid.smival.value.oid.len = 0;
+        oid.m_changed            = true;
+        m_changed                = true;
+    }
+
+    /**
+     * Get the number of values the internal oid pointer can hold.
+     */
+    uint32_t oid_capacity() const
+    {
+        return (smival.value.oid.ptr == m_inline) ? SNMP_PP_OID_INLINE_LEN
+                                                  : smival.value.oid.len;
+    }
+
     //----[ instance variables ]
 
     SNMP_PP_MUTABLE char* iv_str; // used for returning complete oid string
     SNMP_PP_MUTABLE char* iv_part_str; // used for returning part oid string
     SNMP_PP_MUTABLE bool  m_changed;
+    SmiUINT32             m_inline[SNMP_PP_OID_INLINE_LEN]; // short values
 };
 
 //-----------[ End Oid Class ]-------------------------------------
@@ -726,7 +810,10 @@ inline void Oid::delete_oid_ptr()
     // delete the old value
     if (smival.value.oid.ptr)
     {
-        delete[] smival.value.oid.ptr;
+        if (smival.value.oid.ptr != m_inline)
+        {
+            delete[] smival.value.oid.ptr;
+        }
         smival.value.oid.ptr = nullptr;
     }
     smival.value.oid.len = 0;
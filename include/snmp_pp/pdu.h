@@ -61,18 +61,24 @@
 #include "snmp_pp/octet.h"
 #include "snmp_pp/oid.h"
 #include "snmp_pp/timetick.h"
+#include "snmp_pp/vb.h"
 
 #include <libsnmp.h>
+#include <utility>
 
 #ifdef SNMP_PP_NAMESPACE
 namespace Snmp_pp
 {
 #endif
 
-class Vb;
-
-#define PDU_MAX_RID 32767 ///< max request id to use
-#define PDU_MIN_RID 1000  ///< min request id to use
+// The request id range can be changed at compile time, for example
+// define PDU_MAX_RID as 32767 for agents that fail on larger ids.
+#ifndef PDU_MAX_RID
+#    define PDU_MAX_RID 2147483647 ///< max request id to use
+#endif
+#ifndef PDU_MIN_RID
+#    define PDU_MIN_RID 1000 ///< min request id to use
+#endif
 
 //=======================================================================
 //		     Pdu Class
@@ -112,6 +118,16 @@ public:
         *this = pdu;
     }
 
+    /**
+     * Move constructor, takes the vbs of the source pdu.
+     *
+     * @param pdu - source pdu object, which has no vbs afterwards
+     */
+    Pdu(Pdu&& pdu) noexcept : vbs(nullptr), vbs_size(0), vb_count(0)
+    {
+        *this = std::move(pdu);
+    }
+
     /**
      * Destructor
      */
@@ -124,6 +140,17 @@ public:
      */
     Pdu& operator=(const Pdu& pdu);
 
+    /**
+     * Move assignment operator.
+     *
+     * The vbs of the source pdu are moved without copying them. The
+     * source pdu gets the vbs array of this object for reuse and has
+     * no vbs afterwards.
+     *
+     * @param pdu - Pdu that should be moved to this object
+     */
+    Pdu& operator=(Pdu&& pdu) noexcept;
+
     /**
      * Append a vb to the pdu.
      *
@@ -131,6 +158,44 @@ public:
      */
     Pdu& operator+=(const Vb& vb);
 
+    /**
+     * Append a vb to the pdu, moving its oid and value.
+     *
+     * @param vb - The Vb that should be added (as last vb) to the pdu,
+     *             it is empty afterwards
+     */
+    Pdu& operator+=(Vb&& vb);
+
+    /**
+     * Append an empty vb to the pdu and return it to be filled in place.
+     *
+     * This avoids the copy of operator+=(). The caller has to set a
+     * valid Oid, otherwise the pdu will contain an invalid Vb.
+     *
+     * @return Pointer to the new last vb or nullptr on failure. The
+     *         pointer is invalid after the next change of the vb count.
+     */
+    Vb* append_vb();
+
+    /**
+     * Make room for the given number of vbs.
+     *
+     * The vbs of a pdu are stored in one array that keeps its size on
+     * clear(), trim() and set_vblist(), so a pdu can be reused for
+     * requests of the same size without growing the array again. Only
+     * the used part of the array holds Vb objects, removed vbs release
+     * their values.
+     *
+     * @param count - Number of vbs the pdu should hold without growing
+     * @return true on success
+     */
+    bool reserve(const int count);
+
+    /**
+     * Get the number of vbs the pdu can hold without growing.
+     */
+    int get_vb_capacity() const { return vbs_size; }
+
     /**
      * Clone a Pdu object.
      *
@@ -157,8 +222,8 @@ public:
     /**
      * Deposit all Vbs to Pdu.
      *
-     * The vb objects of the pdu will be freed and the objects from the
-     * array will be cloned and added to the pdu. If this method returns
+     * The vb objects of the pdu will be overwritten with copies of the
+     * objects from the array. If this method returns
      * false, the pdu will not conatin any Vb objects.
      *
      * @param pvbs - Array of valid pointers of size pvb_count
@@ -187,7 +252,7 @@ public:
      * @param index - The Vb to return starting with 0.
      * @return A const reference to the Vb
      */
-    const Vb& get_vb(const int index) const { return *vbs[index]; }
+    const Vb& get_vb(const int index) const { return vbs[index]; }
 
     /**
      * Set a particular vb.
@@ -215,7 +280,7 @@ public:
      *
      * @param i zero based index
      */
-    Vb& operator[](const int i) { return *vbs[i]; }
+    Vb& operator[](const int i) { return vbs[i]; }
 
     /**
      * Get the error status.
@@ -527,11 +592,24 @@ protected:
     /**
      * Extend the vbs array.
      *
+     * @param count - New size of the array, 0 to double it
      * @return true on success
      */
-    bool extend_vbs();
+    bool extend_vbs(const int count = 0);
+
+    /**
+     * Copy count vbs into the array, reusing the constructed vbs.
+     *
+     * @return true on success, false leaves the pdu without vbs
+     */
+    bool copy_vbs(const Vb* src, const int count);
+
+    /**
+     * Destroy the vbs from index from to the end.
+     */
+    void destroy_vbs(const int from);
 
-    Vb**           vbs;             // pointer to array of Vbs
+    Vb*            vbs;             // vb_count Vbs in room for vbs_size
     int            vbs_size;        // Size of array
     int            vb_count;        // count of Vbs
     int            error_status {}; // SMI error status
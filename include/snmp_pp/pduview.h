@@ -0,0 +1,301 @@
+/*_############################################################################
+ * _##
+ * _##  pduview.h
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+
+#ifndef _SNMP_PDUVIEW_H_
+#define _SNMP_PDUVIEW_H_
+
+#include "snmp_pp/config_snmp_pp.h"
+#include "snmp_pp/oid.h"
+#include "snmp_pp/pdu.h"
+#include "snmp_pp/target.h"
+#include "snmp_pp/vb.h"
+
+#include <libsnmp.h>
+
+#ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#endif
+
+/**
+ * Read only view of a BER encoded object identifier.
+ *
+ * The view references the received message and is only valid as long
+ * as the message buffer is, for responses passed to a
+ * snmp_view_callback this is until the callback returns.
+ */
+class DLLOPT OidView {
+public:
+    OidView() : m_data(nullptr), m_len(0) { }
+
+    /**
+     * Create a view of the content octets of an encoded OID.
+     */
+    OidView(const unsigned char* data, const size_t len)
+        : m_data(data), m_len(len)
+    { }
+
+    /**
+     * Get the content octets of the encoded OID.
+     */
+    const unsigned char* data() const { return m_data; }
+
+    /**
+     * Get the number of content octets of the encoded OID.
+     */
+    size_t length() const { return m_len; }
+
+    /**
+     * Get the number of subidentifiers.
+     */
+    unsigned int len() const;
+
+    /**
+     * Decode the subidentifiers.
+     *
+     * @param subids - Array for the subidentifiers
+     * @param max    - Size of the array
+     *
+     * @return The number of subidentifiers or -1 if the array is too
+     *         small or the encoding is invalid
+     */
+    int get_subids(SmiUINT32* subids, const unsigned int max) const;
+
+    /**
+     * Compare with an Oid like Oid::nCompare() for all subidentifiers.
+     *
+     * @return 0 if equal, -1 if the view is less, 1 if it is greater
+     */
+    int compare(const Oid& oid) const;
+
+    /**
+     * Check if the Oid is equal to this view.
+     */
+    bool operator==(const Oid& oid) const { return compare(oid) == 0; }
+
+    /**
+     * Check if this view starts with the given Oid, for example to
+     * detect the end of a subtree while walking.
+     */
+    bool starts_with(const Oid& prefix) const;
+
+    /**
+     * Copy the OID into an Oid object.
+     *
+     * @return true on success
+     */
+    bool to_oid(Oid& oid) const;
+
+private:
+    const unsigned char* m_data;
+    size_t               m_len;
+};
+
+/**
+ * Read only view of a variable binding of a received message.
+ *
+ * Integer values are decoded on access, octet strings and opaque values
+ * are accessed in place through get_value_data() and get_value_len().
+ */
+class DLLOPT VbView {
+    friend class PduView;
+
+public:
+    VbView() : m_syntax(sNMP_SYNTAX_NULL), m_value(nullptr), m_valueLen(0),
+               m_next(nullptr)
+    { }
+
+    /**
+     * Get the OID of the variable binding.
+     */
+    const OidView& get_oid() const { return m_oid; }
+
+    /**
+     * Get the syntax (ASN.1 type) of the value.
+     */
+    SmiUINT32 get_syntax() const { return m_syntax; }
+
+    /**
+     * Get the content octets of the value.
+     */
+    const unsigned char* get_value_data() const { return m_value; }
+
+    /**
+     * Get the number of content octets of the value.
+     */
+    size_t get_value_len() const { return m_valueLen; }
+
+    /**
+     * Get an INTEGER value.
+     *
+     * @return SNMP_CLASS_SUCCESS or SNMP_CLASS_INVALID if the syntax
+     *         does not match
+     */
+    int get_value(int32_t& i) const;
+
+    /**
+     * Get a Counter32, Gauge32 or TimeTicks value.
+     *
+     * @return SNMP_CLASS_SUCCESS or SNMP_CLASS_INVALID if the syntax
+     *         does not match
+     */
+    int get_value(uint32_t& i) const;
+
+    /**
+     * Get a Counter64 value.
+     *
+     * @return SNMP_CLASS_SUCCESS or SNMP_CLASS_INVALID if the syntax
+     *         does not match
+     */
+    int get_value(pp_uint64& i) const;
+
+    /**
+     * Get an OBJECT IDENTIFIER value.
+     *
+     * @return SNMP_CLASS_SUCCESS or SNMP_CLASS_INVALID if the syntax
+     *         does not match
+     */
+    int get_value(OidView& oid) const;
+
+    /**
+     * Copy the variable binding into a Vb object.
+     *
+     * @return SNMP_CLASS_SUCCESS or SNMP_CLASS_INVALID
+     */
+    int to_vb(Vb& vb) const;
+
+private:
+    OidView              m_oid;
+    SmiUINT32            m_syntax;
+    const unsigned char* m_value;
+    size_t               m_valueLen;
+    const unsigned char* m_next; // next variable binding
+};
+
+/**
+ * Read only view of a received SNMPv1 or SNMPv2c response.
+ *
+ * Parsing only checks the structure of the message and does not copy
+ * or allocate anything, values are decoded when they are accessed.
+ * Use to_pdu() to get a Pdu that does not depend on the message buffer.
+ */
+class DLLOPT PduView {
+public:
+    PduView();
+
+    /**
+     * Parse a message. The buffer must not be changed or freed while
+     * the view or any VbView of it is used.
+     *
+     * @param data - The BER encoded message
+     * @param len  - Length of the message
+     *
+     * @return SNMP_CLASS_SUCCESS, SNMP_CLASS_BADVERSION for SNMPv3
+     *         messages or SNMP_CLASS_ASN1ERROR
+     */
+    int parse(const unsigned char* data, const size_t len);
+
+    /**
+     * Check if a message was parsed successfully.
+     */
+    bool valid() const { return m_msg != nullptr; }
+
+    snmp_version get_version() const { return m_version; }
+
+    /**
+     * Get the community of the message, not null terminated.
+     */
+    const unsigned char* get_community_data() const { return m_community; }
+
+    size_t get_community_len() const { return m_communityLen; }
+
+    /**
+     * Get the PDU type, for example sNMP_PDU_RESPONSE.
+     */
+    unsigned short get_type() const { return m_type; }
+
+    uint32_t get_request_id() const { return m_requestId; }
+
+    int get_error_status() const { return m_errorStatus; }
+
+    int get_error_index() const { return m_errorIndex; }
+
+    /**
+     * Get the number of variable bindings.
+     */
+    int get_vb_count() const { return m_vbCount; }
+
+    /**
+     * Get the first variable binding.
+     *
+     * @return false if there are no variable bindings
+     */
+    bool get_first_vb(VbView& vb) const;
+
+    /**
+     * Get the variable binding following the given one.
+     *
+     * @return false if vb was the last one
+     */
+    bool get_next_vb(VbView& vb) const;
+
+    /**
+     * Get a variable binding by index, get_first_vb() and get_next_vb()
+     * are faster if all variable bindings are accessed.
+     *
+     * @return false if the index is out of range
+     */
+    bool get_vb(const int index, VbView& vb) const;
+
+    /**
+     * Decode the whole message into a Pdu.
+     *
+     * @return SNMP_CLASS_SUCCESS or an error code
+     */
+    int to_pdu(Pdu& pdu) const;
+
+private:
+    const unsigned char* m_msg;
+    size_t               m_msgLen;
+    snmp_version         m_version;
+    const unsigned char* m_community;
+    size_t               m_communityLen;
+    unsigned short       m_type;
+    uint32_t             m_requestId;
+    int                  m_errorStatus;
+    int                  m_errorIndex;
+    const unsigned char* m_vbs; // content of the variable binding list
+    const unsigned char* m_vbsEnd;
+    int                  m_vbCount;
+};
+
+#ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#endif
+
+#endif // _SNMP_PDUVIEW_H_
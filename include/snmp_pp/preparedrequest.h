@@ -0,0 +1,158 @@
+/*_############################################################################
+ * _##
+ * _##  preparedrequest.h
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+#ifndef _SNMP_PREPAREDREQUEST_H_
+#define _SNMP_PREPAREDREQUEST_H_
+
+#include "snmp_pp/config_snmp_pp.h"
+#include "snmp_pp/octet.h"
+#include "snmp_pp/pdu.h"
+#include "snmp_pp/target.h"
+
+#include <libsnmp.h>
+
+#ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#endif
+
+/**
+ * Request that is encoded once and sent to many targets.
+ *
+ * The Pdu is encoded for the SNMP version and community given to
+ * prepare(). For each message only the request id is written into a
+ * copy of the encoded message, the Pdu is not converted again. Send
+ * the request with Snmp::send_prepared() or Snmp::send_batch().
+ *
+ * @note Prepared requests are SNMPv1 and SNMPv2c only. An SNMPv3
+ *       message is encrypted and authenticated for each target and
+ *       needs the engine id discovery and report handling of the
+ *       normal request methods, so prepare() refuses version3 with
+ *       SNMP_CLASS_UNSUPPORTED. The request must not be changed while
+ *       it is sent by other threads.
+ */
+class DLLOPT PreparedRequest {
+public:
+    PreparedRequest();
+
+    /**
+     * Encode a request, check valid() for the result.
+     *
+     * @see prepare()
+     */
+    PreparedRequest(const Pdu& pdu, const unsigned short type,
+        const OctetStr& community, const snmp_version version,
+        const int non_repeaters = 0, const int max_reps = 0);
+
+    ~PreparedRequest();
+
+    /**
+     * Encode the Pdu and replace the previous request.
+     *
+     * @param pdu           - Pdu with the varbinds to request
+     * @param type          - sNMP_PDU_GET, sNMP_PDU_GETNEXT,
+     *                        sNMP_PDU_GETBULK or sNMP_PDU_SET, the
+     *                        async types are mapped to these
+     * @param community     - Community to send, the community of the
+     *                        targets is not used
+     * @param version       - version1 or version2c, GETBULK requests
+     *                        are sent as GETNEXT for SNMPv1, version3
+     *                        is not supported
+     * @param non_repeaters - Number of non repeaters for GETBULK
+     * @param max_reps      - Maximum repetitions for GETBULK
+     *
+     * @return SNMP_CLASS_SUCCESS, SNMP_CLASS_UNSUPPORTED for version3 or
+     *         another negative error code
+     */
+    int prepare(const Pdu& pdu, const unsigned short type,
+        const OctetStr& community, const snmp_version version,
+        const int non_repeaters = 0, const int max_reps = 0);
+
+    /**
+     * Check if a request was prepared.
+     */
+    bool valid() const { return m_message != nullptr; }
+
+    /**
+     * Write the message with the given request id to the buffer.
+     *
+     * @param request_id - Request id of the message
+     * @param buf        - Buffer for the message
+     * @param buf_len    - In: size of the buffer, out: message length
+     *
+     * @return SNMP_CLASS_SUCCESS or a negative error code
+     */
+    int build(const long request_id, unsigned char* buf, int* buf_len) const;
+
+    /**
+     * Get the PDU type of the encoded message (sNMP_PDU_GET, ...).
+     */
+    unsigned short get_type() const { return m_pdu.get_type(); }
+
+    /**
+     * Get the SNMP version of the encoded message.
+     */
+    snmp_version get_version() const { return m_version; }
+
+    /**
+     * Get the community of the encoded message.
+     */
+    const OctetStr& get_community() const { return m_community; }
+
+    /**
+     * Get a Pdu with the type of the request, but without varbinds. This
+     * Pdu is passed to callbacks for timeouts.
+     */
+    const Pdu& get_pdu() const { return m_pdu; }
+
+    /**
+     * Get the length of the message, which changes by a few bytes with
+     * the length of the encoded request id.
+     */
+    int get_length() const { return m_messageLen; }
+
+private:
+    PreparedRequest(const PreparedRequest&);
+    PreparedRequest& operator=(const PreparedRequest&);
+
+    void clear();
+
+    Pdu            m_pdu;        // type of the request, no vbs
+    OctetStr       m_community;  // encoded community
+    snmp_version   m_version;    // encoded version
+    unsigned char* m_message;    // message with a request id of m_ridLen
+    int            m_messageLen; // length of m_message
+    int            m_ridOffset;  // offset of the request id contents
+    int            m_ridLen;     // number of content octets of the id
+    int            m_tailOffset; // error status, index and vbs follow
+};
+
+#ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#endif
+
+#endif // _SNMP_PREPAREDREQUEST_H_
@@ -0,0 +1,108 @@
+/*_############################################################################
+ * _##
+ * _##  rttestimator.h
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+#ifndef _SNMP_RTTESTIMATOR_H_
+#define _SNMP_RTTESTIMATOR_H_
+
+#include "snmp_pp/address.h"
+#include "snmp_pp/addresstable.h"
+#include "snmp_pp/config_snmp_pp.h"
+
+#include <libsnmp.h>
+
+#ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#endif
+
+/**
+ * Round trip time estimator for the targets of a session.
+ *
+ * For each address the smoothed round trip time (SRTT) and its
+ * variation (RTTVAR) are maintained as described in RFC 6298. The
+ * retransmission timeout (RTO) computed from these values is bounded
+ * by SNMP_PP_RTO_MIN and SNMP_PP_RTO_MAX. The estimator is not
+ * synchronized, the owning message queue has to lock it.
+ */
+class DLLOPT CRttEstimator {
+public:
+    /**
+     * Get the retransmission timeout for the given address.
+     *
+     * @param address  - Address of the target
+     * @param initial  - Timeout in milliseconds used until the first
+     *                   round trip time was measured
+     * @return The timeout in milliseconds
+     */
+    uint32_t GetTimeout(const Address& address, const uint32_t initial) const;
+
+    /**
+     * Add a round trip time measurement. Only responses to requests
+     * that were not retransmitted must be measured (Karn's algorithm).
+     *
+     * @param address - Address of the target
+     * @param rtt     - Measured round trip time in milliseconds
+     */
+    void AddSample(const Address& address, const uint32_t rtt);
+
+    /**
+     * Keep a backed off timeout of a retransmitted request for the
+     * following requests to the address, until the next measurement.
+     *
+     * @param address - Address of the target
+     * @param timeout - Timeout in milliseconds of the retransmission
+     */
+    void Backoff(const Address& address, const uint32_t timeout);
+
+    /**
+     * Bound the timeout to the range SNMP_PP_RTO_MIN .. SNMP_PP_RTO_MAX.
+     */
+    static uint32_t Bound(const uint32_t timeout)
+    {
+        if (timeout < SNMP_PP_RTO_MIN)
+        {
+            return SNMP_PP_RTO_MIN;
+        }
+        return (timeout > SNMP_PP_RTO_MAX) ? SNMP_PP_RTO_MAX : timeout;
+    }
+
+private:
+    struct Rtt {
+        bool     measured; // srtt and rttvar are valid
+        uint32_t srtt;     // smoothed round trip time
+        uint32_t rttvar;   // round trip time variation
+        uint32_t rto;      // current timeout, 0 if unknown
+    };
+
+    CAddressTable<Rtt> m_table;
+};
+
+#ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#endif
+
+#endif // _SNMP_RTTESTIMATOR_H_
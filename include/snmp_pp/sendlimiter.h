@@ -0,0 +1,145 @@
+/*_############################################################################
+ * _##
+ * _##  sendlimiter.h
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+
+#ifndef _SNMP_SENDLIMITER_H_
+#define _SNMP_SENDLIMITER_H_
+
+#include "snmp_pp/address.h"
+#include "snmp_pp/addresstable.h"
+#include "snmp_pp/config_snmp_pp.h"
+#include "snmp_pp/msec.h"
+
+#include <libsnmp.h>
+
+#ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#endif
+
+class CSNMPMessage;
+
+/**
+ * Flow control for the requests of a session to each address.
+ *
+ * The number of requests sent to an address without a response
+ * (in flight) can be limited, as well as the rate of sending new
+ * requests (token bucket). Requests exceeding the limits are queued in
+ * FIFO order per address. The limiter does not own the queued messages
+ * and is not synchronized, the owning message queue has to lock it.
+ */
+class DLLOPT CSendLimiter {
+public:
+    CSendLimiter();
+
+    /**
+     * Set the limits, 0 disables a limit.
+     *
+     * @param maxInFlight - Maximum number of requests in flight
+     * @param maxRate     - Maximum number of new requests per second
+     * @param burst       - Number of requests that may be sent at once
+     *                      after the address was idle
+     */
+    void SetLimits(
+        const int maxInFlight, const uint32_t maxRate, const uint32_t burst);
+
+    /**
+     * Check if any limit is set.
+     */
+    bool IsEnabled() const { return (m_maxInFlight > 0) || (m_maxRate > 0); }
+
+    /**
+     * Take a slot and a token for a request to the address. Fails if
+     * the limits are reached. The queue is not checked, to keep the
+     * order a new request must be queued without calling this method
+     * if GetFirst() returns a message for the address.
+     *
+     * @param address - Address of the target
+     * @param now     - Current time
+     * @param delay   - Set to the time in milliseconds until the next
+     *                  token is available, 0 if no slot is free
+     * @return true if the request may be sent
+     */
+    bool Acquire(const Address& address, const msec& now, uint32_t& delay);
+
+    /**
+     * Return the slot of a request that was sent.
+     */
+    void Release(const Address& address);
+
+    /**
+     * Queue a message that may not be sent yet.
+     */
+    void Append(CSNMPMessage* message);
+
+    /**
+     * Remove a queued message.
+     */
+    void Remove(CSNMPMessage* message);
+
+    /**
+     * Get the oldest queued message for the address.
+     */
+    CSNMPMessage* GetFirst(const Address& address) const;
+
+    /**
+     * Get the number of currently queued messages.
+     */
+    uint32_t GetQueued() const { return m_queued; }
+
+    /**
+     * Get the number of messages that were queued in total.
+     */
+    uint32_t GetThrottled() const { return m_throttled; }
+
+private:
+    struct Limit {
+        int           inFlight = 0;       // requests without response
+        uint32_t      tokens   = 0;       // available tokens in 1/1000
+        msec          lastRefill;         // time tokens were last added
+        CSNMPMessage* first    = nullptr; // queued messages
+        CSNMPMessage* last     = nullptr;
+    };
+    typedef CAddressTable<Limit>::Entry Entry;
+
+    Entry* FindOrAdd(const Address& address, const msec& now);
+
+    int      m_maxInFlight;
+    uint32_t m_maxRate;
+    uint32_t m_burst;
+
+    CAddressTable<Limit> m_table;
+
+    uint32_t m_queued;
+    uint32_t m_throttled;
+};
+
+#ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#endif
+
+#endif // _SNMP_SENDLIMITER_H_
@@ -57,6 +57,7 @@
 
 //-----[ snmp++ classes ]------------------------------------------------
 #include "snmp_pp/address.h"        // snmp++ address class defs
+#include "snmp_pp/arena.h"
 #include "snmp_pp/asn1.h"
 #include "snmp_pp/config_snmp_pp.h" // config file (SNMPv3)
 #include "snmp_pp/eventlist.h"
@@ -64,10 +65,13 @@
 #include "snmp_pp/log.h"
 #include "snmp_pp/mp_v3.h"    // SNMPv3
 #include "snmp_pp/msec.h"
-#include "snmp_pp/oid.h"      // snmp++ oid class
-#include "snmp_pp/pdu.h"      // snmp++ pdu class
+#include "snmp_pp/oid.h"             // snmp++ oid class
+#include "snmp_pp/pdu.h"             // snmp++ pdu class
+#include "snmp_pp/pduview.h"         // zero-copy view of a received message
+#include "snmp_pp/preparedrequest.h" // request encoded once
 #include "snmp_pp/reentrant.h"
 #include "snmp_pp/snmperrs.h" // error macros and strings
+#include "snmp_pp/snmppool.h"
 #include "snmp_pp/target.h"   // snmp++ target class
 #include "snmp_pp/usm_v3.h"   // SNMPv3
 #include "snmp_pp/uxsnmp.h"
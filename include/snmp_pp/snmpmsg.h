@@ -81,7 +81,22 @@ class Snmp;
 class DLLOPT SnmpMessage {
 public:
     // construct a SnmpMessage object
-    SnmpMessage() : bufflen(MAX_SNMP_PACKET), valid_flag(false) { }
+    SnmpMessage()
+        : databuff(inlinebuff), buffsize(MAX_SNMP_PACKET),
+          bufflen(MAX_SNMP_PACKET), valid_flag(false), arena(nullptr)
+    { }
+
+    // construct a SnmpMessage object for messages up to max_size bytes,
+    // at most SNMP_PP_MAX_MESSAGE_SIZE (SNMPv3: MAX_SNMP_PACKET)
+    explicit SnmpMessage(const unsigned int max_size);
+
+    ~SnmpMessage()
+    {
+        if (databuff != inlinebuff)
+        {
+            delete[] databuff;
+        }
+    }
 
     // load up using a Pdu, community and SNMP version
     // performs ASN.1 serialization
@@ -156,6 +171,10 @@ public:
     // return the validity of the message
     bool valid() const { return valid_flag; }
 
+    // decode the message with memory of the given arena, which must not
+    // be reset during unload(); nullptr to use the heap
+    void set_arena(SnmpArena* a) { arena = a; }
+
     // return raw data
     // check validity
     unsigned char* data() { return databuff; }
@@ -165,9 +184,19 @@ public:
     uint32_t len() const { return bufflen; }
 
 protected:
-    unsigned char databuff[MAX_SNMP_PACKET] {};
-    unsigned int  bufflen;
-    bool          valid_flag;
+    // use a buffer of at least size bytes, the content is not kept
+    void reserve(unsigned int size);
+
+    unsigned char  inlinebuff[MAX_SNMP_PACKET];
+    unsigned char* databuff; // inlinebuff or allocated for larger messages
+    unsigned int   buffsize; // size of databuff
+    unsigned int   bufflen;
+    bool           valid_flag;
+    SnmpArena*     arena; // for the raw pdu in unload(), may be nullptr
+
+private:
+    SnmpMessage(const SnmpMessage&);
+    SnmpMessage& operator=(const SnmpMessage&);
 };
 
 #ifdef SNMP_PP_NAMESPACE
@@ -0,0 +1,140 @@
+/*_############################################################################
+ * _##
+ * _##  snmppool.h
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+#ifndef _SNMP_SNMPPOOL_H_
+#define _SNMP_SNMPPOOL_H_
+
+#include "snmp_pp/config_snmp_pp.h"
+#include "snmp_pp/reentrant.h"
+#include "snmp_pp/uxsnmp.h"
+
+#include <libsnmp.h>
+
+#ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#endif
+
+/**
+ * A pool of Snmp sessions that spreads the response processing over
+ * several threads.
+ *
+ * Each shard is a complete Snmp session with its own socket, message
+ * queue and poll thread. A response always arrives at the socket its
+ * request was sent from, so it is decoded and its callback is called
+ * on the poll thread of that shard. The shards use disjoint request id
+ * ranges, so ids are unique within the pool.
+ *
+ * Requests to the same agent should use the same shard, which is what
+ * get_shard(const SnmpTarget&) does.
+ *
+ * @note Notifications are not received by the pool.
+ */
+class DLLOPT SnmpPool : public SnmpSynchronized {
+public:
+    /**
+     * Create a pool of sessions, each bound to a random free port.
+     *
+     * @param status    - Set to SNMP_CLASS_SUCCESS or the error code of
+     *                    the first shard that could not be created
+     * @param count     - Number of shards
+     * @param bind_ipv6 - Use IPv6 instead of IPv4
+     */
+    SnmpPool(int& status, const int count, const bool bind_ipv6 = false);
+
+    /**
+     * Create a pool of sessions, each bound to the IP address of addr
+     * and a random free port. The port of addr is ignored.
+     *
+     * @param status - Set to SNMP_CLASS_SUCCESS or the error code of
+     *                 the first shard that could not be created
+     * @param count  - Number of shards
+     * @param addr   - Address to bind the shards to
+     */
+    SnmpPool(int& status, const int count, const UdpAddress& addr);
+
+    /**
+     * Destructor, stops the poll threads and deletes all sessions.
+     */
+    ~SnmpPool() override;
+
+    /**
+     * Get the number of shards.
+     */
+    int get_shard_count() const { return m_count; }
+
+    /**
+     * Get a shard by index.
+     *
+     * @param index - 0 to get_shard_count() - 1
+     * @return The session or nullptr if the index is invalid
+     */
+    Snmp* get_shard(const int index);
+
+    /**
+     * Get the shard for the address of the target. All requests to
+     * the same address are sent through the same shard.
+     */
+    Snmp* get_shard(const SnmpTarget& target);
+
+    /**
+     * Get the shards one after the other.
+     */
+    Snmp* get_next_shard();
+
+    /**
+     * Start the poll thread of every shard.
+     *
+     * @param timeout - Timeout for each call of the select() or poll()
+     *                  system call.
+     *
+     * @return true if all threads are running
+     */
+    bool start_poll_threads(const int timeout);
+
+    /**
+     * Stop the poll threads of all shards.
+     */
+    void stop_poll_threads();
+
+private:
+    void init(int& status, const int count, const UdpAddress* addr,
+        const bool bind_ipv6);
+
+    SnmpPool(const SnmpPool&);
+    SnmpPool& operator=(const SnmpPool&);
+
+    Snmp** m_shards;
+    int    m_count;
+    int    m_next; // next shard of get_next_shard()
+};
+
+#ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#endif
+
+#endif // _SNMP_SNMPPOOL_H_
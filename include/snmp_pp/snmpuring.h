@@ -0,0 +1,142 @@
+/*_############################################################################
+ * _##
+ * _##  snmpuring.h
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+#ifndef _SNMP_SNMPURING_H_
+#define _SNMP_SNMPURING_H_
+
+#include "snmp_pp/config_snmp_pp.h"
+
+#include <libsnmp.h>
+
+#ifdef HAVE_IO_URING
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+#    ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#    endif
+
+/**
+ * Receive datagrams of one socket through a Linux io_uring.
+ *
+ * A multishot recvmsg request stays armed on the socket and the kernel
+ * puts each datagram into one of SNMP_PP_URING_BUFFERS provided
+ * buffers. Reading the completions needs no system call. The ring fd
+ * becomes readable when completions are pending, so it is polled
+ * instead of the socket.
+ *
+ * Needs Linux 6.0 or newer. If init() fails, the socket has to be read
+ * as usual.
+ *
+ * @note receive() must not be called concurrently, which the
+ *       EventListHolder guarantees for the message queue.
+ */
+class DLLOPT SnmpUring {
+public:
+    SnmpUring();
+    ~SnmpUring();
+
+    /**
+     * Set up the ring and start receiving from the socket.
+     *
+     * @param sock        - UDP socket, must stay open until the object
+     *                      is deleted
+     * @param buffer_size - Size of the datagram part of each buffer,
+     *                      the maximum message size plus one
+     *
+     * @return true on success, false if io_uring can not be used
+     */
+    bool init(const SnmpSocket sock, const int buffer_size);
+
+    /**
+     * Get the socket the datagrams are received from.
+     */
+    SnmpSocket get_socket() const { return m_socket; }
+
+    /**
+     * Get the ring fd, which is readable if datagrams are pending.
+     */
+    int get_fd() const { return m_ringFd; }
+
+    /**
+     * Fetch the received datagrams, same as receive_snmp_datagrams().
+     *
+     * @param buffers     - max_count buffers of buffer_size bytes
+     * @param buffer_size - Size of each buffer, longer datagrams are
+     *                      truncated
+     * @param lengths     - Set to the length of each datagram
+     * @param from_addrs  - Set to the sender of each datagram
+     * @param max_count   - Maximum number of datagrams to fetch
+     *
+     * @return The number of datagrams, 0 if none are pending
+     */
+    int receive(unsigned char* buffers, const int buffer_size, long* lengths,
+        SocketAddrType* from_addrs, const int max_count);
+
+private:
+    bool arm();
+    void add_buffer(const unsigned short bid);
+    void cleanup();
+
+    SnmpSocket m_socket;
+    int        m_ringFd;
+
+    // submission and completion rings shared with the kernel
+    void*                m_sqRing;
+    size_t               m_sqRingSize;
+    void*                m_cqRing;
+    size_t               m_cqRingSize;
+    struct io_uring_sqe* m_sqes;
+    size_t               m_sqesSize;
+    unsigned*            m_sqTail;
+    unsigned*            m_sqMask;
+    unsigned*            m_sqArray;
+    unsigned*            m_cqHead;
+    unsigned*            m_cqTail;
+    unsigned*            m_cqMask;
+    struct io_uring_cqe* m_cqes;
+
+    // provided buffers
+    struct io_uring_buf_ring* m_bufRing;
+    size_t                    m_bufRingSize;
+    unsigned char*            m_buffers;
+    size_t                    m_bufferSize;
+    unsigned short            m_bufTail;
+
+    struct msghdr m_msg; // template for the multishot recvmsg
+};
+
+#    ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#    endif
+
+#endif // HAVE_IO_URING
+
+#endif // _SNMP_SNMPURING_H_
@@ -109,7 +109,7 @@ public:
      */
     SnmpTarget()
         : validity(false), timeout(default_timeout), retries(default_retries),
-          version(version1), ttype(type_base)
+          adaptive_timeout(false), version(version1), ttype(type_base)
     { }
 
     /**
@@ -117,7 +117,8 @@ public:
      */
     SnmpTarget(const Address& address)
         : validity(false), timeout(default_timeout), retries(default_retries),
-          version(version1), ttype(type_base), my_address(address)
+          adaptive_timeout(false), version(version1), ttype(type_base),
+          my_address(address)
     {
         if (my_address.valid())
         {
@@ -177,6 +178,24 @@ public:
      */
     uint32_t get_timeout() const { return timeout; }
 
+    /**
+     * Enable the adaptive retransmission timeout for requests.
+     *
+     * If enabled, the session measures the round trip time to the
+     * address of the target and derives the timeout of requests from
+     * it (RFC 6298). The timeout of this target is only used until the
+     * first response was received. The timeout is doubled for each
+     * retransmission of a request.
+     *
+     * @param enable - true to use the adaptive timeout
+     */
+    void set_adaptive_timeout(const bool enable) { adaptive_timeout = enable; }
+
+    /**
+     * Check if the adaptive retransmission timeout is used.
+     */
+    bool get_adaptive_timeout() const { return adaptive_timeout; }
+
     /**
      * Change the default timeout.
      *
@@ -267,6 +286,7 @@ protected:
     bool         validity;           ///< Validity of the object
     uint32_t     timeout;            ///< xmit timeout in 10 milli secs
     int          retries;            ///< number of retries
+    bool         adaptive_timeout;   ///< timeout from measured RTT
     snmp_version version;            ///< SNMP version to use
     target_type  ttype;              ///< Type of the target
     GenAddress   my_address;         ///< Address object
@@ -323,6 +343,11 @@ public:
      */
     CTarget(const CTarget& target);
 
+    /**
+     * Move constructor, takes the address and strings of the source.
+     */
+    CTarget(CTarget&& target) noexcept;
+
     /**
      * Destructor, that has nothing to do.
      */
@@ -411,6 +436,11 @@ public:
      */
     CTarget& operator=(const CTarget& target);
 
+    /**
+     * Move assignment operator.
+     */
+    CTarget& operator=(CTarget&& target) noexcept;
+
     /**
      * Overloeaded compare operator.
      *
@@ -506,6 +536,11 @@ public:
      */
     UTarget(const UTarget& target);
 
+    /**
+     * Move constructor, takes the address and strings of the source.
+     */
+    UTarget(UTarget&& target) noexcept;
+
     /**
      * Destructor, that has nothing to do.
      */
@@ -624,6 +659,11 @@ public:
      */
     UTarget& operator=(const UTarget& target);
 
+    /**
+     * Move assignment operator.
+     */
+    UTarget& operator=(UTarget&& target) noexcept;
+
     /**
      * Overloeaded compare operator.
      *
@@ -0,0 +1,135 @@
+/*_############################################################################
+ * _##
+ * _##  timeoutheap.h
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+#ifndef _SNMP_TIMEOUTHEAP_H_
+#define _SNMP_TIMEOUTHEAP_H_
+
+#include "snmp_pp/config_snmp_pp.h"
+#include "snmp_pp/msec.h"
+
+#include <libsnmp.h>
+
+#ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#endif
+
+/**
+ * Base class for elements that can be stored in a CTimeoutHeap.
+ *
+ * The heap stores its own copy of the timeout, so changing the time of
+ * the object behind the element has no effect until
+ * CTimeoutHeap::Update() is called.
+ */
+class DLLOPT CTimeoutHeapEntry {
+    friend class CTimeoutHeap;
+
+public:
+    CTimeoutHeapEntry() : m_heapTime(0, 0), m_heapPos(-1) { }
+
+    /**
+     * Check if the element is currently stored in a heap.
+     */
+    bool InTimeoutHeap() const { return m_heapPos >= 0; }
+
+private:
+    msec m_heapTime;
+    int  m_heapPos;
+};
+
+/**
+ * Indexed binary min-heap of timeouts.
+ *
+ * Used by the event queues to find the next timeout in O(1) and to
+ * add, reschedule and remove elements in O(log n). The heap does not
+ * own its elements and is not synchronized, the owning queue has to
+ * lock it.
+ */
+class DLLOPT CTimeoutHeap {
+public:
+    CTimeoutHeap() : m_entries(nullptr), m_size(0), m_count(0) { }
+
+    ~CTimeoutHeap() { delete[] m_entries; }
+
+    /**
+     * Add an element to the heap.
+     *
+     * @param entry   - Element that is not stored in any heap
+     * @param timeout - Time the element expires
+     */
+    void Insert(CTimeoutHeapEntry* entry, const msec& timeout);
+
+    /**
+     * Change the timeout of an element already stored in the heap.
+     *
+     * @param entry   - Element stored in this heap
+     * @param timeout - New time the element expires
+     */
+    void Update(CTimeoutHeapEntry* entry, const msec& timeout);
+
+    /**
+     * Remove an element from the heap. Does nothing if the element
+     * is not stored in a heap.
+     *
+     * @param entry - Element to remove
+     */
+    void Remove(CTimeoutHeapEntry* entry);
+
+    /**
+     * Get the element with the earliest timeout.
+     *
+     * @return The element or nullptr, if the heap is empty
+     */
+    CTimeoutHeapEntry* Top() const
+    {
+        return (m_count > 0) ? m_entries[0] : nullptr;
+    }
+
+    /**
+     * Get the number of elements in the heap.
+     */
+    int GetCount() const { return m_count; }
+
+private:
+    void SiftUp(int pos);
+    void SiftDown(int pos);
+    void Place(CTimeoutHeapEntry* entry, const int pos)
+    {
+        m_entries[pos]   = entry;
+        entry->m_heapPos = pos;
+    }
+
+    CTimeoutHeapEntry** m_entries;
+    int                 m_size;
+    int                 m_count;
+};
+
+#ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#endif
+
+#endif // _SNMP_TIMEOUTHEAP_H_
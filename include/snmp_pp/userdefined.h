@@ -147,15 +147,21 @@ public:
         return SNMP_CLASS_INVALID_OPERATION;
     } // We never have a timeout
 
+#ifdef HAVE_POLL_SYSCALL
+    int  GetFdCount() override;
+    bool GetFdArray(struct pollfd* readfds, int& remaining) override;
+    int  HandleEvents(const struct pollfd* readfds, const int fds) override;
+#else
     // set up parameters for select
     void GetFdSets(int& maxfds, fd_set& readfds, fd_set& writefds,
         fd_set& exceptfds) override;
 
-    // return number of user-defined event handlers
-    int GetCount() override { return m_msgCount; }
-
     int HandleEvents(const int maxfds, const fd_set& readfds,
         const fd_set& writefds, const fd_set& exceptfds) override;
+#endif
+
+    // return number of user-defined event handlers
+    int GetCount() override { return m_msgCount; }
 
     int DoRetries(const msec& /*sendtime*/) override
     {
@@ -191,6 +197,12 @@ protected:
         class CUDEventQueueElt* m_previous;
     };
 
+#ifdef HAVE_EPOLL_SYSCALL
+    // (re)register the fd with the epoll backend using the union of
+    // the input masks of all entries watching it
+    void UpdateFdRegistration(const int fd);
+#endif
+
     CUDEventQueueElt m_head;
     int              m_msgCount;
     UdId             m_id;
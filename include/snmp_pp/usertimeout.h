@@ -75,6 +75,7 @@
 //----[ snmp++ includes ]----------------------------------------------
 #include "snmp_pp/eventlist.h"
 #include "snmp_pp/msec.h"
+#include "snmp_pp/timeoutheap.h"
 
 #ifdef SNMP_PP_NAMESPACE
 namespace Snmp_pp
@@ -140,14 +141,27 @@ public:
     // find the next timeout
     int GetNextTimeout(msec& timeout) override;
 
+#ifdef HAVE_POLL_SYSCALL
+    int GetFdCount() override { return 0; } // we never have any event sources
+
+    bool GetFdArray(struct pollfd* /*readfds*/, int& /*remaining*/) override
+    {
+        return true;
+    }
+
+    int HandleEvents(
+        const struct pollfd* /*readfds*/, const int /*fds*/) override
+    {
+        msec const now;
+
+        return DoRetries(now);
+    }
+#else
     // set up parameters for select
     void GetFdSets(int& /*maxfds*/, fd_set& /*readfds*/, fd_set& /*writefds*/,
         fd_set& /*exceptfds*/) override
     { } // we never have any event sources
 
-    // return number of outstanding messages
-    int GetCount() override { return m_msgCount; }
-
     int HandleEvents(const int /*maxfds*/, const fd_set& /*readfds*/,
         const fd_set& /*writefds*/, const fd_set& /*exceptfds*/) override
     {
@@ -155,6 +169,10 @@ public:
 
         return DoRetries(now);
     }
+#endif
+
+    // return number of outstanding messages
+    int GetCount() override { return m_msgCount; }
 
     int DoRetries(const msec& sendtime) override;
 
@@ -166,7 +184,7 @@ protected:
     /*   a container for a single item on a linked lists of      */
     /*  CUTEvents.                                               */
     /*-----------------------------------------------------------*/
-    class DLLOPT CUTEventQueueElt {
+    class DLLOPT CUTEventQueueElt : public CTimeoutHeapEntry {
     public:
         CUTEventQueueElt(CUTEvent* utevent, CUTEventQueueElt* next,
             CUTEventQueueElt* previous);
@@ -191,6 +209,7 @@ protected:
     int              m_msgCount;
     UtId             m_id;
     EventListHolder* my_holder;
+    CTimeoutHeap     m_timeouts; // all elements ordered by timeout
 };
 
 #ifdef SNMP_PP_NAMESPACE
@@ -177,37 +177,43 @@ namespace Snmp_pp
 
 class SnmpTarget;
 class Pdu;
+class AuthHMACContext;
+class PrivKeyContext;
 
 struct UsmKeyUpdate;
 
 struct UsmUserTableEntry {
-    unsigned char* usmUserEngineID;
-    SmiINT32       usmUserEngineIDLength;
-    unsigned char* usmUserName;
-    SmiINT32       usmUserNameLength;
-    unsigned char* usmUserSecurityName;
-    SmiINT32       usmUserSecurityNameLength;
-    SmiINT32       usmUserAuthProtocol;
-    unsigned char* usmUserAuthKey;
-    SmiINT32       usmUserAuthKeyLength;
-    SmiINT32       usmUserPrivProtocol;
-    unsigned char* usmUserPrivKey;
-    SmiINT32       usmUserPrivKeyLength;
+    unsigned char*   usmUserEngineID;
+    SmiINT32         usmUserEngineIDLength;
+    unsigned char*   usmUserName;
+    SmiINT32         usmUserNameLength;
+    unsigned char*   usmUserSecurityName;
+    SmiINT32         usmUserSecurityNameLength;
+    SmiINT32         usmUserAuthProtocol;
+    unsigned char*   usmUserAuthKey;
+    SmiINT32         usmUserAuthKeyLength;
+    SmiINT32         usmUserPrivProtocol;
+    unsigned char*   usmUserPrivKey;
+    SmiINT32         usmUserPrivKeyLength;
+    AuthHMACContext* usmUserAuthContext; ///< keyed states of the auth key
+    PrivKeyContext*  usmUserPrivContext; ///< key schedule of the priv key
 };
 
 struct UsmUser {
-    unsigned char* engineID;
-    SmiINT32       engineIDLength;
-    unsigned char* usmUserName;
-    SmiINT32       usmUserNameLength;
-    unsigned char* securityName;
-    SmiINT32       securityNameLength;
-    SmiINT32       authProtocol;
-    unsigned char* authKey;
-    SmiINT32       authKeyLength;
-    SmiINT32       privProtocol;
-    unsigned char* privKey;
-    SmiINT32       privKeyLength;
+    unsigned char*   engineID;
+    SmiINT32         engineIDLength;
+    unsigned char*   usmUserName;
+    SmiINT32         usmUserNameLength;
+    unsigned char*   securityName;
+    SmiINT32         securityNameLength;
+    SmiINT32         authProtocol;
+    unsigned char*   authKey;
+    SmiINT32         authKeyLength;
+    SmiINT32         privProtocol;
+    unsigned char*   privKey;
+    SmiINT32         privKeyLength;
+    AuthHMACContext* authContext; ///< keyed states of the auth key or NULL
+    PrivKeyContext*  privContext; ///< key schedule of the priv key or NULL
 };
 
 struct UsmUserNameTableEntry {
@@ -34,6 +34,7 @@
 #include "snmp_pp/target.h"
 
 #include <libsnmp.h>
+#include <atomic>
 
 #ifdef SNMP_PP_NAMESPACE
 namespace Snmp_pp
@@ -60,6 +61,8 @@ namespace Snmp_pp
 class Snmp;
 class EventListHolder;
 class Pdu;
+class PduView;
+class PreparedRequest;
 class v3MP;
 
 //-----------[ async methods callback ]-----------------------------------
@@ -80,6 +83,41 @@ class v3MP;
 typedef void (*snmp_callback)(
     int reason, Snmp* session, Pdu& pdu, SnmpTarget& target, void* data);
 
+/**
+ * Callback for async requests that receive the response as a PduView.
+ * The view refers to the receive buffer and is only valid within the
+ * callback, no Pdu and Vb objects are created for the response.
+ *
+ * @note Only SNMPv1 and SNMPv2c requests are supported. For timeouts and
+ *       destroyed sessions an invalid view is passed.
+ *
+ * @param reason  - Reason for callback (see snmperrs.h)
+ * @param session - Pointer to Snmp object that was used to send the request
+ * @param view    - View of the received message if reason indicates a
+ *                  received message
+ * @param target  - source target
+ * @param data    - Pointer passed to the async method
+ */
+typedef void (*snmp_view_callback)(int reason, Snmp* session,
+    const PduView& view, SnmpTarget& target, void* data);
+
+/**
+ * One request of a batch sent with Snmp::send_batch().
+ */
+struct DLLOPT SnmpBatchRequest {
+    Pdu*           pdu;           ///< Pdu to send
+    SnmpTarget*    target;        ///< Target for the request
+    unsigned short type;          ///< sNMP_PDU_GET_ASYNC, ...
+    int            non_repeaters; ///< For GETBULK requests
+    int            max_reps;      ///< For GETBULK requests
+    snmp_callback  callback;      ///< User callback function
+    const void*    callback_data; ///< User definable data pointer
+    int            status;        ///< Set by send_batch()
+};
+
+class SnmpSendBatch;
+class SnmpUring;
+
 /**
  * Set the FD_CLOEXEC flag on the given socket.
  * @param fd - The socket
@@ -110,6 +148,14 @@ class DLLOPT Snmp : public SnmpSynchronized {
 public:
     //------------------[ constructors ]----------------------------------
 
+    /**
+     * How a session receives its responses.
+     */
+    enum transport_type {
+        transport_socket,  ///< Poll and read the sockets (default)
+        transport_io_uring ///< Linux io_uring, if available
+    };
+
     /** @name Constructors and Destructor */
     //@{
 
@@ -126,9 +172,13 @@ public:
      * @param bind_ipv6
      *    Set this to true if IPv6 should be used. The default is
      *    IPv4.
+     * @param transport
+     *    How responses are received. If io_uring is requested but
+     *    not available, the sockets are used.
      */
     Snmp(int& status, const unsigned short port = 0,
-        const bool bind_ipv6 = false);
+        const bool bind_ipv6 = false,
+        const transport_type transport = transport_socket);
 
     /**
      * Construct a new SNMP session using the given UDP address.
@@ -139,8 +189,12 @@ public:
      *    hold the creation status.
      * @param addr
      *    an UDP address to be used for the session
+     * @param transport
+     *    How responses are received. If io_uring is requested but
+     *    not available, the sockets are used.
      */
-    Snmp(int& status, const UdpAddress& addr);
+    Snmp(int& status, const UdpAddress& addr,
+        const transport_type transport = transport_socket);
 
     /**
      * Construct a new SNMP session using the given UDP addresses.
@@ -153,8 +207,12 @@ public:
      *    an IPv4 UDP address to be used for the session
      * @param addr_v6
      *    an IPv6 UDP address to be used for the session
+     * @param transport
+     *    How responses are received. If io_uring is requested but
+     *    not available, the sockets are used.
      */
-    Snmp(int& status, const UdpAddress& addr_v4, const UdpAddress& addr_v6);
+    Snmp(int& status, const UdpAddress& addr_v4, const UdpAddress& addr_v6,
+        const transport_type transport = transport_socket);
 
     //-------------------[ destructor ]------------------------------------
 
@@ -263,6 +321,20 @@ public:
     virtual int get(Pdu& pdu, SnmpTarget& target, const snmp_callback callback,
         const void* callback_data = nullptr);
 
+    /**
+     * Send a async SNMP-GET request and receive the response as a view
+     * of the received message.
+     *
+     * @param pdu      - Pdu to send
+     * @param target   - Target for the get (SNMPv1 or SNMPv2c)
+     * @param callback - User callback function to use
+     * @param callback_data - User definable data pointer
+     *
+     * @return SNMP_CLASS_SUCCESS or a negative error code
+     */
+    int get(Pdu& pdu, SnmpTarget& target, const snmp_view_callback callback,
+        const void* callback_data = nullptr);
+
     /**
      * Send a blocking SNMP-GETNEXT request.
      *
@@ -286,6 +358,21 @@ public:
     virtual int get_next(Pdu& pdu, SnmpTarget& target,
         const snmp_callback callback, const void* callback_data = nullptr);
 
+    /**
+     * Send a async SNMP-GETNEXT request and receive the response as a
+     * view of the received message.
+     *
+     * @param pdu      - Pdu to send
+     * @param target   - Target for the getnext (SNMPv1 or SNMPv2c)
+     * @param callback - User callback function to use
+     * @param callback_data - User definable data pointer
+     *
+     * @return SNMP_CLASS_SUCCESS or a negative error code
+     */
+    int get_next(Pdu& pdu, SnmpTarget& target,
+        const snmp_view_callback callback,
+        const void*              callback_data = nullptr);
+
     /**
      * Send a blocking SNMP-SET request.
      *
@@ -338,6 +425,98 @@ public:
         const int max_reps, const snmp_callback callback,
         const void* callback_data = nullptr);
 
+    /**
+     * Send a async SNMP-GETBULK request and receive the response as a
+     * view of the received message.
+     *
+     * @param pdu           - Pdu to send
+     * @param target        - Target for the getbulk (SNMPv2c)
+     * @param non_repeaters - number of non repeaters
+     * @param max_reps      - maximum number of repetitions
+     * @param callback      - User callback function to use
+     * @param callback_data - User definable data pointer
+     *
+     * @return SNMP_CLASS_SUCCESS or a negative error code
+     */
+    int get_bulk(Pdu& pdu, SnmpTarget& target, const int non_repeaters,
+        const int max_reps, const snmp_view_callback callback,
+        const void* callback_data = nullptr);
+
+    /**
+     * Send a batch of async requests.
+     *
+     * All requests are encoded and added to the message queue first,
+     * then they are sent with as few system calls as possible
+     * (sendmmsg() if available). Retries and callbacks work the same
+     * as for the single async methods.
+     *
+     * @param requests - Array of requests, the status member of each
+     *                   request is set to SNMP_CLASS_SUCCESS or a
+     *                   negative error code
+     * @param count    - Number of requests in the array
+     *
+     * @return The number of requests sent successfully
+     */
+    virtual int send_batch(SnmpBatchRequest* requests, const int count);
+
+    /**
+     * Send a async request that was encoded with PreparedRequest.
+     *
+     * Only a new request id is written into a copy of the encoded
+     * message, the community of the request is used instead of the
+     * community of the target. On timeout the callback receives a Pdu
+     * without varbinds.
+     *
+     * @note SNMPv1 and SNMPv2c only, see PreparedRequest. Targets with
+     *       another version than the request are refused with
+     *       SNMP_CLASS_INVALID_TARGET.
+     *
+     * @param request       - Request to send
+     * @param target        - Target with the version of the request
+     * @param callback      - User callback function to use
+     * @param callback_data - User definable data pointer
+     *
+     * @return SNMP_CLASS_SUCCESS or a negative error code
+     */
+    int send_prepared(const PreparedRequest& request, SnmpTarget& target,
+        const snmp_callback callback, const void* callback_data = nullptr);
+
+    /**
+     * Send a async request that was encoded with PreparedRequest and
+     * receive the response as a view of the received message.
+     *
+     * @param request       - Request to send
+     * @param target        - Target with the version of the request
+     * @param callback      - User callback function to use
+     * @param callback_data - User definable data pointer
+     *
+     * @return SNMP_CLASS_SUCCESS or a negative error code
+     */
+    int send_prepared(const PreparedRequest& request, SnmpTarget& target,
+        const snmp_view_callback callback,
+        const void*              callback_data = nullptr);
+
+    /**
+     * Send a request that was encoded with PreparedRequest to many
+     * targets. The messages are sent with as few system calls as
+     * possible, like the messages of send_batch().
+     *
+     * @param request       - Request to send
+     * @param targets       - Array of targets
+     * @param count         - Number of targets in the array
+     * @param callback      - User callback function to use
+     * @param callback_data - User definable data pointer
+     * @param status        - Optional array of count elements, set to
+     *                        SNMP_CLASS_SUCCESS or a negative error code
+     *                        for each target
+     *
+     * @return The number of requests sent successfully
+     */
+    int send_prepared(const PreparedRequest& request,
+        SnmpTarget* const* targets, const int count,
+        const snmp_callback callback, const void* callback_data = nullptr,
+        int* status = nullptr);
+
     /**
      * Send a SNMP-TRAP.
      *
@@ -533,6 +712,10 @@ public:
      * This method is used to start response and notification processing in a
      * multi threaded setup.
      *
+     * While the thread is running, synchronous requests do not process
+     * events themselves. They wait until the thread has received their
+     * response or the request has timed out.
+     *
      * @note start_poll_thread() itself is not thread safe. The caller must
      * make sure that only one thread is calling start_poll_thread() or
      *       stop_poll_thread() at any point in time.
@@ -555,15 +738,99 @@ public:
      */
     void stop_poll_thread();
 
-    EventListHolder* get_eventListHolder() { return eventListHolder; }
-
-protected:
     /**
      * Check for the status of the worker thread.
      * @return true - if running, false - otherwise
      */
     bool is_running() const { return m_isThreadRunning; }
 
+    EventListHolder* get_eventListHolder() { return eventListHolder; }
+
+    /**
+     * Get the transport that is used to receive responses. This is
+     * transport_socket if io_uring was requested but is not available.
+     */
+    transport_type get_transport() const;
+
+    /**
+     * Get the fd that becomes readable when responses for the given
+     * socket of this session are pending. This is the socket itself or
+     * the fd of its io_uring.
+     */
+    SnmpSocket get_poll_fd(const SnmpSocket sock) const;
+
+    /**
+     * Read pending datagrams for a fd returned by get_poll_fd().
+     * Used by the message queue, see receive_snmp_datagrams().
+     */
+    int receive_datagrams(const SnmpSocket poll_fd, unsigned char* buffers,
+        const int buffer_size, long* lengths, SocketAddrType* from_addrs,
+        const int max_count);
+
+    /**
+     * Limit the request ids used by this session. Sessions that share
+     * the SNMPv3 message processing (like the shards of a SnmpPool)
+     * can use disjoint ranges, so their request ids never collide.
+     *
+     * @param range_min - Lowest request id, at least PDU_MIN_RID
+     * @param range_max - Highest request id, at most PDU_MAX_RID
+     *
+     * @return true on success, false if the range is invalid
+     */
+    bool set_request_id_range(const long range_min, const long range_max);
+
+    /**
+     * Set the maximum size of the messages sent and received by this
+     * session. Responses that are longer are dropped. Larger sizes allow
+     * GETBULK requests with more repetitions. The size may be changed
+     * while other threads process the events of the session: The
+     * responses already received by io_uring are processed in the
+     * calling thread before the rings are restarted with the new size.
+     * Must not be called from a callback of this session.
+     *
+     * @note SNMPv3 messages are limited to MAX_SNMP_PACKET bytes.
+     *
+     * @param size - Size in bytes, 484 up to SNMP_PP_MAX_MESSAGE_SIZE,
+     *               the default is MAX_SNMP_PACKET
+     *
+     * @return true on success, false if the size is invalid
+     */
+    bool set_max_message_size(const int size);
+
+    /**
+     * Get the maximum size of the messages sent and received by this
+     * session.
+     */
+    int get_max_message_size() const { return max_message_size; }
+
+    /**
+     * Limit the async requests this session sends to each address.
+     *
+     * Requests exceeding the limits are queued by the session and sent
+     * in order as soon as responses arrive, requests time out or tokens
+     * become available. The timeout of a queued request starts when it
+     * is sent. Retries and synchronous requests are not limited.
+     *
+     * @param max_in_flight - Maximum number of requests sent to an
+     *                        address without a response, 0 for no limit
+     * @param max_rate      - Maximum number of requests sent to an
+     *                        address per second, 0 for no limit
+     * @param burst         - Number of requests that may be sent at once
+     *                        to an idle address if max_rate is set
+     */
+    void set_destination_limits(const int max_in_flight,
+        const uint32_t max_rate = 0, const uint32_t burst = 1);
+
+    /**
+     * Get the counters of the limits set by set_destination_limits().
+     *
+     * @param queued    - Number of async requests currently queued
+     * @param throttled - Number of async requests queued since the
+     *                    session was created
+     */
+    void get_destination_limit_counters(uint32_t& queued, uint32_t& throttled);
+
+protected:
     /**
      * This is a working thread for the recovery of the pending events.
      *
@@ -582,7 +849,7 @@ protected:
     /**
      * Generate a unique (for this Snmp object) request id.
      *
-     * @return Unique id between PDU_MIN_RID and PDU_MAX_RID
+     * @return Unique id between min_rid and max_rid
      */
     long MyMakeReqId();
 
@@ -592,6 +859,11 @@ protected:
     void init(int& status, IpAddress* [2], const unsigned short port_v4,
         const unsigned short port_v6);
 
+#ifdef HAVE_IO_URING
+    // receive from the socket with io_uring, if requested and possible
+    void start_uring(const int index, const SnmpSocket sock);
+#endif
+
     /**
      * Set the notify timestamp of a trap pdu if the user did not set it.
      */
@@ -613,7 +885,17 @@ protected:
         SnmpTarget&         target,   // destination target
         const snmp_callback cb,       // async callback function
         const void*         cbd,      // callback data
-        SnmpSocket fd = INVALID_SOCKET, int reports_received = 0);
+        SnmpSocket fd = INVALID_SOCKET, int reports_received = 0,
+        SnmpSendBatch* batch = nullptr,  // collect instead of sending
+        const snmp_view_callback view_cb = nullptr); // async view callback
+
+    /**
+     * Add a prepared request to the message queue and send it, or add
+     * it to the batch.
+     */
+    int prepared_engine(const PreparedRequest& request, SnmpTarget& target,
+        const snmp_callback cb, const void* cbd, SnmpSendBatch* batch,
+        const snmp_view_callback view_cb);
 
     //--------[ map action ]------------------------------------------------
     // map the snmp++ action to a SMI pdu type
@@ -646,8 +928,11 @@ protected:
     SnmpSocket iv_snmp_session_ipv6;
 #endif
 
-    IpAddress listen_address;
-    long      current_rid; // current rid to use
+    IpAddress        listen_address;
+    long             current_rid;      // current rid to use
+    long             min_rid;          // lowest rid to use
+    long             max_rid;          // highest rid to use
+    std::atomic<int> max_message_size; // of sent and received messages
 
     // inform receive member variables
     snmp_callback notifycallback;
@@ -660,6 +945,11 @@ private:
     bool m_isThreadRunning;
     int  m_pollTimeOut;
 
+    transport_type m_transport; // requested transport
+#ifdef HAVE_IO_URING
+    SnmpUring* m_uring[2]; // io_uring of the IPv4 and IPv6 socket
+#endif
+
     // Keep track of the thread.
 #ifdef _THREADS
 #    ifdef WIN32
@@ -70,6 +70,7 @@
 #include "snmp_pp/timetick.h" // time ticks
 
 #include <string>
+#include <utility>
 
 #ifdef SNMP_PP_NAMESPACE
 namespace Snmp_pp
@@ -86,6 +87,10 @@ namespace Snmp_pp
  * getting or setting MIB values.  The vb class keeps its own memory
  * for objects and does not utilize pointers to external data
  * structures.
+ *
+ * Values of the classes SnmpInt32, SnmpUInt32, Counter32, Gauge32,
+ * TimeTicks, Counter64, IpAddress and short OctetStr and Oid values are
+ * stored inside the Vb. Only other values are cloned to the heap.
  */
 class DLLOPT Vb {
     //-----[ public members ]
@@ -97,7 +102,10 @@ public:
      *
      * This constructor creates an unitialized vb.
      */
-    Vb() : iv_vb_value(nullptr), exception_status(SNMP_CLASS_SUCCESS) { }
+    Vb()
+        : iv_vb_value(nullptr), exception_status(SNMP_CLASS_SUCCESS),
+          m_inlineType(inline_none), m_valueLen(0), m_printable(nullptr)
+    { }
 
     /**
      * Constructor to initialize the oid.
@@ -106,13 +114,33 @@ public:
      */
     Vb(const Oid& oid)
         : iv_vb_oid(oid), iv_vb_value(nullptr),
-          exception_status(SNMP_CLASS_SUCCESS)
+          exception_status(SNMP_CLASS_SUCCESS), m_inlineType(inline_none),
+          m_valueLen(0), m_printable(nullptr)
     { }
 
     /**
      * Copy constructor.
      */
-    Vb(const Vb& vb) : iv_vb_value(nullptr) { *this = vb; }
+    Vb(const Vb& vb)
+        : iv_vb_value(nullptr), m_inlineType(inline_none), m_valueLen(0),
+          m_printable(nullptr)
+    {
+        *this = vb;
+    }
+
+    /**
+     * Move constructor, the source vb is empty afterwards.
+     */
+    Vb(Vb&& vb) noexcept
+        : iv_vb_oid(std::move(vb.iv_vb_oid)), iv_vb_value(vb.iv_vb_value),
+          exception_status(vb.exception_status),
+          m_inlineType(vb.m_inlineType), m_valueLen(vb.m_valueLen),
+          m_value(vb.m_value), m_printable(vb.m_printable)
+    {
+        vb.iv_vb_value  = nullptr;
+        vb.m_printable  = nullptr;
+        vb.m_inlineType = inline_none;
+    }
 
     /**
      * Destructor that frees all allocated memory.
@@ -124,6 +152,11 @@ public:
      */
     Vb& operator=(const Vb& vb);
 
+    /**
+     * Move assignment operator, the source vb is empty afterwards.
+     */
+    Vb& operator=(Vb&& vb) noexcept;
+
     /**
      * Clone operator.
      */
@@ -157,11 +190,7 @@ public:
     /**
      * Set the value using any SnmpSyntax object.
      */
-    void set_value(const SnmpSyntax& val)
-    {
-        free_vb();
-        iv_vb_value = val.clone();
-    }
+    void set_value(const SnmpSyntax& val);
 
     /**
      * Set the value with an int.
@@ -171,7 +200,8 @@ public:
     void set_value(const int32_t i)
     {
         free_vb();
-        iv_vb_value = new SnmpInt32(i);
+        m_inlineType = inline_int32;
+        m_value.i32  = i;
     }
 
     /**
@@ -182,7 +212,8 @@ public:
     void set_value(const uint32_t i)
     {
         free_vb();
-        iv_vb_value = new SnmpUInt32(i);
+        m_inlineType = inline_uint32;
+        m_value.u32  = i;
     }
 
     /**
@@ -192,11 +223,7 @@ public:
      *
      * The syntax of the Vb will be set to SMI INT32.
      */
-    void set_value(const int64_t i)
-    {
-        free_vb();
-        iv_vb_value = new SnmpInt32(static_cast<int32_t>(i));
-    }
+    void set_value(const int64_t i) { set_value(static_cast<int32_t>(i)); }
 
     /**
      * Set the value with an uint32_t int.
@@ -207,8 +234,7 @@ public:
      */
     void set_value(const uint64_t i)
     {
-        free_vb();
-        iv_vb_value = new SnmpUInt32(static_cast<uint32_t>(i));
+        set_value(static_cast<uint32_t>(i));
     }
 
     /**
@@ -218,8 +244,7 @@ public:
      */
     void set_value(const char* ptr)
     {
-        free_vb();
-        iv_vb_value = new OctetStr(ptr);
+        set_value((const unsigned char*)ptr, ptr ? (uint32_t)strlen(ptr) : 0);
     }
 
     /**
@@ -227,11 +252,7 @@ public:
      *
      * The syntax of the Vb will be set to SMI octet.
      */
-    void set_value(const unsigned char* ptr, const uint32_t len)
-    {
-        free_vb();
-        iv_vb_value = new OctetStr(ptr, len);
-    }
+    void set_value(const unsigned char* ptr, const uint32_t len);
 
     /**
      * Set the value portion of the vb to null, if its not already.
@@ -389,6 +410,10 @@ public:
      */
     [[nodiscard]] SnmpSyntax* clone_value() const
     {
+        if (m_inlineType != inline_none)
+        {
+            return new_value();
+        }
         return (iv_vb_value) ? iv_vb_value->clone() : nullptr;
     }
 
@@ -470,14 +495,61 @@ public:
 
     //-----[ protected members ]
 protected:
+    // class of the value stored in m_value
+    enum InlineType {
+        inline_none, // no value or iv_vb_value
+        inline_int32,
+        inline_uint32,
+        inline_counter32,
+        inline_gauge32,
+        inline_timeticks,
+        inline_counter64,
+        inline_octets,
+        inline_ipaddress,
+        inline_oid
+    };
+
     Oid         iv_vb_oid;           // a vb is made up of a oid
     SnmpSyntax* iv_vb_value;         // and a value...
     SmiUINT32   exception_status {}; // are there any vb exceptions??
 
+    // ...or a value stored inside the vb
+    InlineType m_inlineType;
+    uint32_t   m_valueLen; // length of octets, ip address and oid values
+    union {
+        SmiINT32      i32;
+        SmiUINT32     u32;
+        pp_uint64     u64;
+        unsigned char octets[SNMP_PP_VB_INLINE_SIZE];
+        SmiUINT32     oid[SNMP_PP_VB_INLINE_SIZE / sizeof(SmiUINT32)];
+    } m_value;
+    SNMP_PP_MUTABLE SnmpSyntax* m_printable; // for get_printable_value()
+
     /**
      * Free the value portion.
      */
     void free_vb();
+
+    /**
+     * Store the value inside the vb, if it is of one of the classes
+     * that can be stored there.
+     *
+     * @return true if the value was stored
+     */
+    bool set_inline_value(const SnmpSyntax& val);
+
+    /**
+     * Create an object for the value stored inside the vb.
+     *
+     * @return A new object, which has to be deleted by the caller
+     */
+    [[nodiscard]] SnmpSyntax* new_value() const;
+
+    /**
+     * Call func with a temporary object for the value stored inside
+     * the vb.
+     */
+    template <class Func> void with_inline_value(Func func) const;
 };
 
 #ifdef SNMP_PP_NAMESPACE
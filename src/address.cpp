@@ -55,6 +55,7 @@
 #include "snmp_pp/v3.h" // for debugprintf()
 
 #include <libsnmp.h>
+#include <utility>
 
 #ifdef SNMP_PP_NAMESPACE
 namespace Snmp_pp
@@ -316,6 +317,34 @@ IpAddress::IpAddress(const IpAddress& ipaddr)
     }
 }
 
+//-----[ move constructor ]----------------------------------------------
+IpAddress::IpAddress(IpAddress&& ipaddr) noexcept
+    : iv_friendly_name_status(0), ip_version(ipaddr.ip_version),
+      have_ipv6_scope(ipaddr.have_ipv6_scope)
+{
+    ADDRESS_TRACE;
+
+    // always initialize what type this object is
+    smival.syntax           = sNMP_SYNTAX_IPADDR;
+    smival.value.string.len = ipaddr.smival.value.string.len;
+    smival.value.string.ptr = address_buffer;
+
+    valid_flag = ipaddr.valid_flag;
+    if (valid_flag)
+    {
+        // copy the address data and take the friendly name
+        memcpy(address_buffer, ipaddr.address_buffer, smival.value.string.len);
+        iv_friendly_name.swap(ipaddr.iv_friendly_name);
+
+        if (!ipaddr.addr_changed)
+        {
+            memcpy(output_buffer, ipaddr.output_buffer,
+                sizeof(unsigned char) * OUTBUFF_IP);
+            addr_changed = false;
+        }
+    }
+}
+
 //-----[ construct an IP address with a GenAddress ]---------------------
 IpAddress::IpAddress(const GenAddress& genaddr) : iv_friendly_name_status(0)
 {
@@ -1610,6 +1639,29 @@ UdpAddress::UdpAddress(const UdpAddress& udpaddr) : IpAddress(udpaddr)
     }
 }
 
+// move constructor, only the friendly name is taken from the source
+UdpAddress::UdpAddress(UdpAddress&& udpaddr) noexcept
+    : IpAddress(std::move(udpaddr))
+{
+    ADDRESS_TRACE;
+
+    // always initialize SMI info
+    smival.syntax           = sNMP_SYNTAX_OCTETS;
+    smival.value.string.len = udpaddr.smival.value.string.len;
+    smival.value.string.ptr = address_buffer;
+
+    // Copy the port value
+    sep = ':';
+    set_port(udpaddr.get_port());
+
+    if (!udpaddr.addr_changed)
+    {
+        memcpy(output_buffer, udpaddr.output_buffer,
+            sizeof(unsigned char) * OUTBUFF_UDP);
+        addr_changed = false;
+    }
+}
+
 // constructor with a dotted string
 UdpAddress::UdpAddress(const char* inaddr) : IpAddress()
 {
@@ -1846,6 +1898,26 @@ UdpAddress& UdpAddress::operator=(const UdpAddress& udpaddr)
     return *this;
 }
 
+// move assignment, copies the address and takes the friendly name
+UdpAddress& UdpAddress::operator=(UdpAddress&& udpaddr) noexcept
+{
+    ADDRESS_TRACE;
+
+    if (this == &udpaddr)
+    {
+        return *this; // protect against assignment from itself
+    }
+    std::string name;
+    name.swap(udpaddr.iv_friendly_name); // so it is not copied
+
+    UdpAddress::operator=(static_cast<const UdpAddress&>(udpaddr));
+    if (valid_flag)
+    {
+        iv_friendly_name.swap(name);
+    }
+    return *this;
+}
+
 // assignment to another UdpAddress object overloaded
 UdpAddress& UdpAddress::operator=(const IpAddress& ipaddr)
 {
@@ -3165,6 +3237,26 @@ GenAddress::GenAddress(const GenAddress& addr)
     }
 }
 
+//-----------------[ move constructor ]---------------------------------------
+GenAddress::GenAddress(GenAddress&& addr) noexcept : address(addr.address)
+{
+    ADDRESS_TRACE;
+
+    output_buffer[0] = 0;
+    // take the replica of the real address' smival info
+    smival.syntax           = addr.smival.syntax;
+    smival.value.string.len = addr.smival.value.string.len;
+    smival.value.string.ptr = address_buffer;
+    memcpy(smival.value.string.ptr, addr.smival.value.string.ptr,
+        (size_t)smival.value.string.len);
+    valid_flag = addr.valid_flag;
+
+    addr.address                 = nullptr;
+    addr.valid_flag              = false;
+    addr.smival.syntax           = sNMP_SYNTAX_OCTETS;
+    addr.smival.value.string.len = 0;
+}
+
 //------[ assignment GenAddress = GenAddress ]-----------------------------
 GenAddress& GenAddress::operator=(const GenAddress& addr)
 {
@@ -3206,6 +3298,34 @@ GenAddress& GenAddress::operator=(const GenAddress& addr)
     return *this;
 }
 
+//------[ move assignment GenAddress = GenAddress ]------------------------
+GenAddress& GenAddress::operator=(GenAddress&& addr) noexcept
+{
+    ADDRESS_TRACE;
+
+    if (this == &addr)
+    {
+        return *this; // protect against assignment from itself
+    }
+    delete address;
+
+    // take the address object and the replica of its smival info
+    address                 = addr.address;
+    valid_flag              = addr.valid_flag;
+    addr_changed            = true;
+    smival.syntax           = addr.smival.syntax;
+    smival.value.string.len = addr.smival.value.string.len;
+    memcpy(smival.value.string.ptr, addr.smival.value.string.ptr,
+        (size_t)smival.value.string.len);
+
+    addr.address                 = nullptr;
+    addr.valid_flag              = false;
+    addr.smival.syntax           = sNMP_SYNTAX_OCTETS;
+    addr.smival.value.string.len = 0;
+
+    return *this;
+}
+
 //------[ assignment GenAddress = Address ]--------------------------------
 Address& GenAddress::operator=(const Address& addr)
 {
@@ -0,0 +1,95 @@
+/*_############################################################################
+ * _##
+ * _##  arena.cpp
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+#include "snmp_pp/arena.h"
+
+#include <libsnmp.h>
+
+#ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#endif
+
+SnmpArena::SnmpArena(const size_t block_size)
+    : m_blocks(nullptr), m_used(0), m_total(0), m_blockSize(block_size),
+      m_allocations(0), m_blockAllocations(0)
+{ }
+
+SnmpArena::~SnmpArena()
+{
+    while (m_blocks)
+    {
+        Block* const next = m_blocks->next;
+        free(m_blocks);
+        m_blocks = next;
+    }
+}
+
+void* SnmpArena::allocate_block(const size_t size)
+{
+    size_t const blockSize = (size > m_blockSize) ? size : m_blockSize;
+    Block* const block     = (Block*)malloc(sizeof(Block) + blockSize);
+    if (!block)
+    {
+        return nullptr;
+    }
+    ++m_blockAllocations;
+
+    block->next = m_blocks;
+    block->size = blockSize;
+    m_blocks    = block;
+    m_total += m_used;
+    m_used = size;
+
+    return block + 1;
+}
+
+void SnmpArena::reset()
+{
+    if (m_blocks && m_blocks->next)
+    {
+        // replace the blocks by one that fits everything
+        size_t const total = m_total + m_used;
+
+        while (m_blocks)
+        {
+            Block* const next = m_blocks->next;
+            free(m_blocks);
+            m_blocks = next;
+        }
+        if (total > m_blockSize)
+        {
+            m_blockSize = total;
+        }
+    }
+    m_used  = 0;
+    m_total = 0;
+}
+
+#ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#endif
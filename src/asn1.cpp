@@ -1110,17 +1110,239 @@ unsigned char* asn_build_unsigned_int64(unsigned char* data, int* datalength,
     return data;
 }
 
+/*
+ * Reverse encoding: The asn_rbuild_* functions write an object in front
+ * of "data", so an encoding is built from its last object to its first.
+ * The length of a constructed object is known when its header is
+ * written, so no temporary buffers and copies are needed.
+ *  On entry, datalength is input as the number of free bytes in front
+ *   of "data".  On exit, it is reduced by the length of the object.
+ *
+ *  Returns a pointer to the first byte of this object (i.e. the "data"
+ *   for the object in front of it).
+ *  Returns NULL on any error.
+ */
+
+/*
+ * asn_rbuild_length - builds the length field in front of the contents.
+ */
+unsigned char* asn_rbuild_length(
+    unsigned char* data, int* datalength, int length)
+{
+    if (length < 0x80)
+    {
+        if (*datalength < 1)
+        {
+            ASNERROR("rbuild_length");
+            return nullptr;
+        }
+        *--data = (unsigned char)length;
+        (*datalength)--;
+        return data;
+    }
+
+    int octets = 0;
+    for (uint32_t l = (uint32_t)length; l; l >>= 8) { octets++; }
+    if (*datalength < octets + 1)
+    {
+        ASNERROR("rbuild_length");
+        return nullptr;
+    }
+    for (uint32_t l = (uint32_t)length; l; l >>= 8)
+    {
+        *--data = (unsigned char)(l & 0xFF);
+    }
+    *--data = (unsigned char)(octets | ASN_LONG_LEN);
+    *datalength -= octets + 1;
+    return data;
+}
+
+/*
+ * asn_rbuild_header - builds an ASN header in front of the contents of
+ * an object with the ID and length specified.
+ *
+ *  This only works on data types < 30, i.e. no extension octets.
+ */
+unsigned char* asn_rbuild_header(
+    unsigned char* data, int* datalength, unsigned char type, int length)
+{
+    data = asn_rbuild_length(data, datalength, length);
+    if ((data == nullptr) || (*datalength < 1))
+    {
+        return nullptr;
+    }
+    *--data = type;
+    (*datalength)--;
+    return data;
+}
+
+/*
+ * asn_rbuild_int - builds an ASN object containing an integer.
+ *  The encoding is the same as of asn_build_int().
+ */
+unsigned char* asn_rbuild_int(unsigned char* data, int* datalength,
+    const unsigned char type, const SmiINT32 value)
+{
+    unsigned char* const end     = data;
+    int32_t              integer = value;
+
+    // write the least significant octets first, until the rest is only
+    // the sign extension of the last written octet
+    do {
+        if (*datalength < 1)
+        {
+            return nullptr;
+        }
+        *--data = (unsigned char)(integer & 0xFF);
+        (*datalength)--;
+        integer >>= 8; // arithmetic shift keeps the sign
+    } while (!(((integer == 0) && !(*data & 0x80))
+        || ((integer == -1) && (*data & 0x80))));
+
+    return asn_rbuild_header(
+        data, datalength, type, SAFE_INT_CAST(end - data));
+}
+
+/*
+ * asn_rbuild_unsigned_int64 - builds an ASN object containing an unsigned
+ * 64 bit integer, with a leading null byte if the MSB is set.
+ *  The encoding is the same as of asn_build_unsigned_int() and
+ *  asn_build_unsigned_int64().
+ */
+static unsigned char* asn_rbuild_uint64(unsigned char* data,
+    int* datalength, const unsigned char type, pp_uint64 value)
+{
+    unsigned char* const end = data;
+
+    do {
+        if (*datalength < 1)
+        {
+            return nullptr;
+        }
+        *--data = (unsigned char)(value & 0xFF);
+        (*datalength)--;
+        value >>= 8;
+    } while (value);
+
+    if (*data & 0x80)
+    {
+        if (*datalength < 1)
+        {
+            return nullptr;
+        }
+        *--data = 0;
+        (*datalength)--;
+    }
+    return asn_rbuild_header(
+        data, datalength, type, SAFE_INT_CAST(end - data));
+}
+
+unsigned char* asn_rbuild_unsigned_int(unsigned char* data, int* datalength,
+    const unsigned char type, const SmiUINT32 value)
+{
+    return asn_rbuild_uint64(data, datalength, type, value);
+}
+
+unsigned char* asn_rbuild_unsigned_int64(unsigned char* data,
+    int* datalength, const unsigned char type, const struct counter64* cp)
+{
+    return asn_rbuild_uint64(
+        data, datalength, type, ((pp_uint64)cp->high << 32) | cp->low);
+}
+
+/*
+ * asn_rbuild_string - builds an ASN octet string object.
+ */
+unsigned char* asn_rbuild_string(unsigned char* data, int* datalength,
+    const unsigned char type, const unsigned char* string, const int strlength)
+{
+    if ((strlength < 0) || (*datalength < strlength))
+    {
+        return nullptr;
+    }
+    data -= strlength;
+    if (strlength)
+    {
+        memcpy(data, string, strlength);
+    }
+    *datalength -= strlength;
+    return asn_rbuild_header(data, datalength, type, strlength);
+}
+
+/*
+ * asn_rbuild_objid - builds an ASN object identifier object.
+ *  The encoding is the same as of asn_build_objid().
+ */
+unsigned char* asn_rbuild_objid(unsigned char* data, int* datalength,
+    const unsigned char type, const oid_t* objid, int objidlength)
+{
+    unsigned char* const end = data;
+
+    if (objidlength > MAX_OID_LEN)
+    {
+        ASNERROR("Too many sub-identifiers.");
+        objidlength = MAX_OID_LEN;
+    }
+    if (objidlength < 2)
+    {
+        if (*datalength < 1)
+        {
+            return nullptr;
+        }
+        *--data = 0;
+        (*datalength)--;
+    }
+    else
+    {
+        for (int i = objidlength - 1; i >= 1; i--)
+        {
+            uint32_t subid = (i == 1) ? objid[1] + (objid[0] * 40) : objid[i];
+            unsigned char bit8 = 0; // set for all but the last octet
+
+            do {
+                if (*datalength < 1)
+                {
+                    return nullptr;
+                }
+                *--data = (unsigned char)((subid & 0x7F) | bit8);
+                (*datalength)--;
+                bit8 = ASN_BIT8;
+                subid >>= 7;
+            } while (subid);
+        }
+    }
+    return asn_rbuild_header(
+        data, datalength, type, SAFE_INT_CAST(end - data));
+}
+
+/*
+ * asn_rbuild_null - builds an ASN null object.
+ */
+unsigned char* asn_rbuild_null(
+    unsigned char* data, int* datalength, const unsigned char type)
+{
+    return asn_rbuild_header(data, datalength, type, 0);
+}
+
+// allocate memory for the content of a pdu
+static void* pdu_alloc(struct snmp_pdu* pdu, const size_t size)
+{
+    return pdu->arena ? pdu->arena->allocate(size) : malloc(size);
+}
+
 // create a pdu
-struct snmp_pdu* snmp_pdu_create(int command)
+struct snmp_pdu* snmp_pdu_create(int command, SnmpArena* arena)
 {
     struct snmp_pdu* pdu = nullptr;
 
-    pdu = (struct snmp_pdu*)malloc(sizeof(struct snmp_pdu));
+    pdu = (struct snmp_pdu*)(arena ? arena->allocate(sizeof(struct snmp_pdu))
+                                   : malloc(sizeof(struct snmp_pdu)));
     if (!pdu)
     {
         return pdu;
     }
     memset((char*)pdu, 0, sizeof(struct snmp_pdu));
+    pdu->arena   = arena;
     pdu->command = command;
 #ifdef _SNMPv3
     pdu->msgid = 0;
@@ -1138,6 +1360,11 @@ void clear_pdu(struct snmp_pdu* pdu, bool clear_all)
 {
     struct variable_list* vp = pdu->variables;
 
+    // memory of an arena is freed when the arena is reset
+    if (pdu->arena)
+    {
+        vp = nullptr;
+    }
     while (vp)
     {
         if (vp->name)
@@ -1155,7 +1382,7 @@ void clear_pdu(struct snmp_pdu* pdu, bool clear_all)
     pdu->variables = nullptr;
 
     // if enterprise free it up
-    if (pdu->enterprise)
+    if (pdu->enterprise && !pdu->arena)
     {
         free((char*)pdu->enterprise);
     }
@@ -1185,7 +1412,10 @@ void clear_pdu(struct snmp_pdu* pdu, bool clear_all)
 void snmp_free_pdu(struct snmp_pdu* pdu)
 {
     clear_pdu(pdu); // clear and free content
-    free(pdu);      // free up pdu itself
+    if (!pdu->arena)
+    {
+        free(pdu); // free up pdu itself
+    }
 }
 
 // add a null var to a pdu
@@ -1197,8 +1427,8 @@ void snmp_add_var(
     // if we don't have a vb list ,create one
     if (pdu->variables == nullptr)
     {
-        pdu->variables = vars =
-            (struct variable_list*)malloc(sizeof(struct variable_list));
+        pdu->variables = vars = (struct variable_list*)pdu_alloc(
+            pdu, sizeof(struct variable_list));
         assert(vars != nullptr);
     }
     else
@@ -1208,8 +1438,8 @@ void snmp_add_var(
         while (vars->next_variable) { vars = vars->next_variable; }
 
         // create a new one
-        vars->next_variable =
-            (struct variable_list*)malloc(sizeof(struct variable_list));
+        vars->next_variable = (struct variable_list*)pdu_alloc(
+            pdu, sizeof(struct variable_list));
         assert(vars->next_variable != nullptr);
 
         vars = vars->next_variable;
@@ -1219,7 +1449,7 @@ void snmp_add_var(
     vars->next_variable = nullptr;
 
     // hook in the Oid portion
-    vars->name = (oid_t*)malloc(name_length * sizeof(oid_t));
+    vars->name = (oid_t*)pdu_alloc(pdu, name_length * sizeof(oid_t));
     assert(vars->name != nullptr);
 
     memcpy((char*)vars->name, (char*)name, name_length * sizeof(oid_t));
@@ -1244,8 +1474,8 @@ void snmp_add_var(
     case sNMP_SYNTAX_OPAQUE:
     case sNMP_SYNTAX_IPADDR: {
         vars->type = (unsigned char)smival->syntax;
-        vars->val.string =
-            (unsigned char*)malloc((unsigned)smival->value.string.len);
+        vars->val.string = (unsigned char*)pdu_alloc(
+            pdu, (unsigned)smival->value.string.len);
         vars->val_len = (int)smival->value.string.len;
         memcpy((unsigned char*)vars->val.string,
             (unsigned char*)smival->value.string.ptr,
@@ -1257,7 +1487,8 @@ void snmp_add_var(
     case sNMP_SYNTAX_OID: {
         vars->type      = (unsigned char)smival->syntax;
         vars->val_len   = (int)smival->value.oid.len * sizeof(oid_t);
-        vars->val.objid = (oid_t*)malloc((unsigned)vars->val_len);
+        vars->val.objid =
+            (oid_t*)pdu_alloc(pdu, (unsigned)vars->val_len);
         memcpy((uint32_t*)vars->val.objid, (uint32_t*)smival->value.oid.ptr,
             (unsigned)vars->val_len);
     }
@@ -1270,7 +1501,7 @@ void snmp_add_var(
         {
             SmiINT32 templong = 0;
             vars->type        = (unsigned char)smival->syntax;
-            vars->val.integer = (SmiINT32*)malloc(sizeof(SmiINT32));
+            vars->val.integer = (SmiINT32*)pdu_alloc(pdu, sizeof(SmiINT32));
             vars->val_len     = sizeof(SmiINT32);
             templong          = (SmiINT32)smival->value.uNumber;
             memcpy((SmiINT32*)vars->val.integer, (SmiINT32*)&templong,
@@ -1281,7 +1512,7 @@ void snmp_add_var(
     case sNMP_SYNTAX_INT32: {
         SmiINT32 templong = 0;
         vars->type        = (unsigned char)smival->syntax;
-        vars->val.integer = (SmiINT32*)malloc(sizeof(SmiINT32));
+        vars->val.integer = (SmiINT32*)pdu_alloc(pdu, sizeof(SmiINT32));
         vars->val_len     = sizeof(SmiINT32);
         templong          = (SmiINT32)smival->value.sNumber;
         memcpy((SmiINT32*)vars->val.integer, (SmiINT32*)&templong,
@@ -1293,7 +1524,7 @@ void snmp_add_var(
     case sNMP_SYNTAX_CNTR64: {
         vars->type = (unsigned char)smival->syntax;
         vars->val.counter64 =
-            (struct counter64*)malloc(sizeof(struct counter64));
+            (struct counter64*)pdu_alloc(pdu, sizeof(struct counter64));
         vars->val_len = sizeof(struct counter64);
         memcpy((struct counter64*)vars->val.counter64,
             (SmiLPCNTR64) & (smival->value.hNumber), sizeof(SmiCNTR64));
@@ -1302,38 +1533,6 @@ void snmp_add_var(
     } // end switch
 }
 
-// build the authentication, works for v1 or v2c
-static unsigned char* snmp_auth_build(unsigned char* data, int* length,
-    const SmiINT32 version, const unsigned char* community,
-    const int community_len, const int messagelen)
-{
-    // 5 is 3 octets for version and 2 for community header + len
-    // This assumes that community will not be longer than 0x7f chars.
-    data = asn_build_sequence(
-        data, length, ASN_SEQ_CON, messagelen + community_len + 5);
-    if (data == nullptr)
-    {
-        ASNERROR("buildheader");
-        return nullptr;
-    }
-    data = asn_build_int(data, length, ASN_UNI_PRIM | ASN_INTEGER, &version);
-    if (data == nullptr)
-    {
-        ASNERROR("buildint");
-        return nullptr;
-    }
-
-    data = asn_build_string(
-        data, length, ASN_UNI_PRIM | ASN_OCTET_STR, community, community_len);
-    if (data == nullptr)
-    {
-        ASNERROR("buildstring");
-        return nullptr;
-    }
-
-    return data;
-}
-
 // build a variable binding
 unsigned char* snmp_build_var_op(unsigned char* data, oid_t* var_name,
     int* var_name_len, unsigned char var_val_type, int var_val_len,
@@ -1597,58 +1796,251 @@ unsigned char* build_data_pdu(struct snmp_pdu* pdu, unsigned char* buf,
     return cp + totallength;
 }
 
-// serialize the pdu
-int snmp_build(struct snmp_pdu* pdu, unsigned char* packet, int* out_length,
-    const snmp_version version, const unsigned char* community,
-    const int community_len)
+// build a variable binding in front of data, see asn_rbuild_length()
+unsigned char* snmp_rbuild_var_op(unsigned char* data, int* datalength,
+    const struct variable_list* vp)
 {
-    Buffer<unsigned char> buf(MAX_SNMP_PACKET);
-    unsigned char*        cp          = nullptr;
-    int                   length      = 0;
-    int                   totallength = 0;
+    unsigned char* const end = data;
 
-    // encode vbs with header into packet
-    length = *out_length;
-    cp     = build_vb(pdu, packet, &length);
-    if (cp == nullptr)
+    // based on the type...
+    switch (vp->type)
     {
-        return -1;
+    case ASN_INTEGER: {
+        if (vp->val_len != sizeof(SmiINT32))
+        {
+            ASNERROR("rbuild_var_op: Illegal size of integer");
+            return nullptr;
+        }
+        data = asn_rbuild_int(data, datalength, vp->type, *vp->val.integer);
+        break;
     }
-    totallength = SAFE_INT_CAST(cp - packet);
-    if (totallength >= *out_length)
+
+    case SMI_GAUGE:
+    case SMI_COUNTER:
+    case SMI_TIMETICKS:
+    case SMI_UINTEGER: {
+        if (vp->val_len != sizeof(SmiUINT32))
+        {
+            ASNERROR("rbuild_var_op: Illegal size of unsigned integer");
+            return nullptr;
+        }
+        data = asn_rbuild_unsigned_int(
+            data, datalength, vp->type, *(SmiUINT32*)vp->val.integer);
+        break;
+    }
+
+    case SMI_COUNTER64: {
+        if (vp->val_len != sizeof(counter64))
+        {
+            ASNERROR("rbuild_var_op: Illegal size of counter64");
+            return nullptr;
+        }
+        data = asn_rbuild_unsigned_int64(
+            data, datalength, vp->type, vp->val.counter64);
+        break;
+    }
+
+    case ASN_OCTET_STR:
+    case SMI_IPADDRESS:
+    case SMI_OPAQUE:
+    case SMI_NSAP: {
+        data = asn_rbuild_string(
+            data, datalength, vp->type, vp->val.string, vp->val_len);
+        break;
+    }
+
+    case ASN_OBJECT_ID: {
+        data = asn_rbuild_objid(data, datalength, vp->type, vp->val.objid,
+            vp->val_len / sizeof(oid_t));
+        break;
+    }
+
+    case ASN_BIT_STR: {
+        if ((vp->val_len < 1) || (*vp->val.bitstring > 7))
+        {
+            ASNERROR("Building invalid bitstring");
+            return nullptr;
+        }
+        data = asn_rbuild_string(
+            data, datalength, vp->type, vp->val.bitstring, vp->val_len);
+        break;
+    }
+
+    case ASN_NULL:
+    case SNMP_NOSUCHOBJECT:
+    case SNMP_NOSUCHINSTANCE:
+    case SNMP_ENDOFMIBVIEW: {
+        data = asn_rbuild_null(data, datalength, vp->type);
+        break;
+    }
+
+    default: {
+        ASNERROR("rbuild_var_op: wrong type");
+        return nullptr;
+    }
+    }
+    if (data == nullptr)
     {
-        return -1;
+        ASNERROR("rbuild_var_op: value build failed");
+        return nullptr;
     }
 
-    // encode datadpu into buf
-    length = MAX_SNMP_PACKET;
-    cp     = build_data_pdu(pdu, buf.get_ptr(), &length, packet, totallength);
-    if (cp == nullptr)
+    data = asn_rbuild_objid(data, datalength, ASN_UNI_PRIM | ASN_OBJECT_ID,
+        vp->name, vp->name_length);
+    if (data == nullptr)
     {
-        return -1;
+        ASNERROR("rbuild_var_op: build_objid failed");
+        return nullptr;
     }
-    totallength = SAFE_INT_CAST(cp - buf.get_ptr());
-    if (totallength >= *out_length)
+
+    return asn_rbuild_header(
+        data, datalength, ASN_SEQ_CON, SAFE_INT_CAST(end - data));
+}
+
+unsigned char* rbuild_vb(
+    struct snmp_pdu* pdu, unsigned char* data, int* datalength)
+{
+    unsigned char* const   end   = data;
+    struct variable_list*  vp    = nullptr;
+    int                    count = 0;
+    struct variable_list*  local_vars[32];
+    struct variable_list** vars = local_vars;
+
+    // the list is single linked, but has to be encoded backwards
+    for (vp = pdu->variables; vp; vp = vp->next_variable) { count++; }
+    if (count > 32)
     {
-        return -1;
+        vars = new struct variable_list*[count];
+    }
+    count = 0;
+    for (vp = pdu->variables; vp; vp = vp->next_variable)
+    {
+        vars[count++] = vp;
     }
 
-    // build SNMP header
-    length = *out_length;
-    cp     = snmp_auth_build(
-        packet, &length, version, community, community_len, totallength);
-    if (cp == nullptr)
+    while (data && (count-- > 0))
     {
-        return -1;
+        data = snmp_rbuild_var_op(data, datalength, vars[count]);
+    }
+    if (vars != local_vars)
+    {
+        delete[] vars;
+    }
+    if (data == nullptr)
+    {
+        return nullptr;
+    }
+
+    return asn_rbuild_header(
+        data, datalength, ASN_SEQ_CON, SAFE_INT_CAST(end - data));
+}
+
+unsigned char* rbuild_data_pdu(
+    struct snmp_pdu* pdu, unsigned char* data, int* datalength)
+{
+    unsigned char* const end = data;
+
+    data = rbuild_vb(pdu, data, datalength);
+    if (data == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (pdu->command != TRP_REQ_MSG)
+    {
+        // error index, error status, request id
+        data = asn_rbuild_int(
+            data, datalength, ASN_UNI_PRIM | ASN_INTEGER, pdu->errindex);
+        if (data)
+        {
+            data = asn_rbuild_int(
+                data, datalength, ASN_UNI_PRIM | ASN_INTEGER, pdu->errstat);
+        }
+        if (data)
+        {
+            data = asn_rbuild_int(
+                data, datalength, ASN_UNI_PRIM | ASN_INTEGER, pdu->reqid);
+        }
     }
-    if ((*out_length - (cp - packet)) < totallength)
+    else
+    { // this is a trap message
+        // timestamp
+        data = asn_rbuild_unsigned_int(
+            data, datalength, SMI_TIMETICKS, pdu->time);
+
+        // specific trap
+        if (data)
+        {
+            data = asn_rbuild_int(data, datalength,
+                ASN_UNI_PRIM | ASN_INTEGER, pdu->specific_type);
+        }
+
+        // generic trap
+        if (data)
+        {
+            data = asn_rbuild_int(
+                data, datalength, ASN_UNI_PRIM | ASN_INTEGER, pdu->trap_type);
+        }
+
+        // agent-addr ; must be IPADDRESS
+        if (data)
+        {
+            data = asn_rbuild_string(data, datalength, SMI_IPADDRESS,
+                (unsigned char*)&pdu->agent_addr.sin_addr.s_addr,
+                sizeof(pdu->agent_addr.sin_addr.s_addr));
+        }
+
+        // enterprise
+        if (data)
+        {
+            data = asn_rbuild_objid(data, datalength,
+                ASN_UNI_PRIM | ASN_OBJECT_ID, (oid_t*)pdu->enterprise,
+                pdu->enterprise_length);
+        }
+    }
+    if (data == nullptr)
+    {
+        return nullptr;
+    }
+
+    return asn_rbuild_header(data, datalength, (unsigned char)pdu->command,
+        SAFE_INT_CAST(end - data));
+}
+
+// serialize the pdu
+int snmp_build(struct snmp_pdu* pdu, unsigned char* packet, int* out_length,
+    const snmp_version version, const unsigned char* community,
+    const int community_len)
+{
+    // encode backwards from the end of the packet
+    int            length = *out_length;
+    unsigned char* end    = packet + length;
+    unsigned char* cp     = rbuild_data_pdu(pdu, end, &length);
+
+    // community and version
+    if (cp)
+    {
+        cp = asn_rbuild_string(cp, &length, ASN_UNI_PRIM | ASN_OCTET_STR,
+            community, community_len);
+    }
+    if (cp)
+    {
+        cp = asn_rbuild_int(
+            cp, &length, ASN_UNI_PRIM | ASN_INTEGER, (SmiINT32)version);
+    }
+    if (cp)
+    {
+        cp = asn_rbuild_header(
+            cp, &length, ASN_SEQ_CON, SAFE_INT_CAST(end - cp));
+    }
+    if (cp == nullptr)
     {
         return -1;
     }
 
-    // copy data
-    memcpy(cp, buf.get_ptr(), totallength);
-    totallength += SAFE_INT_CAST(cp - packet);
+    // move the message to the start of the packet
+    int const totallength = SAFE_INT_CAST(end - cp);
+    memmove(packet, cp, totallength);
     *out_length = totallength;
 
     return 0;
@@ -1771,13 +2163,13 @@ int snmp_parse_vb(struct snmp_pdu* pdu, unsigned char*& data, int& data_len)
     {
         if (pdu->variables == nullptr)
         {
-            pdu->variables = vp =
-                (struct variable_list*)malloc(sizeof(struct variable_list));
+            pdu->variables = vp = (struct variable_list*)pdu_alloc(
+                pdu, sizeof(struct variable_list));
         }
         else
         {
-            vp->next_variable =
-                (struct variable_list*)malloc(sizeof(struct variable_list));
+            vp->next_variable = (struct variable_list*)pdu_alloc(
+                pdu, sizeof(struct variable_list));
             assert(vp->next_variable != nullptr);
 
             vp = vp->next_variable;
@@ -1792,16 +2184,17 @@ int snmp_parse_vb(struct snmp_pdu* pdu, unsigned char*& data, int& data_len)
         {
             return SNMP_CLASS_ASN1ERROR;
         }
-        op = (oid_t*)malloc((unsigned)vp->name_length * sizeof(oid_t));
+        op = (oid_t*)pdu_alloc(
+            pdu, (unsigned)vp->name_length * sizeof(oid_t));
 
         memcpy((char*)op, (char*)objid, vp->name_length * sizeof(oid_t));
         vp->name = op;
 
-        len = MAX_SNMP_PACKET;
+        len = SNMP_PP_MAX_MESSAGE_SIZE;
         switch ((short)vp->type)
         {
         case ASN_INTEGER: {
-            vp->val.integer = (SmiINT32*)malloc(sizeof(SmiINT32));
+            vp->val.integer = (SmiINT32*)pdu_alloc(pdu, sizeof(SmiINT32));
             vp->val_len     = sizeof(SmiINT32);
             asn_parse_int(var_val, &len, &vp->type, vp->val.integer);
             break;
@@ -1811,7 +2204,7 @@ int snmp_parse_vb(struct snmp_pdu* pdu, unsigned char*& data, int& data_len)
         case SMI_GAUGE:
         case SMI_TIMETICKS:
         case SMI_UINTEGER: {
-            vp->val.integer = (SmiINT32*)malloc(sizeof(SmiINT32));
+            vp->val.integer = (SmiINT32*)pdu_alloc(pdu, sizeof(SmiINT32));
             vp->val_len     = sizeof(SmiINT32);
             asn_parse_unsigned_int(var_val, &len, &vp->type, vp->val.integer);
             break;
@@ -1819,7 +2212,7 @@ int snmp_parse_vb(struct snmp_pdu* pdu, unsigned char*& data, int& data_len)
 
         case SMI_COUNTER64: {
             vp->val.counter64 =
-                (struct counter64*)malloc(sizeof(struct counter64));
+                (struct counter64*)pdu_alloc(pdu, sizeof(struct counter64));
             vp->val_len = sizeof(struct counter64);
             asn_parse_unsigned_int64(
                 var_val, &len, &vp->type, vp->val.counter64);
@@ -1830,7 +2223,8 @@ int snmp_parse_vb(struct snmp_pdu* pdu, unsigned char*& data, int& data_len)
         case SMI_IPADDRESS:
         case SMI_OPAQUE:
         case SMI_NSAP: {
-            vp->val.string = (unsigned char*)malloc((unsigned)vp->val_len);
+            vp->val.string =
+                (unsigned char*)pdu_alloc(pdu, (unsigned)vp->val_len);
             asn_parse_string(
                 var_val, &len, &vp->type, vp->val.string, &vp->val_len);
             break;
@@ -1840,8 +2234,8 @@ int snmp_parse_vb(struct snmp_pdu* pdu, unsigned char*& data, int& data_len)
             vp->val_len = ASN_MAX_NAME_LEN;
             asn_parse_objid(var_val, &len, &vp->type, objid, &vp->val_len);
             // vp->val_len *= sizeof(oid_t);
-            vp->val.objid =
-                (oid_t*)malloc((unsigned)vp->val_len * sizeof(oid_t));
+            vp->val.objid = (oid_t*)pdu_alloc(
+                pdu, (unsigned)vp->val_len * sizeof(oid_t));
 
             memcpy((char*)vp->val.objid, (char*)objid,
                 vp->val_len * sizeof(oid_t));
@@ -1910,8 +2304,8 @@ int snmp_parse_data_pdu(snmp_pdu* pdu, unsigned char*& data, int& length)
             return SNMP_CLASS_ASN1ERROR;
         }
 
-        pdu->enterprise =
-            (oid_t*)malloc(pdu->enterprise_length * sizeof(oid_t));
+        pdu->enterprise = (oid_t*)pdu_alloc(
+            pdu, pdu->enterprise_length * sizeof(oid_t));
 
         memcpy((char*)pdu->enterprise, (char*)objid,
             pdu->enterprise_length * sizeof(oid_t));
@@ -2253,6 +2647,54 @@ unsigned char* asn1_build_scoped_pdu(unsigned char* outBuf, int* max_len,
     return outBufPtr;
 }
 
+// Encode the scopedPDU in front of the already encoded data.
+unsigned char* asn1_rbuild_scoped_pdu(unsigned char* data, int* datalength,
+    const unsigned char* contextEngineID, long contextEngineIDLength,
+    const unsigned char* contextName, long contextNameLength, long dataLength)
+{
+    unsigned char* const end = data + dataLength;
+
+    LOG_BEGIN(loggerModuleName, DEBUG_LOG | 10);
+    LOG("ASN1: coding (context engine id) (context name)");
+    LOG(OctetStr(contextEngineID, contextEngineIDLength).get_printable());
+    LOG(OctetStr(contextName, contextNameLength).get_printable());
+    LOG_END;
+
+    data = asn_rbuild_string(data, datalength, ASN_UNI_PRIM | ASN_OCTET_STR,
+        contextName, (int)contextNameLength);
+    if (!data)
+    {
+        LOG_BEGIN(loggerModuleName, ERROR_LOG | 1);
+        LOG("ASN1: Error encoding contextName");
+        LOG_END;
+
+        return nullptr;
+    }
+
+    data = asn_rbuild_string(data, datalength, ASN_UNI_PRIM | ASN_OCTET_STR,
+        contextEngineID, (int)contextEngineIDLength);
+    if (!data)
+    {
+        LOG_BEGIN(loggerModuleName, ERROR_LOG | 1);
+        LOG("ASN1: Error encoding contextEngineID");
+        LOG_END;
+
+        return nullptr;
+    }
+
+    data = asn_rbuild_header(
+        data, datalength, ASN_SEQ_CON, SAFE_INT_CAST(end - data));
+    if (!data)
+    {
+        LOG_BEGIN(loggerModuleName, ERROR_LOG | 1);
+        LOG("ASN1: Error encoding scopedPDU sequence");
+        LOG_END;
+
+        return nullptr;
+    }
+    return data;
+}
+
 #ifdef SNMP_PP_NAMESPACE
 } // end of namespace Snmp_pp
 #endif
@@ -67,7 +67,14 @@
 #    include "snmp_pp/snmperrs.h"
 #    include "snmp_pp/v3.h"
 
+#    include <algorithm>
 #    include <memory>
+#    include <vector>
+
+#    ifdef _THREADS
+#        include <atomic>
+#        include <thread>
+#    endif
 
 #    ifdef SNMP_PP_NAMESPACE
 namespace Snmp_pp
@@ -167,6 +174,7 @@ typedef DES_key_schedule DESCBCType;
 #        define DES_CBC_DECRYPT(ct, pt, s, iv, l) \
             DES_ncbc_encrypt(                     \
                 ct, pt, l, &(s), (const_DES_cblock*)(iv), DES_DECRYPT)
+#        define DES_CBC_SET_IV(iv, s) // the IV is passed to each call
 
 #        define DES_EDE3_CBC_ENCRYPT(pt, ct, l, k1, k2, k3, iv)  \
             DES_ede3_cbc_encrypt(pt, ct, l, &(k1), &(k2), &(k3), \
@@ -222,6 +230,12 @@ typedef symmetric_CBC DESCBCType;
                     debugprintf(0, "Error during DES decryption."); \
                     return SNMPv3_USM_ERROR;                        \
                 }
+#            define DES_CBC_SET_IV(iv, s)                           \
+                if (cbc_setiv(iv, 8, &(s)) != CRYPT_OK)             \
+                {                                                   \
+                    debugprintf(0, "Setting the DES IV failed.");   \
+                    return SNMPv3_USM_ERROR;                        \
+                }
 #            define DES_MEMSET(s, c, l) memset(&(s), c, l)
 /* -- END: Defines for LibTomCrypt -- */
 
@@ -262,6 +276,8 @@ typedef DES_CBC_CTX DESCBCType;
                     DES_CBCUpdate(&(s), pt, ct, l)
 #                define DES_CBC_DECRYPT(ct, pt, s, iv, l) \
                     DES_CBCUpdate(&(s), (unsigned char*)(ct), pt, l)
+// no key contexts with RSAEURO, as DES_CBC_CTX keeps the IV of the key
+#                define DES_CBC_SET_IV(iv, s)
 #                define DES_MEMSET(s, c, l) R_memset((POINTER) & (s), c, l)
 
 #            else // RSAEURO
@@ -286,6 +302,7 @@ typedef des_key_schedule DESCBCType;
 #                define DES_CBC_DECRYPT(ct, pt, s, iv, l)                  \
                     des_ncbc_encrypt((C_Block*)(ct), (C_Block*)(pt), l, s, \
                         (C_Block*)(iv), DES_DECRYPT)
+#                define DES_CBC_SET_IV(iv, s) // the IV is passed to each call
 #                define DES_MEMSET(s, c, l) memset(&(s), c, l)
 
 /* -- END: Defines for libdes -- */
@@ -362,8 +379,243 @@ int des3_extend_short_key(const unsigned char* /* password */,
     return res;
 }
 
-AuthPriv::AuthPriv(int& construct_state)
+/*-----------------[ keyed HMAC states ]------------------*/
+
+// Largest block size of the supported hash functions (SHA-512)
+#    define HMAC_MAX_BLOCK_SIZE 128
+
+// Fill the inner and outer pads of HMAC with the key
+static void hmac_pads(const unsigned char* key, const unsigned int key_len,
+    const unsigned int block_size, unsigned char* k_ipad,
+    unsigned char* k_opad)
+{
+    memset(k_ipad, 0x36, block_size);
+    memset(k_opad, 0x5c, block_size);
+
+    for (unsigned int i = 0; i < key_len; ++i)
+    {
+        k_ipad[i] ^= key[i];
+        k_opad[i] ^= key[i];
+    }
+}
+
+#    ifdef _USE_OPENSSL
+
+// The hash function of OpenSSL used by the given auth protocol
+static const EVP_MD* evp_md_for_auth(const int auth_prot)
+{
+    switch (auth_prot)
+    {
+    case SNMP_AUTHPROTOCOL_HMACMD5: return EVP_md5();
+    case SNMP_AUTHPROTOCOL_HMACSHA: return EVP_sha1();
+    case SNMP_AUTHPROTOCOL_HMAC128SHA224: return EVP_sha224();
+    case SNMP_AUTHPROTOCOL_HMAC192SHA256: return EVP_sha256();
+    case SNMP_AUTHPROTOCOL_HMAC256SHA384: return EVP_sha384();
+    case SNMP_AUTHPROTOCOL_HMAC384SHA512: return EVP_sha512();
+    default: return nullptr;
+    }
+}
+
+// Digest context of the calling thread, reused for all messages
+static EVP_MD_CTX* evp_work_ctx()
+{
+    struct WorkCtx {
+        WorkCtx() : ctx(EVP_MD_CTX_create()) { }
+
+        ~WorkCtx() { EVP_MD_CTX_destroy(ctx); }
+
+        EVP_MD_CTX* ctx;
+    };
+    static thread_local WorkCtx work;
+
+    return work.ctx;
+}
+
+class EVPHMACContext : public AuthHMACContext {
+public:
+    EVPHMACContext(const int prot)
+        : AuthHMACContext(prot), inner(EVP_MD_CTX_create()),
+          outer(EVP_MD_CTX_create())
+    { }
+
+    ~EVPHMACContext() override
+    {
+        EVP_MD_CTX_destroy(inner);
+        EVP_MD_CTX_destroy(outer);
+    }
+
+    // Hash the inner and the outer pad, false on errors
+    bool init(const EVP_MD* md, const unsigned char* key,
+        const unsigned int key_len)
+    {
+        int const block_size = EVP_MD_block_size(md);
+
+        if (!inner || !outer || (block_size > HMAC_MAX_BLOCK_SIZE)
+            || (key_len > (unsigned int)block_size))
+        {
+            return false;
+        }
+
+        unsigned char k_ipad[HMAC_MAX_BLOCK_SIZE];
+        unsigned char k_opad[HMAC_MAX_BLOCK_SIZE];
+
+        hmac_pads(key, key_len, block_size, k_ipad, k_opad);
+
+        bool const ok = EVP_DigestInit_ex(inner, md, nullptr)
+            && EVP_DigestUpdate(inner, k_ipad, block_size)
+            && EVP_DigestInit_ex(outer, md, nullptr)
+            && EVP_DigestUpdate(outer, k_opad, block_size);
+
+        memset(k_ipad, 0, sizeof(k_ipad));
+        memset(k_opad, 0, sizeof(k_opad));
+        return ok;
+    }
+
+    int hmac(const unsigned char* msg, const int msg_len,
+        unsigned char* digest) const override
+    {
+        EVP_MD_CTX* const work = evp_work_ctx();
+        unsigned int      len  = 0;
+
+        if (!work || !EVP_MD_CTX_copy_ex(work, inner)
+            || !EVP_DigestUpdate(work, msg, msg_len)
+            || !EVP_DigestFinal_ex(work, digest, &len)
+            || !EVP_MD_CTX_copy_ex(work, outer)
+            || !EVP_DigestUpdate(work, digest, len)
+            || !EVP_DigestFinal_ex(work, digest, &len))
+        {
+            return SNMPv3_USM_ERROR;
+        }
+        return SNMPv3_USM_OK;
+    }
+
+private:
+    EVP_MD_CTX* inner; ///< state after the inner pad
+    EVP_MD_CTX* outer; ///< state after the outer pad
+};
+
+static AuthHMACContext* new_hmac_context(const int auth_prot,
+    const unsigned char* key, const unsigned int key_len)
+{
+    const EVP_MD* md = evp_md_for_auth(auth_prot);
+
+    if (!md)
+    {
+        return nullptr;
+    }
+
+    auto* ctx = new EVPHMACContext(auth_prot);
+
+    if (!ctx->init(md, key, key_len))
+    {
+        delete ctx;
+        return nullptr;
+    }
+    return ctx;
+}
+
+#    else // _USE_OPENSSL
+
+// The hash states of the other crypto libraries are plain structures
+class MD5HMACContext : public AuthHMACContext {
+public:
+    MD5HMACContext(const unsigned char* key, const unsigned int key_len)
+        : AuthHMACContext(SNMP_AUTHPROTOCOL_HMACMD5), inner {}, outer {}
+    {
+        unsigned char k_ipad[64];
+        unsigned char k_opad[64];
+
+        hmac_pads(key, key_len, 64, k_ipad, k_opad);
+        MD5_INIT(&inner);
+        MD5_PROCESS(&inner, k_ipad, 64);
+        MD5_INIT(&outer);
+        MD5_PROCESS(&outer, k_opad, 64);
+        memset(k_ipad, 0, sizeof(k_ipad));
+        memset(k_opad, 0, sizeof(k_opad));
+    }
+
+    int hmac(const unsigned char* msg, const int msg_len,
+        unsigned char* digest) const override
+    {
+        MD5HashStateType state = inner;
+
+        MD5_PROCESS(&state, msg, msg_len);
+        MD5_DONE(&state, digest);
+        state = outer;
+        MD5_PROCESS(&state, digest, 16);
+        MD5_DONE(&state, digest);
+
+        return SNMPv3_USM_OK;
+    }
+
+private:
+    MD5HashStateType inner; ///< state after the inner pad
+    MD5HashStateType outer; ///< state after the outer pad
+};
+
+class SHA1HMACContext : public AuthHMACContext {
+public:
+    SHA1HMACContext(const unsigned char* key, const unsigned int key_len)
+        : AuthHMACContext(SNMP_AUTHPROTOCOL_HMACSHA), inner {}, outer {}
+    {
+        unsigned char k_ipad[64];
+        unsigned char k_opad[64];
+
+        hmac_pads(key, key_len, 64, k_ipad, k_opad);
+        SHA1_INIT(&inner);
+        SHA1_PROCESS(&inner, k_ipad, 64);
+        SHA1_INIT(&outer);
+        SHA1_PROCESS(&outer, k_opad, 64);
+        memset(k_ipad, 0, sizeof(k_ipad));
+        memset(k_opad, 0, sizeof(k_opad));
+    }
+
+    int hmac(const unsigned char* msg, const int msg_len,
+        unsigned char* digest) const override
+    {
+        SHAHashStateType state = inner;
+
+        SHA1_PROCESS(&state, msg, msg_len);
+        SHA1_DONE(&state, digest);
+        state = outer;
+        SHA1_PROCESS(&state, digest, 20);
+        SHA1_DONE(&state, digest);
+
+        return SNMPv3_USM_OK;
+    }
+
+private:
+    SHAHashStateType inner; ///< state after the inner pad
+    SHAHashStateType outer; ///< state after the outer pad
+};
+
+static AuthHMACContext* new_hmac_context(const int auth_prot,
+    const unsigned char* key, const unsigned int key_len)
+{
+    if (key_len > 64)
+    {
+        return nullptr;
+    }
+    switch (auth_prot)
+    {
+    case SNMP_AUTHPROTOCOL_HMACMD5: return new MD5HMACContext(key, key_len);
+    case SNMP_AUTHPROTOCOL_HMACSHA: return new SHA1HMACContext(key, key_len);
+    default: return nullptr;
+    }
+}
+
+#    endif // _USE_OPENSSL
+
+AuthPriv::AuthPriv(int& construct_state) : ku_cache_next(0)
 {
+    for (int k = 0; k < SNMP_PP_KU_CACHE_SIZE; k++)
+    {
+        ku_cache[k].auth_prot    = 0;
+        ku_cache[k].password     = nullptr;
+        ku_cache[k].password_len = 0;
+        ku_cache[k].ku_len       = 0;
+    }
+
     auth = new AuthPtr[10];
     priv = new PrivPtr[10];
 
@@ -473,6 +725,8 @@ AuthPriv::AuthPriv(int& construct_state)
 
 AuthPriv::~AuthPriv()
 {
+    clear_key_cache();
+
     for (int i = 0; i < auth_size; i++)
     {
         if (auth[i])
@@ -540,6 +794,7 @@ int AuthPriv::add_auth(Auth* new_auth)
         LOG_END;
 
         delete auth[id];
+        clear_key_cache();
     }
 
     auth[id] = new_auth;
@@ -566,6 +821,7 @@ int AuthPriv::del_auth(const int auth_id)
 
     delete auth[auth_id];
     auth[auth_id] = nullptr;
+    clear_key_cache();
 
     LOG_BEGIN(loggerModuleName, INFO_LOG | 6);
     LOG("AuthPriv: Removed auth protocol (id)");
@@ -812,12 +1068,98 @@ int AuthPriv::password_to_key_auth(const int auth_prot,
         return SNMPv3_USM_UNSUPPORTED_AUTHPROTOCOL;
     }
 
-    int const res = a->password_to_key(
-        password, password_len, engine_id, engine_id_len, key, key_len);
+    unsigned char ku[SNMPv3_USM_MAX_KEY_LEN];
+    unsigned int  ku_len = SNMPv3_USM_MAX_KEY_LEN;
+
+    if (get_ku(a, password, password_len, ku, &ku_len) != SNMPv3_USM_OK)
+    {
+        // the protocol does not support generating the key in two steps
+        return a->password_to_key(
+            password, password_len, engine_id, engine_id_len, key, key_len);
+    }
+
+    int const res =
+        a->localize_key(ku, ku_len, engine_id, engine_id_len, key, key_len);
 
+    memset(ku, 0, sizeof(ku));
     return res;
 }
 
+int AuthPriv::get_ku(Auth* a, const unsigned char* password,
+    const unsigned int password_len, unsigned char* ku, unsigned int* ku_len)
+{
+    int const auth_prot = a->get_id();
+
+    ku_cache_lock.lock();
+    for (int i = 0; i < SNMP_PP_KU_CACHE_SIZE; i++)
+    {
+        KuCacheEntry const& e = ku_cache[i];
+
+        if ((e.auth_prot == auth_prot) && (e.password_len == password_len)
+            && (e.ku_len <= *ku_len)
+            && !memcmp(e.password, password, password_len))
+        {
+            memcpy(ku, e.ku, e.ku_len);
+            *ku_len = e.ku_len;
+            ku_cache_lock.unlock();
+            return SNMPv3_USM_OK;
+        }
+    }
+    ku_cache_lock.unlock();
+
+    // the 1 MB expansion of the password is done without the lock
+    int const res = a->password_to_ku(password, password_len, ku, ku_len);
+
+    if ((res != SNMPv3_USM_OK) || (*ku_len > SNMPv3_USM_MAX_KEY_LEN))
+    {
+        return SNMPv3_USM_ERROR;
+    }
+
+    auto* copy = new unsigned char[password_len];
+    memcpy(copy, password, password_len);
+
+    ku_cache_lock.lock();
+    KuCacheEntry& e = ku_cache[ku_cache_next];
+
+    if (e.password)
+    {
+        memset(e.password, 0, e.password_len);
+        delete[] e.password;
+    }
+    e.auth_prot    = auth_prot;
+    e.password     = copy;
+    e.password_len = password_len;
+    e.ku_len       = *ku_len;
+    memcpy(e.ku, ku, *ku_len);
+
+    ku_cache_next = (ku_cache_next + 1) % SNMP_PP_KU_CACHE_SIZE;
+    ku_cache_lock.unlock();
+
+    return SNMPv3_USM_OK;
+}
+
+void AuthPriv::clear_key_cache()
+{
+    ku_cache_lock.lock();
+    for (int i = 0; i < SNMP_PP_KU_CACHE_SIZE; i++)
+    {
+        KuCacheEntry& e = ku_cache[i];
+
+        if (e.password)
+        {
+            memset(e.password, 0, e.password_len);
+            delete[] e.password;
+        }
+        memset(e.ku, 0, sizeof(e.ku));
+        e.auth_prot    = 0;
+        e.password     = nullptr;
+        e.password_len = 0;
+        e.ku_len       = 0;
+    }
+    ku_cache_next = 0;
+    ku_cache_lock.unlock();
+}
+
 int AuthPriv::password_to_key_priv(const int auth_prot, const int priv_prot,
     const unsigned char* password, const unsigned int password_len,
     const unsigned char* engine_id, const unsigned int engine_id_len,
@@ -883,12 +1225,245 @@ int AuthPriv::password_to_key_priv(const int auth_prot, const int priv_prot,
     return SNMPv3_USM_OK;
 }
 
+// Call func(i) for 0 <= i < count, spread over one thread per CPU
+template <class F> static void for_each_parallel(const int count, F func)
+{
+#    ifdef _THREADS
+    int threads = (int)std::thread::hardware_concurrency();
+
+    if (threads > count)
+    {
+        threads = count;
+    }
+    if (threads > 1)
+    {
+        std::atomic<int> next(0);
+        auto             worker = [&]() {
+            for (int i = next++; i < count; i = next++) { func(i); }
+        };
+        std::vector<std::thread> pool;
+
+        try
+        {
+            for (int t = 1; t < threads; t++) { pool.emplace_back(worker); }
+        }
+        catch (...)
+        {
+            // continue with the threads that could be started
+        }
+        worker();
+        for (auto& t : pool) { t.join(); }
+        return;
+    }
+#    endif
+    for (int i = 0; i < count; i++) { func(i); }
+}
+
+int AuthPriv::password_to_keys_auth(const int auth_prot, const int count,
+    const OctetStr* passwords, const OctetStr* engine_ids, OctetStr* keys)
+{
+    if (auth_prot == SNMP_AUTHPROTOCOL_NONE)
+    {
+        for (int i = 0; i < count; i++) { keys[i].clear(); }
+        return SNMPv3_USM_OK;
+    }
+
+    Auth* a = get_auth(auth_prot);
+
+    if (!a)
+    {
+        return SNMPv3_USM_UNSUPPORTED_AUTHPROTOCOL;
+    }
+    return password_to_keys(a, nullptr, count, passwords, engine_ids, keys);
+}
+
+int AuthPriv::password_to_keys_priv(const int auth_prot, const int priv_prot,
+    const int count, const OctetStr* passwords, const OctetStr* engine_ids,
+    OctetStr* keys)
+{
+    if (priv_prot == SNMP_PRIVPROTOCOL_NONE)
+    {
+        for (int i = 0; i < count; i++) { keys[i].clear(); }
+        return SNMPv3_USM_OK;
+    }
+
+    Priv* p = get_priv(priv_prot);
+    Auth* a = get_auth(auth_prot);
+
+    if (!p)
+    {
+        return SNMPv3_USM_UNSUPPORTED_PRIVPROTOCOL;
+    }
+    if (!a)
+    {
+        return SNMPv3_USM_UNSUPPORTED_AUTHPROTOCOL;
+    }
+    if (p->get_min_key_len() > SNMPv3_USM_MAX_KEY_LEN)
+    {
+        return SNMPv3_USM_ERROR;
+    }
+    return password_to_keys(a, p, count, passwords, engine_ids, keys);
+}
+
+int AuthPriv::password_to_keys(Auth* a, Priv* p, const int count,
+    const OctetStr* passwords, const OctetStr* engine_ids, OctetStr* keys)
+{
+    if (count <= 0)
+    {
+        return SNMPv3_USM_OK;
+    }
+
+    // Sort the pairs by password to find the distinct passwords
+    std::vector<int> order(count);
+
+    for (int i = 0; i < count; i++) { order[i] = i; }
+    std::sort(order.begin(), order.end(), [passwords](int x, int y) {
+        OctetStr const& px = passwords[x];
+        OctetStr const& py = passwords[y];
+
+        if (px.len() != py.len())
+        {
+            return px.len() < py.len();
+        }
+        return memcmp(px.data(), py.data(), px.len()) < 0;
+    });
+
+    std::vector<int> first;        // first pair of each distinct password
+    std::vector<int> group(count); // index into first for each pair
+
+    for (int i = 0; i < count; i++)
+    {
+        int const       pos = order[i];
+        OctetStr const& pw  = passwords[pos];
+
+        if (first.empty() || (passwords[first.back()].len() != pw.len())
+            || memcmp(passwords[first.back()].data(), pw.data(), pw.len()))
+        {
+            first.push_back(pos);
+        }
+        group[pos] = (int)first.size() - 1;
+    }
+
+    // Expand each distinct password once
+    int const                  distinct = (int)first.size();
+    std::vector<unsigned char> ku(distinct * SNMPv3_USM_MAX_KEY_LEN);
+    std::vector<unsigned int>  ku_len(distinct, 0);
+
+    for_each_parallel(distinct, [&](int j) {
+        OctetStr const& pw = passwords[first[j]];
+
+        if (pw.len() == 0)
+        {
+            return;
+        }
+        unsigned int len = SNMPv3_USM_MAX_KEY_LEN;
+
+        if (get_ku(a, pw.data(), pw.len(), &ku[j * SNMPv3_USM_MAX_KEY_LEN],
+                &len)
+            == SNMPv3_USM_OK)
+        {
+            ku_len[j] = len;
+        }
+    });
+
+    // Localize the keys
+    std::vector<int> results(count);
+
+    for_each_parallel(count, [&](int i) {
+        OctetStr const& pw  = passwords[i];
+        OctetStr const& eid = engine_ids[i];
+        int const       j   = group[i];
+        unsigned char   key[SNMPv3_USM_MAX_KEY_LEN];
+        unsigned int    key_len = SNMPv3_USM_MAX_KEY_LEN;
+        int             res;
+
+        if (pw.len() == 0)
+        {
+            res = SNMPv3_USM_ERROR;
+        }
+        else if (ku_len[j])
+        {
+            res = a->localize_key(&ku[j * SNMPv3_USM_MAX_KEY_LEN], ku_len[j],
+                eid.data(), eid.len(), key, &key_len);
+        }
+        else
+        {
+            // the protocol does not support generating the key in two steps
+            res = a->password_to_key(
+                pw.data(), pw.len(), eid.data(), eid.len(), key, &key_len);
+        }
+
+        // We have a too short key: Call priv protocoll to extend it
+        if (p && (res == SNMPv3_USM_OK)
+            && (key_len < (unsigned int)p->get_min_key_len()))
+        {
+            res = p->extend_short_key(pw.data(), pw.len(), eid.data(),
+                eid.len(), key, &key_len, SNMPv3_USM_MAX_KEY_LEN, a);
+        }
+        if (p && (res == SNMPv3_USM_OK))
+        {
+            p->fix_key_len(key_len);
+        }
+
+        if (res == SNMPv3_USM_OK)
+        {
+            keys[i].set_data(key, key_len);
+        }
+        else
+        {
+            keys[i].clear();
+        }
+        memset(key, 0, sizeof(key));
+        results[i] = res;
+    });
+    memset(ku.data(), 0, ku.size());
+
+    for (int i = 0; i < count; i++)
+    {
+        if (results[i] != SNMPv3_USM_OK)
+        {
+            LOG_BEGIN(loggerModuleName, WARNING_LOG | 2);
+            LOG("AuthPriv: Could not generate key (index) (result)");
+            LOG(i);
+            LOG(results[i]);
+            LOG_END;
+
+            return results[i];
+        }
+    }
+    return SNMPv3_USM_OK;
+}
+
+PrivKeyContext* AuthPriv::create_key_context(const int priv_prot,
+    const unsigned char* key, const unsigned int key_len)
+{
+    Priv* p = get_priv(priv_prot);
+
+    if (!p || !key)
+    {
+        return nullptr;
+    }
+    return p->create_key_context(key, key_len);
+}
+
 int AuthPriv::encrypt_msg(const int priv_prot, const unsigned char* key,
     const unsigned int key_len, const unsigned char* buffer,
     const unsigned int buffer_len, unsigned char* out_buffer,
     unsigned int* out_buffer_len, unsigned char* privacy_params,
     unsigned int* privacy_params_len, const uint32_t engine_boots,
     const uint32_t engine_time)
+{
+    return encrypt_msg(nullptr, priv_prot, key, key_len, buffer, buffer_len,
+        out_buffer, out_buffer_len, privacy_params, privacy_params_len,
+        engine_boots, engine_time);
+}
+
+int AuthPriv::encrypt_msg(const PrivKeyContext* ctx, const int priv_prot,
+    const unsigned char* key, const unsigned int key_len,
+    const unsigned char* buffer, const unsigned int buffer_len,
+    unsigned char* out_buffer, unsigned int* out_buffer_len,
+    unsigned char* privacy_params, unsigned int* privacy_params_len,
+    const uint32_t engine_boots, const uint32_t engine_time)
 {
     /* check for priv protocol */
     Priv* p = get_priv(priv_prot);
@@ -898,9 +1473,9 @@ int AuthPriv::encrypt_msg(const int priv_prot, const unsigned char* key,
         return SNMPv3_USM_UNSUPPORTED_PRIVPROTOCOL;
     }
 
-    return p->encrypt(key, key_len, buffer, buffer_len, out_buffer,
-        out_buffer_len, privacy_params, privacy_params_len, engine_boots,
-        engine_time);
+    return p->encrypt_with_context(ctx, key, key_len, buffer, buffer_len,
+        out_buffer, out_buffer_len, privacy_params, privacy_params_len,
+        engine_boots, engine_time);
 }
 
 int AuthPriv::decrypt_msg(const int priv_prot, const unsigned char* key,
@@ -909,6 +1484,18 @@ int AuthPriv::decrypt_msg(const int priv_prot, const unsigned char* key,
     unsigned int* out_buffer_len, const unsigned char* privacy_params,
     const unsigned int privacy_params_len, const uint32_t engine_boots,
     const uint32_t engine_time)
+{
+    return decrypt_msg(nullptr, priv_prot, key, key_len, buffer, buffer_len,
+        out_buffer, out_buffer_len, privacy_params, privacy_params_len,
+        engine_boots, engine_time);
+}
+
+int AuthPriv::decrypt_msg(const PrivKeyContext* ctx, const int priv_prot,
+    const unsigned char* key, const unsigned int key_len,
+    const unsigned char* buffer, const unsigned int buffer_len,
+    unsigned char* out_buffer, unsigned int* out_buffer_len,
+    const unsigned char* privacy_params, const unsigned int privacy_params_len,
+    const uint32_t engine_boots, const uint32_t engine_time)
 {
     /* check for priv protocol */
     Priv* p = get_priv(priv_prot);
@@ -918,9 +1505,9 @@ int AuthPriv::decrypt_msg(const int priv_prot, const unsigned char* key,
         return SNMPv3_USM_UNSUPPORTED_PRIVPROTOCOL;
     }
 
-    return p->decrypt(key, key_len, buffer, buffer_len, out_buffer,
-        out_buffer_len, privacy_params, privacy_params_len, engine_boots,
-        engine_time);
+    return p->decrypt_with_context(ctx, key, key_len, buffer, buffer_len,
+        out_buffer, out_buffer_len, privacy_params, privacy_params_len,
+        engine_boots, engine_time);
 }
 
 int AuthPriv::add_default_modules()
@@ -1053,6 +1640,78 @@ int AuthPriv::add_default_modules()
     return ret;
 }
 
+AuthHMACContext* AuthPriv::create_hmac_context(const int auth_prot,
+    const unsigned char* key, const unsigned int key_len)
+{
+    Auth* a = get_auth(auth_prot);
+
+    if (!a || !key)
+    {
+        return nullptr;
+    }
+    return a->create_hmac_context(key, key_len);
+}
+
+int AuthPriv::auth_out_msg(const AuthHMACContext* ctx, unsigned char* msg,
+    const int msg_len, unsigned char* auth_par_ptr)
+{
+    Auth* a = get_auth(ctx->get_auth_prot());
+
+    if (!a)
+    {
+        return SNMPv3_USM_UNSUPPORTED_AUTHPROTOCOL;
+    }
+
+    unsigned char digest[SNMPv3_AP_MAXLENGTH_AUTHPARAM];
+    int const     auth_par_len = a->get_auth_params_len();
+
+    memset(auth_par_ptr, 0, auth_par_len);
+
+    if (ctx->hmac(msg, msg_len, digest) != SNMPv3_USM_OK)
+    {
+        return SNMPv3_USM_ERROR;
+    }
+    memcpy(auth_par_ptr, digest, auth_par_len);
+
+    return SNMPv3_USM_OK;
+}
+
+int AuthPriv::auth_inc_msg(const AuthHMACContext* ctx, unsigned char* msg,
+    const int msg_len, unsigned char* auth_par_ptr, const int auth_par_len)
+{
+    Auth* a = get_auth(ctx->get_auth_prot());
+
+    if (!a)
+    {
+        return SNMPv3_USM_UNSUPPORTED_AUTHPROTOCOL;
+    }
+
+    if (auth_par_len != a->get_auth_params_len())
+    {
+        debugprintf(4,
+            "Illegal digest length (%d), expected (%d), authentication "
+            "FAILED.",
+            auth_par_len, a->get_auth_params_len());
+        return SNMPv3_USM_AUTHENTICATION_FAILURE;
+    }
+
+    /* Save received digest */
+    unsigned char receivedDigest[SNMPv3_AP_MAXLENGTH_AUTHPARAM];
+
+    memcpy(receivedDigest, auth_par_ptr, auth_par_len);
+
+    if ((SNMPv3_USM_OK != auth_out_msg(ctx, msg, msg_len, auth_par_ptr))
+        || memcmp(auth_par_ptr, receivedDigest, auth_par_len))
+    {
+        /* copy digest back into message and return error */
+        memcpy(auth_par_ptr, receivedDigest, auth_par_len);
+        debugprintf(4, "Authentication FAILED.");
+        return SNMPv3_USM_AUTHENTICATION_FAILURE;
+    }
+    debugprintf(4, "Authentication OK.");
+    return SNMPv3_USM_OK;
+}
+
 int AuthPriv::get_auth_params_len(const int auth_prot)
 {
     Auth* a = get_auth(auth_prot);
@@ -1137,8 +1796,6 @@ int AuthMD5::password_to_key(const unsigned char* password,
     const unsigned int engine_id_len, unsigned char* key,
     unsigned int* key_len)
 {
-    *key_len = 16; /* All MD5 keys have 16 bytes length */
-
 #    ifdef __DEBUG
     debugprintf(
         5, "password: %s.", OctetStr(password, password_len).get_printable());
@@ -1146,8 +1803,29 @@ int AuthMD5::password_to_key(const unsigned char* password,
         OctetStr(engine_id, engine_id_len).get_printable());
 #    endif
 
+    unsigned char ku[SNMPv3_AP_OUTPUT_LENGTH_MD5];
+    unsigned int  ku_len = SNMPv3_AP_OUTPUT_LENGTH_MD5;
+
+    password_to_ku(password, password_len, ku, &ku_len);
+
+    *key_len = SNMPv3_AP_OUTPUT_LENGTH_MD5;
+    localize_key(ku, ku_len, engine_id, engine_id_len, key, key_len);
+    memset(ku, 0, sizeof(ku));
+
+    return SNMPv3_USM_OK;
+}
+
+int AuthMD5::password_to_ku(const unsigned char* password,
+    const unsigned int password_len, unsigned char* ku, unsigned int* ku_len)
+{
+    if (*ku_len < SNMPv3_AP_OUTPUT_LENGTH_MD5)
+    {
+        return SNMPv3_USM_ERROR;
+    }
+    *ku_len = 16; /* All MD5 keys have 16 bytes length */
+
     MD5HashStateType md5_hash_state {};
-    unsigned char    password_buf[65];
+    unsigned char    password_buf[64];
     uint32_t         password_index = 0;
     uint32_t         count          = 0;
 
@@ -1170,25 +1848,39 @@ int AuthMD5::password_to_key(const unsigned char* password,
         MD5_PROCESS(&md5_hash_state, password_buf, 64);
         count += 64;
     }
-    MD5_DONE(&md5_hash_state, key); /* tell MD5 we're done */
+    MD5_DONE(&md5_hash_state, ku); /* tell MD5 we're done */
 
 #    ifdef __DEBUG
-    debughexcprintf(21, "key", key, *key_len);
+    debughexcprintf(21, "key", ku, *ku_len);
 #    endif
 
+    return SNMPv3_USM_OK;
+}
+
+int AuthMD5::localize_key(const unsigned char* ku, const unsigned int ku_len,
+    const unsigned char* engine_id, const unsigned int engine_id_len,
+    unsigned char* key, unsigned int* key_len)
+{
+    if ((ku_len != SNMPv3_AP_OUTPUT_LENGTH_MD5)
+        || (*key_len < SNMPv3_AP_OUTPUT_LENGTH_MD5))
+    {
+        return SNMPv3_USM_ERROR;
+    }
+    *key_len = SNMPv3_AP_OUTPUT_LENGTH_MD5;
+
     /*****************************************************/
     /* Now localize the key with the engine_id and pass  */
     /* through MD5 to produce final key                  */
-    /* May want to ensure that engine_id_len <= 32,      */
-    /* otherwise need to use a buffer larger than 64     */
     /*****************************************************/
-    memcpy(password_buf, key, *key_len);
-    memcpy(password_buf + *key_len, engine_id, engine_id_len);
-    memcpy(password_buf + *key_len + engine_id_len, key, *key_len);
+    MD5HashStateType md5_hash_state {};
+    unsigned char    digest[SNMPv3_AP_OUTPUT_LENGTH_MD5];
 
     MD5_INIT(&md5_hash_state);
-    MD5_PROCESS(&md5_hash_state, password_buf, (2 * *key_len) + engine_id_len);
-    MD5_DONE(&md5_hash_state, key);
+    MD5_PROCESS(&md5_hash_state, ku, ku_len);
+    MD5_PROCESS(&md5_hash_state, engine_id, engine_id_len);
+    MD5_PROCESS(&md5_hash_state, ku, ku_len);
+    MD5_DONE(&md5_hash_state, digest);
+    memcpy(key, digest, SNMPv3_AP_OUTPUT_LENGTH_MD5);
 
 #    ifdef __DEBUG
     debughexcprintf(21, "localized key", key, *key_len);
@@ -1268,6 +1960,16 @@ int AuthMD5::auth_out_msg(const unsigned char* key, unsigned char* msg,
     return SNMPv3_USM_OK;
 }
 
+AuthHMACContext* AuthMD5::create_hmac_context(
+    const unsigned char* key, const unsigned int key_len) const
+{
+    if (key_len != 16)
+    {
+        return nullptr;
+    }
+    return new_hmac_context(get_id(), key, key_len);
+}
+
 int AuthMD5::auth_inc_msg(const unsigned char* key, unsigned char* msg,
     const int msg_len, unsigned char* auth_par_ptr, const int auth_par_len)
 {
@@ -1290,37 +1992,113 @@ int AuthMD5::auth_inc_msg(const unsigned char* key, unsigned char* msg,
 
     if (SNMPv3_USM_OK != auth_out_msg(key, msg, msg_len, auth_par_ptr))
     {
-        /* copy digest back into message and return error */
-        memcpy(auth_par_ptr, receivedDigest, 12);
-        debugprintf(4, "MD5 authentication FAILED (1).");
-        return SNMPv3_USM_AUTHENTICATION_FAILURE;
+        /* copy digest back into message and return error */
+        memcpy(auth_par_ptr, receivedDigest, 12);
+        debugprintf(4, "MD5 authentication FAILED (1).");
+        return SNMPv3_USM_AUTHENTICATION_FAILURE;
+    }
+
+    /* compare digest to received digest */
+    for (int i = 0; i < 12; ++i)
+    {
+        if (auth_par_ptr[i] != receivedDigest[i])
+        {
+            /* copy digest back into message and return error */
+            memcpy(auth_par_ptr, receivedDigest, 12);
+            debugprintf(4, "MD5 authentication FAILED.");
+            return SNMPv3_USM_AUTHENTICATION_FAILURE;
+        }
+    }
+    debugprintf(4, "MD5 authentication OK.");
+    return SNMPv3_USM_OK;
+}
+
+/* ========================= PRIV ================================*/
+
+/* ----------------------- PrivDES ---------------------------------------*/
+
+#    if defined(_USE_LIBTOMCRYPT) && !defined(_USE_OPENSSL)
+PrivDES::PrivDES() { cipher = find_cipher("des"); }
+
+#    endif
+
+// Key schedule of a localized DES key, the IV is set for each message
+class DESKeyContext : public PrivKeyContext {
+public:
+    DESKeyContext() : PrivKeyContext(SNMP_PRIVPROTOCOL_DES) { }
+
+    ~DESKeyContext() override
+    {
+        /* Clear key schedule (paranoia!) */
+        DES_MEMSET(schedule, 0, sizeof(schedule));
+    }
+
+    DESCBCType schedule;
+};
+
+#    ifndef RSAEURO
+// Expand the first 8 bytes of the key into the schedule
+static int des_start_schedule([[maybe_unused]] const int cipher,
+    const unsigned char* key, DESCBCType& schedule)
+{
+    [[maybe_unused]] unsigned char initVect[8] = { 0 };
+
+    DES_CBC_START_ENCRYPT(cipher, initVect, key, 8, 16, schedule);
+    return SNMPv3_USM_OK;
+}
+#    endif
+
+PrivKeyContext* PrivDES::create_key_context(
+    [[maybe_unused]] const unsigned char* key,
+    [[maybe_unused]] const unsigned int   key_len) const
+{
+#    ifdef RSAEURO
+    return nullptr; // DES_CBC_CTX keeps the IV, so it cannot be shared
+#    else
+    if (key_len < 16)
+    {
+        return nullptr;
     }
+#        if defined(_USE_LIBTOMCRYPT) && !defined(_USE_OPENSSL)
+    int const des_cipher = cipher;
+#        else
+    int const des_cipher = 0;
+#        endif
+    auto* ctx = new DESKeyContext();
 
-    /* compare digest to received digest */
-    for (int i = 0; i < 12; ++i)
+    if (des_start_schedule(des_cipher, key, ctx->schedule) != SNMPv3_USM_OK)
     {
-        if (auth_par_ptr[i] != receivedDigest[i])
-        {
-            /* copy digest back into message and return error */
-            memcpy(auth_par_ptr, receivedDigest, 12);
-            debugprintf(4, "MD5 authentication FAILED.");
-            return SNMPv3_USM_AUTHENTICATION_FAILURE;
-        }
+        delete ctx;
+        return nullptr;
     }
-    debugprintf(4, "MD5 authentication OK.");
-    return SNMPv3_USM_OK;
+    return ctx;
+#    endif
 }
 
-/* ========================= PRIV ================================*/
-
-/* ----------------------- PrivDES ---------------------------------------*/
-
-#    if defined(_USE_LIBTOMCRYPT) && !defined(_USE_OPENSSL)
-PrivDES::PrivDES() { cipher = find_cipher("des"); }
+int PrivDES::encrypt(const unsigned char* key, const unsigned int key_len,
+    const unsigned char* buffer, const unsigned int buffer_len,
+    unsigned char* out_buffer, unsigned int* out_buffer_len,
+    unsigned char* privacy_params, unsigned int* privacy_params_len,
+    const uint32_t engine_boots, const uint32_t engine_time)
+{
+    return encrypt_with_context(nullptr, key, key_len, buffer, buffer_len,
+        out_buffer, out_buffer_len, privacy_params, privacy_params_len,
+        engine_boots, engine_time);
+}
 
-#    endif
+int PrivDES::decrypt(const unsigned char* key, const unsigned int key_len,
+    const unsigned char* buffer, const unsigned int buffer_len,
+    unsigned char* out_buffer, unsigned int* out_buffer_len,
+    const unsigned char* privacy_params, const unsigned int privacy_params_len,
+    const uint32_t engine_boots, const uint32_t engine_time)
+{
+    return decrypt_with_context(nullptr, key, key_len, buffer, buffer_len,
+        out_buffer, out_buffer_len, privacy_params, privacy_params_len,
+        engine_boots, engine_time);
+}
 
-int PrivDES::encrypt(const unsigned char* key, const unsigned int /*key_len*/,
+int PrivDES::encrypt_with_context(const PrivKeyContext* ctx,
+    const unsigned char* key, const unsigned int /*key_len*/,
     const unsigned char* buffer, const unsigned int buffer_len,
     unsigned char* out_buffer, unsigned int* out_buffer_len,
     unsigned char* privacy_params, unsigned int* privacy_params_len,
@@ -1367,7 +2145,17 @@ int PrivDES::encrypt(const unsigned char* key, const unsigned int /*key_len*/,
 #    endif
 
     DESCBCType symcbc;
-    DES_CBC_START_ENCRYPT(cipher, initVect, key, 8, 16, symcbc);
+    auto const* des_ctx = dynamic_cast<const DESKeyContext*>(ctx);
+
+    if (des_ctx)
+    {
+        memcpy(&symcbc, &des_ctx->schedule, sizeof(symcbc));
+        DES_CBC_SET_IV(initVect, symcbc);
+    }
+    else
+    {
+        DES_CBC_START_ENCRYPT(cipher, initVect, key, 8, 16, symcbc);
+    }
 
     for (unsigned int k = 0; k <= buffer_len - 8; k += 8)
     {
@@ -1406,7 +2194,8 @@ int PrivDES::encrypt(const unsigned char* key, const unsigned int /*key_len*/,
     return SNMPv3_USM_OK;
 }
 
-int PrivDES::decrypt(const unsigned char* key, const unsigned int /*key_len*/,
+int PrivDES::decrypt_with_context(const PrivKeyContext* ctx,
+    const unsigned char* key, const unsigned int /*key_len*/,
     const unsigned char* buffer, const unsigned int buffer_len,
     unsigned char* outBuffer, unsigned int* outBuffer_len,
     const unsigned char* privacy_params, const unsigned int privacy_params_len,
@@ -1439,7 +2228,17 @@ int PrivDES::decrypt(const unsigned char* key, const unsigned int /*key_len*/,
 #    endif
 
     DESCBCType symcbc;
-    DES_CBC_START_DECRYPT(cipher, initVect, key, 8, 16, symcbc);
+    auto const* des_ctx = dynamic_cast<const DESKeyContext*>(ctx);
+
+    if (des_ctx)
+    {
+        memcpy(&symcbc, &des_ctx->schedule, sizeof(symcbc));
+        DES_CBC_SET_IV(initVect, symcbc);
+    }
+    else
+    {
+        DES_CBC_START_DECRYPT(cipher, initVect, key, 8, 16, symcbc);
+    }
     for (unsigned int j = 0; j < buffer_len; j += 8)
     {
         DES_CBC_DECRYPT(buffer + j, outBuffer + j, symcbc, initVect, 8);
@@ -1615,6 +2414,189 @@ PrivAES::PrivAES(const int aes_type_) : aes_type(aes_type_)
     }
 }
 
+#        ifdef _USE_OPENSSL
+
+// The CFB128 cipher of OpenSSL for the AES type, which uses AES-NI if the
+// CPU supports it
+static const EVP_CIPHER* evp_aes_cipher(const int aes_type)
+{
+    switch (aes_type)
+    {
+    case SNMP_PRIVPROTOCOL_AES128: return EVP_aes_128_cfb128();
+    case SNMP_PRIVPROTOCOL_AES192: return EVP_aes_192_cfb128();
+    case SNMP_PRIVPROTOCOL_AES256: return EVP_aes_256_cfb128();
+    default: return nullptr;
+    }
+}
+
+// Cipher context of the calling thread, reused for all messages
+static EVP_CIPHER_CTX* evp_cipher_work_ctx()
+{
+    struct WorkCtx {
+        WorkCtx() : ctx(EVP_CIPHER_CTX_new()) { }
+
+        ~WorkCtx() { EVP_CIPHER_CTX_free(ctx); }
+
+        EVP_CIPHER_CTX* ctx;
+    };
+    static thread_local WorkCtx work;
+
+    return work.ctx;
+}
+
+// Cipher contexts initialized with a localized AES key. They are not
+// modified after init(), each message copies one into the context of
+// the calling thread and sets only the IV, which keeps the expanded key.
+class AESKeyContext : public PrivKeyContext {
+public:
+    AESKeyContext(const int prot)
+        : PrivKeyContext(prot), enc(EVP_CIPHER_CTX_new()),
+          dec(EVP_CIPHER_CTX_new())
+    { }
+
+    ~AESKeyContext() override
+    {
+        EVP_CIPHER_CTX_free(enc);
+        EVP_CIPHER_CTX_free(dec);
+    }
+
+    // Expand the key for both directions, false on errors
+    bool init(const EVP_CIPHER* evp_cipher, const unsigned char* key)
+    {
+        return enc && dec
+            && (EVP_EncryptInit_ex(enc, evp_cipher, nullptr, key, nullptr)
+                == 1)
+            && (EVP_DecryptInit_ex(dec, evp_cipher, nullptr, key, nullptr)
+                == 1);
+    }
+
+    // Encrypt or decrypt the buffer with the IV, false on errors
+    bool crypt(const bool encrypt, const unsigned char* initVect,
+        const unsigned char* buffer, const unsigned int buffer_len,
+        unsigned char* out_buffer) const
+    {
+        EVP_CIPHER_CTX* const ctx  = evp_cipher_work_ctx();
+        int                   len1 = 0;
+        int                   len2 = 0;
+
+        if (!ctx || (EVP_CIPHER_CTX_copy(ctx, encrypt ? enc : dec) != 1)
+            || (EVP_CipherInit_ex(ctx, nullptr, nullptr, nullptr, initVect, -1)
+                != 1)
+            || (EVP_CipherUpdate(ctx, out_buffer, &len1, buffer, buffer_len)
+                != 1)
+            || (EVP_CipherFinal_ex(ctx, out_buffer + len1, &len2) != 1))
+        {
+            return false;
+        }
+        return len1 + len2 == static_cast<int>(buffer_len);
+    }
+
+private:
+    EVP_CIPHER_CTX* enc; ///< keyed for encryption
+    EVP_CIPHER_CTX* dec; ///< keyed for decryption
+};
+
+#        else
+
+// CFB state of a localized AES key, copied and given the IV for each
+// message
+class AESKeyContext : public PrivKeyContext {
+public:
+    AESKeyContext(const int prot) : PrivKeyContext(prot), cfb {} { }
+
+    ~AESKeyContext() override
+    {
+        /* Clear context (paranoia!)*/
+        memset(&cfb, 0, sizeof(cfb));
+    }
+
+    // Expand the key, false on errors
+    bool init(const int cipher, const unsigned char* key,
+        const int key_bytes, const int rounds)
+    {
+        unsigned char initVect[16] = { 0 };
+
+        return cfb_start(cipher, initVect, key, key_bytes, rounds, &cfb)
+            == CRYPT_OK;
+    }
+
+    // Encrypt or decrypt the buffer with the IV, false on errors
+    bool crypt(const bool encrypt, const unsigned char* initVect,
+        const unsigned char* buffer, const unsigned int buffer_len,
+        unsigned char* out_buffer) const
+    {
+        symmetric_CFB symcfb = cfb;
+        bool          ok     = (cfb_setiv(initVect, 16, &symcfb) == CRYPT_OK);
+
+        if (ok && encrypt)
+        {
+            ok = (cfb_encrypt((unsigned char*)buffer, out_buffer, buffer_len,
+                      &symcfb)
+                == CRYPT_OK);
+        }
+        else if (ok)
+        {
+            ok = (cfb_decrypt((unsigned char*)buffer, out_buffer, buffer_len,
+                      &symcfb)
+                == CRYPT_OK);
+        }
+        /* Clear context (paranoia!)*/
+        memset(&symcfb, 0, sizeof(symcfb));
+        return ok;
+    }
+
+private:
+    symmetric_CFB cfb;
+};
+
+#        endif // _USE_OPENSSL
+
+PrivKeyContext* PrivAES::create_key_context(
+    const unsigned char* key, const unsigned int key_len) const
+{
+    if ((aes_type < 0) || (key_len < (unsigned int)key_bytes))
+    {
+        return nullptr;
+    }
+
+    auto* ctx = new AESKeyContext(aes_type);
+
+#        ifdef _USE_OPENSSL
+    bool const ok = ctx->init(evp_aes_cipher(aes_type), key);
+#        else
+    bool const ok = ctx->init(cipher, key, key_bytes, rounds);
+#        endif
+    if (!ok)
+    {
+        debugprintf(1, "Expanding the AES key failed.");
+        delete ctx;
+        return nullptr;
+    }
+    return ctx;
+}
+
+int PrivAES::encrypt(const unsigned char* key, const unsigned int key_len,
+    const unsigned char* buffer, const unsigned int buffer_len,
+    unsigned char* out_buffer, unsigned int* out_buffer_len,
+    unsigned char* privacy_params, unsigned int* privacy_params_len,
+    const uint32_t engine_boots, const uint32_t engine_time)
+{
+    return encrypt_with_context(nullptr, key, key_len, buffer, buffer_len,
+        out_buffer, out_buffer_len, privacy_params, privacy_params_len,
+        engine_boots, engine_time);
+}
+
+int PrivAES::decrypt(const unsigned char* key, const unsigned int key_len,
+    const unsigned char* buffer, const unsigned int buffer_len,
+    unsigned char* out_buffer, unsigned int* out_buffer_len,
+    const unsigned char* privacy_params, const unsigned int privacy_params_len,
+    const uint32_t engine_boots, const uint32_t engine_time)
+{
+    return decrypt_with_context(nullptr, key, key_len, buffer, buffer_len,
+        out_buffer, out_buffer_len, privacy_params, privacy_params_len,
+        engine_boots, engine_time);
+}
+
 const char* PrivAES::get_id_string() const
 {
     switch (aes_type)
@@ -1641,10 +2623,11 @@ const char* PrivAES::get_id_string() const
     }
 }
 
-int PrivAES::encrypt(const unsigned char* key,
-    [[maybe_unused]] const unsigned int key_len, const unsigned char* buffer,
-    const unsigned int buffer_len, unsigned char* out_buffer,
-    unsigned int* out_buffer_len, unsigned char* privacy_params,
+int PrivAES::encrypt_with_context(const PrivKeyContext* ctx,
+    const unsigned char* key, [[maybe_unused]] const unsigned int key_len,
+    const unsigned char* buffer, const unsigned int buffer_len,
+    unsigned char* out_buffer, unsigned int* out_buffer_len,
+    unsigned char* privacy_params,
     unsigned int* privacy_params_len, const uint32_t engine_boots,
     const uint32_t engine_time)
 {
@@ -1691,74 +2674,74 @@ int PrivAES::encrypt(const unsigned char* key,
     memcpy(privacy_params, initVect + 8, 8);
     debughexcprintf(21, "aes initVect:", initVect, 16);
 
-#        ifdef _USE_OPENSSL
-    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-    if (!ctx)
-    {
-        debugprintf(1, "EVP_CIPHER_CTX_new() failed.");
-        return SNMPv3_USM_ENCRYPTION_ERROR;
-    }
+    auto const* aes_ctx = dynamic_cast<const AESKeyContext*>(ctx);
 
-    const EVP_CIPHER* evp_cipher = nullptr;
-    switch (aes_type)
+    if (aes_ctx && (aes_ctx->get_priv_prot() == aes_type))
     {
-    case SNMP_PRIVPROTOCOL_AES128: {
-        evp_cipher = EVP_aes_128_cfb128();
-        break;
-    }
-
-    case SNMP_PRIVPROTOCOL_AES192: {
-        evp_cipher = EVP_aes_192_cfb128();
-        break;
+        if (!aes_ctx->crypt(true, initVect, buffer, buffer_len, out_buffer))
+        {
+            debugprintf(1, "AES encryption with the key context failed.");
+            return SNMPv3_USM_ENCRYPTION_ERROR;
+        }
     }
+    else
+    {
+#        ifdef _USE_OPENSSL
+        EVP_CIPHER_CTX* evp_ctx = EVP_CIPHER_CTX_new();
+        if (!evp_ctx)
+        {
+            debugprintf(1, "EVP_CIPHER_CTX_new() failed.");
+            return SNMPv3_USM_ENCRYPTION_ERROR;
+        }
 
-    case SNMP_PRIVPROTOCOL_AES256: {
-        evp_cipher = EVP_aes_256_cfb128();
-        break;
-    }
-    }
+        const EVP_CIPHER* evp_cipher = evp_aes_cipher(aes_type);
 
-    if (EVP_EncryptInit_ex(ctx, evp_cipher, nullptr, key, initVect) != 1)
-    {
-        debugprintf(1, "EVP_EncryptInit_ex() failed.");
-        EVP_CIPHER_CTX_free(ctx);
-        return SNMPv3_USM_ENCRYPTION_ERROR;
-    }
+        if (EVP_EncryptInit_ex(evp_ctx, evp_cipher, nullptr, key, initVect)
+            != 1)
+        {
+            debugprintf(1, "EVP_EncryptInit_ex() failed.");
+            EVP_CIPHER_CTX_free(evp_ctx);
+            return SNMPv3_USM_ENCRYPTION_ERROR;
+        }
 
-    int len1 = *out_buffer_len;
-    if (EVP_EncryptUpdate(ctx, out_buffer, &len1, buffer, buffer_len) != 1)
-    {
-        debugprintf(1, "EVP_EncryptUpdate() failed.");
-        EVP_CIPHER_CTX_free(ctx);
-        return SNMPv3_USM_ENCRYPTION_ERROR;
-    }
+        int len1 = *out_buffer_len;
+        if (EVP_EncryptUpdate(evp_ctx, out_buffer, &len1, buffer, buffer_len)
+            != 1)
+        {
+            debugprintf(1, "EVP_EncryptUpdate() failed.");
+            EVP_CIPHER_CTX_free(evp_ctx);
+            return SNMPv3_USM_ENCRYPTION_ERROR;
+        }
 
-    unsigned char* out_buffer_ptr = out_buffer + len1;
-    int            len2           = *out_buffer_len - len1;
-    if (EVP_EncryptFinal_ex(ctx, out_buffer_ptr, &len2) != 1)
-    {
-        debugprintf(1, "EVP_EncryptFinal_ex() failed.");
-        EVP_CIPHER_CTX_free(ctx);
-        return SNMPv3_USM_ENCRYPTION_ERROR;
-    }
+        unsigned char* out_buffer_ptr = out_buffer + len1;
+        int            len2           = *out_buffer_len - len1;
+        if (EVP_EncryptFinal_ex(evp_ctx, out_buffer_ptr, &len2) != 1)
+        {
+            debugprintf(1, "EVP_EncryptFinal_ex() failed.");
+            EVP_CIPHER_CTX_free(evp_ctx);
+            return SNMPv3_USM_ENCRYPTION_ERROR;
+        }
 
-    EVP_CIPHER_CTX_free(ctx);
+        EVP_CIPHER_CTX_free(evp_ctx);
 
-    if (len1 + len2 != static_cast<int>(buffer_len))
-    {
-        debugprintf(1, "Encryption wrote (%d + %d) bytes instead of (%d)",
-            len1, len2, buffer_len);
-        return SNMPv3_USM_ENCRYPTION_ERROR;
-    }
+        if (len1 + len2 != static_cast<int>(buffer_len))
+        {
+            debugprintf(1,
+                "Encryption wrote (%d + %d) bytes instead of (%d)", len1,
+                len2, buffer_len);
+            return SNMPv3_USM_ENCRYPTION_ERROR;
+        }
 #        else
-    symmetric_CFB symcfb;
+        symmetric_CFB symcfb;
 
-    cfb_start(cipher, initVect, key, key_bytes, rounds, &symcfb);
-    cfb_encrypt((unsigned char*)buffer, out_buffer, buffer_len, &symcfb);
+        cfb_start(cipher, initVect, key, key_bytes, rounds, &symcfb);
+        cfb_encrypt(
+            (unsigned char*)buffer, out_buffer, buffer_len, &symcfb);
 
-    /* Clear context (paranoia!)*/
-    memset(&symcfb, 0, sizeof(symcfb));
+        /* Clear context (paranoia!)*/
+        memset(&symcfb, 0, sizeof(symcfb));
 #        endif
+    }
 
     *out_buffer_len = buffer_len;
 
@@ -1775,10 +2758,11 @@ int PrivAES::encrypt(const unsigned char* key,
     return SNMPv3_USM_OK;
 }
 
-int PrivAES::decrypt(const unsigned char* key,
-    [[maybe_unused]] const unsigned int key_len, const unsigned char* buffer,
-    const unsigned int buffer_len, unsigned char* out_buffer,
-    unsigned int* out_buffer_len, const unsigned char* privacy_params,
+int PrivAES::decrypt_with_context(const PrivKeyContext* ctx,
+    const unsigned char* key, [[maybe_unused]] const unsigned int key_len,
+    const unsigned char* buffer, const unsigned int buffer_len,
+    unsigned char* out_buffer, unsigned int* out_buffer_len,
+    const unsigned char* privacy_params,
     const unsigned int privacy_params_len, const uint32_t engine_boots,
     const uint32_t engine_time)
 {
@@ -1805,74 +2789,74 @@ int PrivAES::decrypt(const unsigned char* key,
     memcpy(initVect + 8, privacy_params, 8);
     debughexcprintf(21, "aes initVect:", initVect, 16);
 
-#        ifdef _USE_OPENSSL
-    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-    if (!ctx)
-    {
-        debugprintf(1, "EVP_CIPHER_CTX_new() failed.");
-        return SNMPv3_USM_DECRYPTION_ERROR;
-    }
+    auto const* aes_ctx = dynamic_cast<const AESKeyContext*>(ctx);
 
-    const EVP_CIPHER* evp_cipher = nullptr;
-    switch (aes_type)
+    if (aes_ctx && (aes_ctx->get_priv_prot() == aes_type))
     {
-    case SNMP_PRIVPROTOCOL_AES128: {
-        evp_cipher = EVP_aes_128_cfb128();
-        break;
-    }
-
-    case SNMP_PRIVPROTOCOL_AES192: {
-        evp_cipher = EVP_aes_192_cfb128();
-        break;
+        if (!aes_ctx->crypt(false, initVect, buffer, buffer_len, out_buffer))
+        {
+            debugprintf(1, "AES decryption with the key context failed.");
+            return SNMPv3_USM_DECRYPTION_ERROR;
+        }
     }
+    else
+    {
+#        ifdef _USE_OPENSSL
+        EVP_CIPHER_CTX* evp_ctx = EVP_CIPHER_CTX_new();
+        if (!evp_ctx)
+        {
+            debugprintf(1, "EVP_CIPHER_CTX_new() failed.");
+            return SNMPv3_USM_DECRYPTION_ERROR;
+        }
 
-    case SNMP_PRIVPROTOCOL_AES256: {
-        evp_cipher = EVP_aes_256_cfb128();
-        break;
-    }
-    }
+        const EVP_CIPHER* evp_cipher = evp_aes_cipher(aes_type);
 
-    if (EVP_DecryptInit_ex(ctx, evp_cipher, nullptr, key, initVect) != 1)
-    {
-        debugprintf(1, "EVP_DecryptInit_ex() failed.");
-        EVP_CIPHER_CTX_free(ctx);
-        return SNMPv3_USM_DECRYPTION_ERROR;
-    }
+        if (EVP_DecryptInit_ex(evp_ctx, evp_cipher, nullptr, key, initVect)
+            != 1)
+        {
+            debugprintf(1, "EVP_DecryptInit_ex() failed.");
+            EVP_CIPHER_CTX_free(evp_ctx);
+            return SNMPv3_USM_DECRYPTION_ERROR;
+        }
 
-    int len1 = *out_buffer_len;
-    if (EVP_DecryptUpdate(ctx, out_buffer, &len1, buffer, buffer_len) != 1)
-    {
-        debugprintf(1, "EVP_DecryptUpdate() failed.");
-        EVP_CIPHER_CTX_free(ctx);
-        return SNMPv3_USM_DECRYPTION_ERROR;
-    }
+        int len1 = *out_buffer_len;
+        if (EVP_DecryptUpdate(evp_ctx, out_buffer, &len1, buffer, buffer_len)
+            != 1)
+        {
+            debugprintf(1, "EVP_DecryptUpdate() failed.");
+            EVP_CIPHER_CTX_free(evp_ctx);
+            return SNMPv3_USM_DECRYPTION_ERROR;
+        }
 
-    unsigned char* out_buffer_ptr = out_buffer + len1;
-    int            len2           = *out_buffer_len - len1;
-    if (EVP_DecryptFinal_ex(ctx, out_buffer_ptr, &len2) != 1)
-    {
-        debugprintf(1, "EVP_DecryptFinal_ex() failed.");
-        EVP_CIPHER_CTX_free(ctx);
-        return SNMPv3_USM_DECRYPTION_ERROR;
-    }
+        unsigned char* out_buffer_ptr = out_buffer + len1;
+        int            len2           = *out_buffer_len - len1;
+        if (EVP_DecryptFinal_ex(evp_ctx, out_buffer_ptr, &len2) != 1)
+        {
+            debugprintf(1, "EVP_DecryptFinal_ex() failed.");
+            EVP_CIPHER_CTX_free(evp_ctx);
+            return SNMPv3_USM_DECRYPTION_ERROR;
+        }
 
-    EVP_CIPHER_CTX_free(ctx);
+        EVP_CIPHER_CTX_free(evp_ctx);
 
-    if (len1 + len2 != static_cast<int>(buffer_len))
-    {
-        debugprintf(1, "Encryption wrote (%d + %d) bytes instead of (%d)",
-            len1, len2, buffer_len);
-        return SNMPv3_USM_DECRYPTION_ERROR;
-    }
+        if (len1 + len2 != static_cast<int>(buffer_len))
+        {
+            debugprintf(1,
+                "Encryption wrote (%d + %d) bytes instead of (%d)", len1,
+                len2, buffer_len);
+            return SNMPv3_USM_DECRYPTION_ERROR;
+        }
 #        else
-    symmetric_CFB symcfb;
+        symmetric_CFB symcfb;
 
-    cfb_start(cipher, initVect, key, key_bytes, rounds, &symcfb);
-    cfb_decrypt((unsigned char*)buffer, out_buffer, buffer_len, &symcfb);
+        cfb_start(cipher, initVect, key, key_bytes, rounds, &symcfb);
+        cfb_decrypt(
+            (unsigned char*)buffer, out_buffer, buffer_len, &symcfb);
 
-    /* Clear context (paranoia!)*/
-    memset(&symcfb, 0, sizeof(symcfb));
+        /* Clear context (paranoia!)*/
+        memset(&symcfb, 0, sizeof(symcfb));
 #        endif
+    }
 
     *out_buffer_len = buffer_len;
 
@@ -2352,14 +3336,34 @@ int AuthSHABase::password_to_key(const unsigned char* password,
         OctetStr(engine_id, engine_id_len).get_printable());
 #    endif
 
-    unsigned char password_buf[72];
+    unsigned char ku[SNMPv3_USM_MAX_KEY_LEN];
+    unsigned int  ku_len = SNMPv3_USM_MAX_KEY_LEN;
+
+    password_to_ku(password, password_len, ku, &ku_len);
+
+    *key_len = ku_len;
+    localize_key(ku, ku_len, engine_id, engine_id_len, key, key_len);
+    memset(ku, 0, sizeof(ku));
+
+    return SNMPv3_USM_OK;
+}
+
+int AuthSHABase::password_to_ku(const unsigned char* password,
+    const unsigned int password_len, unsigned char* ku, unsigned int* ku_len)
+{
+    unsigned char password_buf[64];
     uint32_t      password_index = 0;
     uint32_t      count          = 0;
 
     std::unique_ptr<Hasher> h(get_hasher());
-    h->init(); /* initialize SHA */
 
-    *key_len = h->get_key_length();
+    if (*ku_len < (unsigned)h->get_key_length())
+    {
+        return SNMPv3_USM_ERROR;
+    }
+    *ku_len = h->get_key_length();
+
+    h->init(); /* initialize SHA */
 
     /**********************************************/
     /* Use while loop until we've done 1 Megabyte */
@@ -2380,21 +3384,41 @@ int AuthSHABase::password_to_key(const unsigned char* password,
         count += 64;
     }
 
-    h->final(key); /* tell SHA we're done */
+    h->final(ku); /* tell SHA we're done */
 
 #    ifdef __DEBUG
-    debughexcprintf(21, "key", key, *key_len);
+    debughexcprintf(21, "key", ku, *ku_len);
 #    endif
 
+    return SNMPv3_USM_OK;
+}
+
+int AuthSHABase::localize_key(const unsigned char* ku,
+    const unsigned int ku_len, const unsigned char* engine_id,
+    const unsigned int engine_id_len, unsigned char* key,
+    unsigned int* key_len)
+{
+    std::unique_ptr<Hasher> h(get_hasher());
+    unsigned int const      len = h->get_key_length();
+
+    if ((ku_len != len) || (*key_len < len))
+    {
+        return SNMPv3_USM_ERROR;
+    }
+    *key_len = len;
+
     /*****************************************************/
     /* Now localize the key with the engine_id and pass  */
     /* through SHA to produce final key                  */
     /*****************************************************/
+    unsigned char digest[SNMPv3_USM_MAX_KEY_LEN];
+
     h->init();
-    h->update(key, *key_len);
+    h->update(ku, ku_len);
     h->update(engine_id, engine_id_len);
-    h->update(key, *key_len);
-    h->final(key);
+    h->update(ku, ku_len);
+    h->final(digest);
+    memcpy(key, digest, len);
 
 #    ifdef __DEBUG
     debughexcprintf(21, "localized key", key, *key_len);
@@ -2522,6 +3546,18 @@ int AuthSHABase::auth_inc_msg(const unsigned char* key, unsigned char* msg,
     return SNMPv3_USM_OK;
 }
 
+AuthHMACContext* AuthSHABase::create_hmac_context(
+    const unsigned char* key, const unsigned int key_len) const
+{
+    std::unique_ptr<Hasher> h(get_hasher());
+
+    if (key_len != (unsigned int)h->get_key_length())
+    {
+        return nullptr;
+    }
+    return new_hmac_context(get_id(), key, key_len);
+}
+
 class AuthSHA::HasherSHA1 : public AuthSHABase::Hasher {
 public:
     HasherSHA1() { }
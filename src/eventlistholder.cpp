@@ -28,6 +28,7 @@
 #include "snmp_pp/eventlistholder.h"
 
 #include "snmp_pp/eventlist.h"
+#include "snmp_pp/log.h"
 #include "snmp_pp/mp_v3.h"
 #include "snmp_pp/msgqueue.h"
 #include "snmp_pp/notifyqueue.h"
@@ -41,13 +42,38 @@
 #    define DEFAULT_MAX_BLOCK_EVENT_TIME 100
 #endif
 
+#ifndef SNMP_PP_EPOLL_MAX_EVENTS
+// Maximum number of ready sockets fetched by one call to epoll_wait
+#    define SNMP_PP_EPOLL_MAX_EVENTS 64
+#endif
+
 #ifdef SNMP_PP_NAMESPACE
 namespace Snmp_pp
 {
 #endif
 
+#if !defined(_NO_LOGGING) && defined(HAVE_EPOLL_SYSCALL)
+static const char* loggerModuleName = "snmp++.eventlistholder";
+#endif
+
 EventListHolder::EventListHolder(Snmp* snmp_session)
+#ifdef HAVE_EPOLL_SYSCALL
+    : m_epollFd(-1), m_epollOwners(nullptr), m_epollOwnersSize(0),
+      m_epollFdCount(0)
+#endif
 {
+#ifdef HAVE_EPOLL_SYSCALL
+    // The epoll instance has to exist before the queues register sockets
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epollFd < 0)
+    {
+        LOG_BEGIN(loggerModuleName, WARNING_LOG | 1);
+        LOG("EventListHolder: epoll not available, using poll (errno)");
+        LOG(errno);
+        LOG_END;
+    }
+#endif
+
     // Automaticly add the SNMP message queue
     m_snmpMessageQueue = new CSNMPMessageQueue(this, snmp_session);
     m_eventList.AddEntry(m_snmpMessageQueue);
@@ -69,13 +95,30 @@ EventListHolder::EventListHolder(Snmp* snmp_session)
 #endif
 }
 
+EventListHolder::~EventListHolder()
+{
+#ifdef HAVE_EPOLL_SYSCALL
+    if (m_epollFd >= 0)
+    {
+        close(m_epollFd);
+    }
+    delete[] m_epollOwners;
+#endif
+}
+
 //---------[ Block For Response ]-----------------------------------
 // Wait for the completion of an outstanding SNMP event (msg).
 // Handle any other events as they occur.
+// If the poll thread is running, just wait until it has received the
+// response, so concurrent synchronous requests do not poll the sockets.
 int EventListHolder::SNMPBlockForResponse(const uint32_t req_id, Pdu& pdu)
 {
     do {
-        SNMPProcessEvents(DEFAULT_MAX_BLOCK_EVENT_TIME);
+        if (!m_snmpMessageQueue->WaitForResponse(
+                req_id, DEFAULT_MAX_BLOCK_EVENT_TIME))
+        {
+            SNMPProcessEvents(DEFAULT_MAX_BLOCK_EVENT_TIME);
+        }
     } while (!m_snmpMessageQueue->Done(req_id));
 
     m_snmpMessageQueue->lock(); // FIXME: not exception save! CK
@@ -112,6 +155,13 @@ int EventListHolder::SNMPProcessPendingEvents()
     msec           now(0, 0);
     int            status;
 
+#    ifdef HAVE_EPOLL_SYSCALL
+    if (m_epollFd >= 0)
+    {
+        return SNMPEpollProcessPendingEvents();
+    }
+#    endif
+
     pevents_mutex.lock(); // FIXME: not exception save! CK
 
     timeout = 1;          // chosen a very small timeout
@@ -173,6 +223,13 @@ int EventListHolder::SNMPProcessEvents(const int max_block_milliseconds)
     msec           sendTime;
     int            status = 0;
 
+#    ifdef HAVE_EPOLL_SYSCALL
+    if (m_epollFd >= 0)
+    {
+        return SNMPEpollProcessEvents(max_block_milliseconds);
+    }
+#    endif
+
     m_eventList.GetNextTimeout(sendTime);
     now.GetDelta(sendTime, fd_timeout);
 
@@ -216,6 +273,202 @@ int EventListHolder::SNMPProcessEvents(const int max_block_milliseconds)
     return status;
 }
 
+#    ifdef HAVE_EPOLL_SYSCALL
+
+// Pull all available events out of the registered sockets - do not block
+int EventListHolder::SNMPEpollProcessPendingEvents()
+{
+    struct epoll_event events[SNMP_PP_EPOLL_MAX_EVENTS];
+    int                nfound = 0;
+    msec               now(0, 0);
+    int                status = 0;
+
+    pevents_mutex.lock(); // FIXME: not exception save! CK
+
+    do {
+        nfound = epoll_wait(m_epollFd, events, SNMP_PP_EPOLL_MAX_EVENTS, 0);
+
+        now.refresh();
+
+        for (int i = 0; i < nfound; i++)
+        {
+            struct pollfd readfd { };
+            readfd.fd = events[i].data.fd;
+
+            m_epollLock.lock();
+            CEvents* owner = nullptr;
+            if (readfd.fd < m_epollOwnersSize)
+            {
+                owner = m_epollOwners[readfd.fd];
+            }
+            m_epollLock.unlock();
+
+            if (!owner)
+            {
+                continue; // unregistered after epoll_wait returned
+            }
+
+            if (events[i].events & EPOLLIN)
+            {
+                readfd.revents |= POLLIN;
+            }
+            if (events[i].events & EPOLLOUT)
+            {
+                readfd.revents |= POLLOUT;
+            }
+            if (events[i].events & EPOLLPRI)
+            {
+                readfd.revents |= POLLPRI;
+            }
+            if (events[i].events & (EPOLLERR | EPOLLHUP))
+            {
+                // let the owner read the socket to clear the condition
+                readfd.revents |= POLLIN | POLLERR;
+            }
+
+            // only the ready socket is passed to the queue
+            owner->HandleEvents(&readfd, 1);
+        }
+    } while (nfound > 0);
+
+    // go through the message queue and resend any messages
+    // which are past the timeout.
+    status = m_eventList.DoRetries(now);
+
+    pevents_mutex.unlock();
+
+    return status;
+}
+
+// Block until a registered socket is ready - then handle the event(s)
+int EventListHolder::SNMPEpollProcessEvents(const int max_block_milliseconds)
+{
+    struct epoll_event event { };
+    struct timeval     fd_timeout = {};
+    msec const         now; // automatically calls msec::refresh()
+    msec               sendTime;
+
+    m_eventList.GetNextTimeout(sendTime);
+    now.GetDelta(sendTime, fd_timeout);
+
+    if ((max_block_milliseconds > 0)
+        && ((fd_timeout.tv_sec > max_block_milliseconds / 1000)
+            || ((fd_timeout.tv_sec == max_block_milliseconds / 1000)
+                && (fd_timeout.tv_usec
+                    > (max_block_milliseconds % 1000) * 1000))))
+    {
+        fd_timeout.tv_sec  = max_block_milliseconds / 1000;
+        fd_timeout.tv_usec = (max_block_milliseconds % 1000) * 1000;
+    }
+
+    /* Prevent endless sleep in case no fd is registered */
+    if ((m_epollFdCount == 0) && (fd_timeout.tv_sec > 5))
+    {
+        fd_timeout.tv_sec = 5; /* sleep at max 5.99 seconds */
+    }
+    int const timeout = fd_timeout.tv_sec * 1000 + fd_timeout.tv_usec / 1000;
+
+    // Only wait here, the events are fetched again while holding
+    // pevents_mutex, as another thread may process them meanwhile
+    epoll_wait(m_epollFd, &event, 1, timeout);
+
+    return SNMPEpollProcessPendingEvents();
+}
+
+bool EventListHolder::RegisterFd(
+    const SnmpSocket fd, const short events, CEvents* owner)
+{
+    if ((m_epollFd < 0) || (fd < 0) || !owner)
+    {
+        return false;
+    }
+
+    struct epoll_event event { };
+    event.data.fd = fd;
+    if (events & POLLIN)
+    {
+        event.events |= EPOLLIN;
+    }
+    if (events & POLLOUT)
+    {
+        event.events |= EPOLLOUT;
+    }
+    if (events & POLLPRI)
+    {
+        event.events |= EPOLLPRI;
+    }
+
+    SnmpSynchronize const _synchronize(m_epollLock);
+
+    if (fd >= m_epollOwnersSize)
+    {
+        int newSize = (m_epollOwnersSize > 0) ? m_epollOwnersSize * 2 : 64;
+        while (newSize <= fd) { newSize *= 2; }
+
+        auto* newOwners = new CEvents*[newSize];
+        memset(newOwners, 0, newSize * sizeof(CEvents*));
+        if (m_epollOwners)
+        {
+            memcpy(newOwners, m_epollOwners,
+                m_epollOwnersSize * sizeof(CEvents*));
+            delete[] m_epollOwners;
+        }
+        m_epollOwners     = newOwners;
+        m_epollOwnersSize = newSize;
+    }
+
+    int result = -1;
+    if (m_epollOwners[fd])
+    {
+        result = epoll_ctl(m_epollFd, EPOLL_CTL_MOD, fd, &event);
+    }
+    if ((result < 0) && (!m_epollOwners[fd] || (errno == ENOENT)))
+    {
+        // new fd or the fd was closed without being unregistered
+        result = epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+    if (result < 0)
+    {
+        LOG_BEGIN(loggerModuleName, ERROR_LOG | 1);
+        LOG("EventListHolder: Could not register fd with epoll (fd) (errno)");
+        LOG(fd);
+        LOG(errno);
+        LOG_END;
+        return false;
+    }
+
+    if (!m_epollOwners[fd])
+    {
+        m_epollFdCount++;
+    }
+    m_epollOwners[fd] = owner;
+
+    LOG_BEGIN(loggerModuleName, DEBUG_LOG | 10);
+    LOG("EventListHolder: Registered fd with epoll (fd) (count)");
+    LOG(fd);
+    LOG(m_epollFdCount);
+    LOG_END;
+
+    return true;
+}
+
+void EventListHolder::UnregisterFd(const SnmpSocket fd)
+{
+    SnmpSynchronize const _synchronize(m_epollLock);
+
+    if ((fd < 0) || (fd >= m_epollOwnersSize) || !m_epollOwners[fd])
+    {
+        return;
+    }
+    struct epoll_event event { }; // needed by kernels before 2.6.9
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, &event);
+
+    m_epollOwners[fd] = nullptr;
+    m_epollFdCount--;
+}
+
+#    endif // HAVE_EPOLL_SYSCALL
+
 #else
 
 int EventListHolder::SNMPProcessPendingEvents()
@@ -1451,9 +1451,7 @@ int v3MP::snmp_build(struct snmp_pdu* pdu, unsigned char* packet,
     unsigned char                  globalData[MAXLENGTH_GLOBALDATA];
     int                            globalDataLength = MAXLENGTH_GLOBALDATA;
     int                            scopedPDULength = 0, maxLen = *out_length;
-    Buffer<unsigned char>          buf(MAX_SNMP_PACKET);
-    unsigned char*                 bufPtr    = buf.get_ptr();
-    long                           bufLength = 0, rc = 0;
+    long                           rc                     = 0;
     int                            msgID                  = 0;
     int                            cachedErrorCode        = SNMPv3_MP_OK;
     struct SecurityStateReference* securityStateReference = nullptr;
@@ -1526,25 +1524,16 @@ int v3MP::snmp_build(struct snmp_pdu* pdu, unsigned char* packet,
     LOG(contextName.get_printable());
     LOG_END;
 
-    // encode vb in buf
-    scopedPDUPtr = build_vb(pdu, scopedPDUPtr, &maxLen);
-    if (!scopedPDUPtr)
+    // encode the data pdu and the scopedPDU backwards from the end of
+    // the buffer, the lengths are known when the headers are written
+    if (maxLen > MAX_SNMP_PACKET)
     {
-        LOG_BEGIN(loggerModuleName, WARNING_LOG | 1);
-        LOG("v3MP: Error encoding vbs into buffer");
-        LOG_END;
-
-        return SNMPv3_MP_BUILD_ERROR;
+        maxLen = MAX_SNMP_PACKET;
     }
-    scopedPDULength = SAFE_INT_CAST(scopedPDUPtr - scopedPDU.get_ptr());
-
-    // build dataPDU in buf
-    maxLen       = *out_length;
-    scopedPDUPtr = scopedPDU.get_ptr();
-    bufPtr =
-        build_data_pdu(pdu, bufPtr, &maxLen, scopedPDUPtr, scopedPDULength);
+    unsigned char* const scopedPDUEnd = scopedPDU.get_ptr() + maxLen;
 
-    if (!bufPtr)
+    scopedPDUPtr = rbuild_data_pdu(pdu, scopedPDUEnd, &maxLen);
+    if (!scopedPDUPtr)
     {
         LOG_BEGIN(loggerModuleName, WARNING_LOG | 1);
         LOG("v3MP: Error encoding data pdu into buffer");
@@ -1553,13 +1542,10 @@ int v3MP::snmp_build(struct snmp_pdu* pdu, unsigned char* packet,
         return SNMPv3_MP_BUILD_ERROR;
     }
 
-    bufLength = SAFE_INT_CAST(bufPtr - buf.get_ptr());
-
     //  serialize scopedPDU
-    maxLen       = *out_length;
-    scopedPDUPtr = asn1_build_scoped_pdu(scopedPDUPtr, &maxLen,
+    scopedPDUPtr = asn1_rbuild_scoped_pdu(scopedPDUPtr, &maxLen,
         contextEngineID.data(), contextEngineID.len(), contextName.data(),
-        contextName.len(), buf.get_ptr(), bufLength);
+        contextName.len(), SAFE_INT_CAST(scopedPDUEnd - scopedPDUPtr));
 
     if (!scopedPDUPtr)
     {
@@ -1570,7 +1556,7 @@ int v3MP::snmp_build(struct snmp_pdu* pdu, unsigned char* packet,
         return SNMPv3_MP_BUILD_ERROR;
     }
 
-    scopedPDULength = SAFE_INT_CAST(scopedPDUPtr - scopedPDU.get_ptr());
+    scopedPDULength = SAFE_INT_CAST(scopedPDUEnd - scopedPDUPtr);
 
     // build msgGlobalData
     auto*         globalDataPtr = (unsigned char*)&globalData;
@@ -1635,7 +1621,7 @@ int v3MP::snmp_build(struct snmp_pdu* pdu, unsigned char* packet,
 
         rc = usm->generate_msg(globalData, globalDataLength, *out_length,
             (use_own_engine_id ? own_engine_id_oct : securityEngineID),
-            securityName, securityLevel, scopedPDU.get_ptr(), scopedPDULength,
+            securityName, securityLevel, scopedPDUPtr, scopedPDULength,
             securityStateReference, packet, out_length);
 
         if (rc == SNMPv3_USM_OK)
@@ -72,18 +72,27 @@ static const char* loggerModuleName = "snmp++.msgqueue";
 //--------[ externs ]---------------------------------------------------
 extern int send_snmp_request(SnmpSocket sock, unsigned char* send_buf,
     size_t send_len, const Address& address);
-extern int receive_snmp_response(SnmpSocket sock, Snmp& snmp_session, Pdu& pdu,
-    UdpAddress& fromaddress, OctetStr& engine_id, bool process_msg = true);
+extern int process_snmp_response(unsigned char* receive_buffer,
+    long receive_buffer_len, const SocketAddrType& from_addr,
+    Snmp& snmp_session, Pdu& pdu, UdpAddress& fromaddress,
+    OctetStr& engine_id, bool process_msg, SnmpArena* arena);
 
 //----[ CSNMPMessage class ]-------------------------------------------
 
 CSNMPMessage::CSNMPMessage(uint32_t id, Snmp* snmp, SnmpSocket socket,
-    const SnmpTarget& target, Pdu& pdu, unsigned char* rawPdu,
+    const SnmpTarget& target, const Pdu& pdu, unsigned char* rawPdu,
     size_t rawPduLen, const Address& address, snmp_callback callBack,
-    void* callData)
+    void* callData, snmp_view_callback viewCallBack)
     : m_uniqueId(id), m_snmp(snmp), m_socket(socket), m_pdu(pdu),
-      m_rawPduLen(rawPduLen), m_callBack(callBack), m_callData(callData),
-      m_reason(0), m_received(0), m_locked(false)
+      m_rawPduLen(rawPduLen), m_callBack(callBack),
+      m_viewCallBack(viewCallBack), m_viewRequest(viewCallBack != nullptr),
+      m_callData(callData), m_reason(0), m_received(0), m_locked(false),
+      m_limiterState(limiter_none), m_limiterNext(nullptr),
+      m_limiterPrev(nullptr)
+#ifdef POSIX_THREADS
+      ,
+      m_waiter(nullptr)
+#endif
 {
     // reset pdu mvs
     m_pdu.set_error_index(0);
@@ -95,11 +104,22 @@ CSNMPMessage::CSNMPMessage(uint32_t id, Snmp* snmp, SnmpSocket socket,
     m_address = dynamic_cast<Address*>(address.clone());
     m_target  = target.clone();
 
+    // Kludge: When this was first designed the units were millisecs
+    // However, later on the units for the target class were changed
+    // to hundreths of secs.  Multiply the hundreths of secs by 10
+    // to create the millisecs which the rest of the objects use.
+    // 11-Dec-95 TM
+    m_rto           = m_target->get_timeout() * 10;
+    m_retransmitted = false;
+
     SetSendTime();
 }
 
 CSNMPMessage::~CSNMPMessage()
 {
+#ifdef POSIX_THREADS
+    WakeWaiter();
+#endif
     delete[] m_rawPdu;
     delete m_address;
     delete m_target;
@@ -108,13 +128,20 @@ CSNMPMessage::~CSNMPMessage()
 void CSNMPMessage::SetSendTime()
 {
     m_sendTime.refresh();
+    m_sendTime += m_rto;
+}
 
-    // Kludge: When this was first designed the units were millisecs
-    // However, later on the units for the target class were changed
-    // to hundreths of secs.  Multiply the hundreths of secs by 10
-    // to create the millisecs which the rest of the objects use.
-    // 11-Dec-95 TM
-    m_sendTime += (m_target->get_timeout() * 10);
+bool CSNMPMessage::GetRoundTripTime(uint32_t& rtt) const
+{
+    if (m_retransmitted)
+    {
+        return false;
+    }
+    msec const   now;
+    time_t const delta = (time_t)now - (time_t)m_firstSendTime;
+
+    rtt = (delta > 0) ? (uint32_t)delta : 0;
+    return true;
 }
 
 int CSNMPMessage::SetPdu(
@@ -212,6 +239,37 @@ int CSNMPMessage::SetPdu(
     return 0;
 }
 
+#ifdef POSIX_THREADS
+void CSNMPMessage::WakeWaiter()
+{
+    if (m_waiter)
+    {
+        m_waiter->done = true;
+        pthread_cond_signal(&m_waiter->cond);
+        m_waiter = nullptr;
+    }
+}
+#endif
+
+int CSNMPMessage::SendMessage()
+{
+    LOG_BEGIN(loggerModuleName, DEBUG_LOG | 10);
+    LOG("MsgQueue: Sending queued message (req id)");
+    LOG(m_uniqueId);
+    LOG_END;
+
+    m_firstSendTime.refresh();
+    SetSendTime();
+    int const status =
+        send_snmp_request(m_socket, m_rawPdu, m_rawPduLen, *m_address);
+    if (status != 0)
+    {
+        return SNMP_CLASS_TL_FAILED;
+    }
+
+    return SNMP_CLASS_SUCCESS;
+}
+
 int CSNMPMessage::ResendMessage()
 {
     if (m_received)
@@ -239,6 +297,12 @@ int CSNMPMessage::ResendMessage()
     }
 
     m_target->set_retry(m_target->get_retry() - 1);
+    if (m_target->get_adaptive_timeout())
+    {
+        // exponential backoff
+        m_rto = CRttEstimator::Bound(m_rto * 2);
+    }
+    m_retransmitted = true;
     SetSendTime();
     int const status =
         send_snmp_request(m_socket, m_rawPdu, m_rawPduLen, *m_address);
@@ -250,8 +314,46 @@ int CSNMPMessage::ResendMessage()
     return SNMP_CLASS_SUCCESS;
 }
 
+bool CSNMPMessage::SetViewReceived(const unsigned short type)
+{
+    if (Pdu::match_type(m_pdu.get_type(), type) == false)
+    {
+        LOG_BEGIN(loggerModuleName, INFO_LOG | 1);
+        LOG("MsgQueue: Response pdu type does not match, pdu is ignored: (id) "
+            "(type1) (type2)");
+        LOG(m_uniqueId);
+        LOG(m_pdu.get_type());
+        LOG(type);
+        LOG_END;
+
+        return false;
+    }
+    if (m_received)
+    {
+        LOG_BEGIN(loggerModuleName, WARNING_LOG | 1);
+        LOG("MsgQueue: Message is already marked as received, ignoring the "
+            "second pdu (id)");
+        LOG(m_uniqueId);
+        LOG_END;
+
+        return false;
+    }
+    m_received = 1;
+    m_reason   = SNMP_CLASS_SUCCESS;
+    return true;
+}
+
 int CSNMPMessage::Callback(const int reason)
 {
+    if (m_viewRequest)
+    {
+        // the response was decoded into the Pdu as it could not be viewed
+        PduView const view;
+        return Callback((reason == SNMP_CLASS_ASYNC_RESPONSE)
+                ? SNMP_CLASS_ASN1ERROR
+                : reason,
+            view);
+    }
     if (m_callBack)
     {
         // prevent callbacks from using this message
@@ -264,6 +366,20 @@ int CSNMPMessage::Callback(const int reason)
     return 1;
 }
 
+int CSNMPMessage::Callback(const int reason, const PduView& view)
+{
+    if (m_viewCallBack)
+    {
+        // prevent callbacks from using this message
+        snmp_view_callback tmp_callBack = m_viewCallBack;
+        m_viewCallBack                  = nullptr;
+
+        tmp_callBack(reason, m_snmp, view, *m_target, m_callData);
+        return 0;
+    }
+    return 1;
+}
+
 //----[ CSNMPMessageQueueElt class ]--------------------------------------
 
 CSNMPMessageQueue::CSNMPMessageQueueElt::CSNMPMessageQueueElt(
@@ -312,8 +428,10 @@ CSNMPMessage* CSNMPMessageQueue::CSNMPMessageQueueElt::TestId(
 //----[ CSNMPMessageQueue class ]--------------------------------------
 
 CSNMPMessageQueue::CSNMPMessageQueue(EventListHolder* holder, Snmp* session)
-    : m_head(nullptr, nullptr, nullptr), m_msgCount(0), my_holder(holder),
-      m_snmpSession(session)
+    : m_head(nullptr, nullptr, nullptr), m_msgCount(0), m_viewCount(0),
+      my_holder(holder), m_snmpSession(session), m_idIndex(nullptr),
+      m_idIndexSize(0), m_idIndexUsed(0), m_recvBuffers(nullptr),
+      m_recvBufferSize(0)
 { }
 
 CSNMPMessageQueue::~CSNMPMessageQueue()
@@ -337,13 +455,108 @@ CSNMPMessageQueue::~CSNMPMessageQueue()
             delete leftOver;
         }
     }
+    delete[] m_idIndex;
+    m_idIndex = nullptr;
+    delete[] m_recvBuffers;
+    m_recvBuffers = nullptr;
     unlock();
 }
 
+// Hash for request ids, these are mostly sequential so the low bits
+// of the product are already well distributed
+#define SNMP_PP_RID_HASH(id, size) (((id) * 2654435761U) & ((size) - 1))
+
+CSNMPMessageQueue::CSNMPMessageQueueElt* CSNMPMessageQueue::IndexFind(
+    const uint32_t uniqueId)
+{
+    if (!m_idIndex)
+    {
+        return nullptr;
+    }
+    uint32_t slot = SNMP_PP_RID_HASH(uniqueId, m_idIndexSize);
+
+    while (m_idIndex[slot])
+    {
+        if ((m_idIndex[slot] != &m_head) && m_idIndex[slot]->TestId(uniqueId))
+        {
+            return m_idIndex[slot];
+        }
+        slot = (slot + 1) & (m_idIndexSize - 1);
+    }
+    return nullptr;
+}
+
+void CSNMPMessageQueue::IndexAdd(CSNMPMessageQueueElt* elt)
+{
+    // keep at least one quarter of the slots empty
+    if ((m_idIndexUsed + 1) * 4 > m_idIndexSize * 3)
+    {
+        // elt is already linked into the list, so it gets indexed, too
+        IndexResize((uint32_t)m_msgCount);
+        return;
+    }
+    uint32_t slot =
+        SNMP_PP_RID_HASH(elt->GetMessage()->GetId(), m_idIndexSize);
+
+    while (m_idIndex[slot] && (m_idIndex[slot] != &m_head))
+    {
+        slot = (slot + 1) & (m_idIndexSize - 1);
+    }
+    if (!m_idIndex[slot])
+    {
+        ++m_idIndexUsed; // a deleted slot is counted already
+    }
+    m_idIndex[slot] = elt;
+}
+
+void CSNMPMessageQueue::IndexRemove(CSNMPMessageQueueElt* elt)
+{
+    if (!m_idIndex)
+    {
+        return;
+    }
+    uint32_t slot =
+        SNMP_PP_RID_HASH(elt->GetMessage()->GetId(), m_idIndexSize);
+
+    while (m_idIndex[slot])
+    {
+        if (m_idIndex[slot] == elt)
+        {
+            m_idIndex[slot] = &m_head; // mark as deleted
+            return;
+        }
+        slot = (slot + 1) & (m_idIndexSize - 1);
+    }
+}
+
+void CSNMPMessageQueue::IndexResize(const uint32_t minEntries)
+{
+    // at most half of the slots are used after resizing
+    uint32_t newSize = 64;
+    while (newSize < minEntries * 2) { newSize *= 2; }
+
+    delete[] m_idIndex;
+    m_idIndex     = new CSNMPMessageQueueElt*[newSize];
+    m_idIndexSize = newSize;
+    m_idIndexUsed = 0;
+    memset(m_idIndex, 0, newSize * sizeof(CSNMPMessageQueueElt*));
+
+    for (CSNMPMessageQueueElt* elt = m_head.GetNext(); elt;
+         elt                       = elt->GetNext())
+    {
+        uint32_t slot =
+            SNMP_PP_RID_HASH(elt->GetMessage()->GetId(), m_idIndexSize);
+        while (m_idIndex[slot]) { slot = (slot + 1) & (m_idIndexSize - 1); }
+        m_idIndex[slot] = elt;
+        ++m_idIndexUsed;
+    }
+}
+
 CSNMPMessage* CSNMPMessageQueue::AddEntry(uint32_t id, Snmp* snmp,
-    SnmpSocket socket, const SnmpTarget& target, Pdu& pdu,
+    SnmpSocket socket, const SnmpTarget& target, const Pdu& pdu,
     unsigned char* rawPdu, size_t rawPduLen, const Address& address,
-    snmp_callback callBack, void* callData)
+    snmp_callback callBack, void* callData, bool* queued,
+    snmp_view_callback viewCallBack)
 {
     if (snmp != m_snmpSession)
     {
@@ -353,15 +566,63 @@ CSNMPMessage* CSNMPMessageQueue::AddEntry(uint32_t id, Snmp* snmp,
     }
 
     auto* newMsg = new CSNMPMessage(id, snmp, socket, target, pdu, rawPdu,
-        rawPduLen, address, callBack, callData);
+        rawPduLen, address, callBack, callData, viewCallBack);
 
     lock(); // FIXME: not exception save! CK
             /*---------------------------------------------------------*/
             /* Insert entry at head of list, done automagically by the */
-            /* constructor function, so don't use the return value.    */
+            /* constructor function, the element is also indexed.      */
             /*---------------------------------------------------------*/
-    (void)new CSNMPMessageQueueElt(newMsg, m_head.GetNext(), &m_head);
+    if (target.get_adaptive_timeout())
+    {
+        newMsg->SetRetransmitTimeout(
+            m_rtt.GetTimeout(address, newMsg->GetRetransmitTimeout()));
+    }
+    auto* newElt = new CSNMPMessageQueueElt(newMsg, m_head.GetNext(), &m_head);
     ++m_msgCount;
+    if (viewCallBack)
+    {
+        ++m_viewCount;
+    }
+    IndexAdd(newElt);
+    msec sendTime(0, 0);
+    newMsg->GetSendTime(sendTime);
+
+    bool isQueued = false;
+    if ((callBack || viewCallBack) && m_limiter.IsEnabled())
+    {
+        msec const now;
+        uint32_t   delay = 0;
+
+        // keep the order if other requests to the address are queued
+        if (m_limiter.GetFirst(address)
+            || !m_limiter.Acquire(address, now, delay))
+        {
+            m_limiter.Append(newMsg);
+            isQueued = true;
+
+            if (delay && (m_limiter.GetFirst(address) == newMsg))
+            {
+                // no token available, try again when the next one is
+                sendTime = now;
+                sendTime += delay;
+                newMsg->SetSendTime(sendTime);
+                m_timeouts.Insert(newElt, sendTime);
+            }
+        }
+        else
+        {
+            newMsg->SetLimiterState(CSNMPMessage::limiter_in_flight);
+        }
+    }
+    if (!isQueued)
+    {
+        m_timeouts.Insert(newElt, sendTime);
+    }
+    if (queued)
+    {
+        *queued = isQueued;
+    }
 
 #ifndef _NO_LOGGING
     int const count = m_msgCount;
@@ -380,57 +641,58 @@ CSNMPMessage* CSNMPMessageQueue::AddEntry(uint32_t id, Snmp* snmp,
 
 CSNMPMessage* CSNMPMessageQueue::GetEntry(const uint32_t uniqueId)
 {
-    CSNMPMessageQueueElt* msgEltPtr = m_head.GetNext();
+    CSNMPMessageQueueElt* msgEltPtr = IndexFind(uniqueId);
 
-    while (msgEltPtr)
+    if (msgEltPtr)
     {
-        CSNMPMessage* returnVal = msgEltPtr->TestId(uniqueId);
-        if (returnVal)
-        {
-            return returnVal;
-        }
-        msgEltPtr = msgEltPtr->GetNext();
+        return msgEltPtr->GetMessage();
     }
     return nullptr;
 }
 
 int CSNMPMessageQueue::DeleteEntry(const uint32_t uniqueId)
 {
-    bool loopAgain = false;
+    CSNMPMessageQueueElt* msgEltPtr = nullptr;
 
-    do {
-        loopAgain                       = false;
-        CSNMPMessageQueueElt* msgEltPtr = m_head.GetNext();
+    while ((msgEltPtr = IndexFind(uniqueId)))
+    {
+        if (msgEltPtr->GetMessage()->IsLocked())
+        {
+            unlock();
+            // TODO: should we sleep here?
+            lock();
+            continue; // look up again, the entry may be gone meanwhile
+        }
+
+        IndexRemove(msgEltPtr);
+        m_timeouts.Remove(msgEltPtr);
 
-        while (msgEltPtr)
+        CSNMPMessage* msg = msgEltPtr->GetMessage();
+        if (msg->GetLimiterState() != CSNMPMessage::limiter_none)
         {
-            if (msgEltPtr->TestId(uniqueId))
+            if (msg->GetLimiterState() == CSNMPMessage::limiter_queued)
             {
-                if (msgEltPtr->GetMessage())
-                {
-                    if (msgEltPtr->GetMessage()->IsLocked())
-                    {
-                        unlock();
-                        // TODO: should we sleep here?
-                        lock();
-                        loopAgain = true;
-                    }
-                }
-
-                if (!loopAgain)
-                {
-                    delete msgEltPtr;
-                    m_msgCount--;
-                    LOG_BEGIN(loggerModuleName, DEBUG_LOG | 10);
-                    LOG("MsgQueue: Removed entry (req id)");
-                    LOG(uniqueId);
-                    LOG_END;
-                    return SNMP_CLASS_SUCCESS;
-                }
+                m_limiter.Remove(msg);
             }
-            msgEltPtr = msgEltPtr->GetNext();
+            else
+            {
+                m_limiter.Release(msg->GetAddress());
+            }
+            // the slot is free or the first queued message has changed
+            SendQueued(msg->GetAddress(), msec());
         }
-    } while (loopAgain);
+        if (msg->IsViewRequest())
+        {
+            m_viewCount--;
+        }
+        delete msgEltPtr;
+        m_msgCount--;
+        LOG_BEGIN(loggerModuleName, DEBUG_LOG | 10);
+        LOG("MsgQueue: Removed entry (req id)");
+        LOG(uniqueId);
+        LOG_END;
+        return SNMP_CLASS_SUCCESS;
+    }
     return SNMP_CLASS_INVALID_REQID;
 }
 
@@ -457,8 +719,25 @@ void CSNMPMessageQueue::DeleteSocketEntry(const SnmpSocket socket)
                 (void)msg->Callback(SNMP_CLASS_SESSION_DESTROYED);
                 CSNMPMessageQueueElt* tmp_msgEltPtr = msgEltPtr;
                 msgEltPtr                           = tmp_msgEltPtr->GetNext();
-                // delete the entry
+                // delete the entry, all messages to the address use
+                // this socket, so there is nothing to send afterwards
+                if (msg->GetLimiterState() == CSNMPMessage::limiter_queued)
+                {
+                    m_limiter.Remove(msg);
+                }
+                else if (msg->GetLimiterState()
+                    == CSNMPMessage::limiter_in_flight)
+                {
+                    m_limiter.Release(msg->GetAddress());
+                }
+                if (msg->IsViewRequest())
+                {
+                    m_viewCount--;
+                }
+                IndexRemove(tmp_msgEltPtr);
+                m_timeouts.Remove(tmp_msgEltPtr);
                 delete tmp_msgEltPtr;
+                m_msgCount--;
             }
         }
         else
@@ -471,31 +750,13 @@ void CSNMPMessageQueue::DeleteSocketEntry(const SnmpSocket socket)
 
 CSNMPMessage* CSNMPMessageQueue::GetNextTimeoutEntry()
 {
-    CSNMPMessageQueueElt* msgEltPtr = m_head.GetNext();
-    msec                  bestTime;
-    msec                  sendTime(bestTime);
-    CSNMPMessage*         msg     = nullptr;
-    CSNMPMessage*         bestmsg = nullptr;
+    CSNMPMessageQueueElt* msgEltPtr = GetNextTimeoutElt();
 
-    if (msgEltPtr)
-    {
-        bestmsg = msgEltPtr->GetMessage();
-        bestmsg->GetSendTime(bestTime);
-    }
-
-    // This would be much simpler if the queue was an ordered list!
-    while (msgEltPtr)
+    if (!msgEltPtr)
     {
-        msg = msgEltPtr->GetMessage();
-        msg->GetSendTime(sendTime);
-        if (bestTime > sendTime)
-        {
-            bestTime = sendTime;
-            bestmsg  = msg;
-        }
-        msgEltPtr = msgEltPtr->GetNext();
+        return nullptr;
     }
-    return bestmsg;
+    return msgEltPtr->GetMessage();
 }
 
 int CSNMPMessageQueue::GetNextTimeout(msec& sendTime)
@@ -562,7 +823,7 @@ bool CSNMPMessageQueue::GetFdArray(struct pollfd* readfds, int& remaining)
     }
 
     SnmpSocket firstSocket = msgEltPtr->GetMessage()->GetSocket();
-    readfds[0].fd          = firstSocket;
+    readfds[0].fd          = m_snmpSession->get_poll_fd(firstSocket);
     readfds[0].events      = POLLIN;
     remaining--;
 
@@ -582,7 +843,8 @@ bool CSNMPMessageQueue::GetFdArray(struct pollfd* readfds, int& remaining)
             {
                 return false;
             }
-            readfds[1].fd     = msgEltPtr->GetMessage()->GetSocket();
+            readfds[1].fd     = m_snmpSession->get_poll_fd(
+                msgEltPtr->GetMessage()->GetSocket());
             readfds[1].events = POLLIN;
             remaining--;
 
@@ -601,100 +863,7 @@ int CSNMPMessageQueue::HandleEvents(
     {
         if (readfds[i].revents & POLLIN)
         {
-            UdpAddress fromaddress;
-            Pdu        tmppdu;
-            int        status;
-            int        recv_status;
-            OctetStr   engine_id;
-
-            tmppdu.set_request_id(0);
-
-            // get the response and put it into a Pdu
-            recv_status = receive_snmp_response(
-                readfds[i].fd, *m_snmpSession, tmppdu, fromaddress, engine_id);
-
-            uint32_t temp_req_id = tmppdu.get_request_id();
-            if (!temp_req_id)
-            {
-                continue;
-            }
-
-            CSNMPMessage* msg = 0;
-            bool          redoGetEntry;
-            do {
-                redoGetEntry = false;
-                lock();
-                // find the corresponding msg in the message queue
-                msg = GetEntry(temp_req_id);
-                if (msg && msg->IsLocked())
-                {
-                    unlock();
-                    // TODO: Should we sleep here?
-                    redoGetEntry = true;
-                }
-            } while (redoGetEntry);
-
-            if (!msg)
-            {
-                unlock();
-                LOG_BEGIN(loggerModuleName, INFO_LOG | 7);
-                LOG("MsgQueue: Ignore received message without outstanding "
-                    "request (req id)");
-                LOG(tmppdu.get_request_id());
-                LOG_END;
-                // the sent message is gone! probably was canceled, ignore it
-                continue;
-            }
-
-            // save pdu back into the message
-            status = msg->SetPdu(recv_status, tmppdu, fromaddress);
-
-            if (status)
-            {
-                // received pdu does not match
-                // TODO: if version is SNMPv3 we must return a report
-                //       unknown pdu handler!
-                unlock();
-                continue;
-            }
-
-#    ifdef _SNMPv3
-            if (engine_id.len() > 0)
-            {
-                SnmpTarget* target = msg->GetTarget();
-                if ((target->get_type() == SnmpTarget::type_utarget)
-                    && (target->get_version() == version3))
-                {
-                    UdpAddress addr = target->get_address();
-
-                    LOG_BEGIN(loggerModuleName, DEBUG_LOG | 14);
-                    LOG("MsgQueue: Adding engine id to table (addr) (id)");
-                    LOG(addr.get_printable());
-                    LOG(engine_id.get_printable());
-                    LOG_END;
-
-                    m_snmpSession->get_mpv3()->add_to_engine_id_table(
-                        engine_id, (char*)addr.IpAddress::get_printable(),
-                        addr.get_port());
-                }
-            }
-#    endif
-
-            // Do the callback
-            msg->SetLocked(true);
-            unlock();
-            status = msg->Callback(SNMP_CLASS_ASYNC_RESPONSE);
-            lock();
-            msg->SetLocked(false);
-
-            if (!status)
-            {
-                // this is an asynch response and the callback is done.
-                // no need to keep this message around;
-                // Dequeue the message
-                DeleteEntry(temp_req_id);
-            }
-            unlock();
+            ReceiveResponses(readfds[i].fd);
         }
     }
     return SNMP_CLASS_SUCCESS;
@@ -710,7 +879,8 @@ void CSNMPMessageQueue::GetFdSets(
 
     while (msgEltPtr)
     {
-        SnmpSocket const sock = msgEltPtr->GetMessage()->GetSocket();
+        SnmpSocket const sock =
+            m_snmpSession->get_poll_fd(msgEltPtr->GetMessage()->GetSocket());
         FD_SET(sock, &readfds);
         if (maxfds < SAFE_INT_CAST(sock + 1))
         {
@@ -736,125 +906,240 @@ int CSNMPMessageQueue::HandleEvents(const int maxfds, const fd_set& readfds,
     {
         if ((FD_ISSET(fd, &snmp_readfds)) && (FD_ISSET(fd, (fd_set*)&readfds)))
         {
-            UdpAddress fromaddress;
-            Pdu        tmppdu;
-            int        status      = 0;
-            int        recv_status = 0;
-            OctetStr   engine_id;
+            ReceiveResponses(fd);
+        }
+    }
+    return SNMP_CLASS_SUCCESS;
+}
 
-            tmppdu.set_request_id(0);
+#endif // HAVE_POLL_SYSCALL
 
-            // get the response and put it into a Pdu
-            recv_status = receive_snmp_response(
-                fd, *m_snmpSession, tmppdu, fromaddress, engine_id);
+int CSNMPMessageQueue::ReceiveResponses(const SnmpSocket fd)
+{
+    // one more byte to detect messages that are too long
+    int const bufferSize = m_snmpSession->get_max_message_size() + 1;
 
-            uint32_t const temp_req_id = tmppdu.get_request_id();
-            if (!temp_req_id)
-            {
-                continue;
-            }
+    if (!m_recvBuffers || (m_recvBufferSize != bufferSize))
+    {
+        delete[] m_recvBuffers;
+        m_recvBuffers =
+            new unsigned char[SNMP_PP_RECV_BATCH_SIZE * bufferSize];
+        m_recvBufferSize = bufferSize;
+    }
 
-            CSNMPMessage* msg          = nullptr;
-            bool          redoGetEntry = false;
-            do {
-                redoGetEntry = false;
-                lock(); // FIXME: not exception save! CK
-                // find the corresponding msg in the message queue
-                msg = GetEntry(temp_req_id);
-                if (msg && msg->IsLocked())
-                {
-                    unlock();
-                    // TODO: should we sleep here?
-                    redoGetEntry = true;
-                }
-            } while (redoGetEntry);
+    int const count = m_snmpSession->receive_datagrams(fd, m_recvBuffers,
+        bufferSize, m_recvLengths, m_recvFrom, SNMP_PP_RECV_BATCH_SIZE);
+
+    for (int i = 0; i < count; i++)
+    {
+        unsigned char* const buffer = m_recvBuffers + (i * bufferSize);
 
-            if (!msg)
+        if (m_viewCount > 0)
+        {
+            // responses to view requests are not decoded into a Pdu
+            PduView view;
+            if ((m_recvLengths[i] > 0) && (m_recvLengths[i] < bufferSize)
+                && (view.parse(buffer, (size_t)m_recvLengths[i])
+                    == SNMP_CLASS_SUCCESS)
+                && HandleViewResponse(view))
             {
-                unlock();
-                LOG_BEGIN(loggerModuleName, INFO_LOG | 7);
-                LOG("MsgQueue: Ignore received message without outstanding "
-                    "request (req id)");
-                LOG(tmppdu.get_request_id());
-                LOG_END;
-                // the sent message is gone! probably was canceled, ignore it
                 continue;
             }
+        }
 
-            // save pdu back into the message
-            status = msg->SetPdu(recv_status, tmppdu, fromaddress);
+        UdpAddress fromaddress;
+        OctetStr   engine_id;
 
-            if (status)
-            {
-                // received pdu does not match
-                // TODO: if version is SNMPv3 we must return a report
-                //       unknown pdu handler!
-                unlock();
-                continue;
-            }
+        m_recvPdu.clear();
 
-#    ifdef _SNMPv3
-            if (engine_id.len() > 0)
-            {
-                SnmpTarget* target = msg->GetTarget();
-                if ((target->get_type() == SnmpTarget::type_utarget)
-                    && (target->get_version() == version3))
-                {
-                    if (tmppdu.get_type() == sNMP_PDU_REPORT
-                        || tmppdu.get_type() == sNMP_PDU_RESPONSE)
-                    {
-                        UdpAddress const addr = target->get_address();
-
-                        LOG_BEGIN(loggerModuleName, DEBUG_LOG | 14);
-                        LOG("MsgQueue: Adding engine id to table (addr) (id)");
-                        LOG(addr.get_printable());
-                        LOG(engine_id.get_printable());
-                        LOG_END;
-                        m_snmpSession->get_mpv3()->add_to_engine_id_table(
-                            engine_id, (char*)addr.IpAddress::get_printable(),
-                            addr.get_port());
-                    }
-                }
-            }
-#    endif
+        // put the response into a Pdu, the arena only holds the raw
+        // pdu while decoding
+        int const recv_status = process_snmp_response(buffer,
+            m_recvLengths[i], m_recvFrom[i], *m_snmpSession, m_recvPdu,
+            fromaddress, engine_id, true, &m_recvArena);
+        m_recvArena.reset();
 
-            // Do the callback
-            msg->SetLocked(true);
+        if (m_recvPdu.get_request_id())
+        {
+            HandleResponse(recv_status, m_recvPdu, fromaddress, engine_id);
+        }
+    }
+    return count;
+}
+
+void CSNMPMessageQueue::HandleResponse(const int recv_status, Pdu& tmppdu,
+    const UdpAddress& fromaddress, const OctetStr& engine_id)
+{
+    uint32_t const temp_req_id  = tmppdu.get_request_id();
+    CSNMPMessage*  msg          = nullptr;
+    bool           redoGetEntry = false;
+    int            status       = 0;
+
+    do {
+        redoGetEntry = false;
+        lock(); // FIXME: not exception save! CK
+        // find the corresponding msg in the message queue
+        msg = GetEntry(temp_req_id);
+        if (msg && msg->IsLocked())
+        {
             unlock();
-            status = msg->Callback(SNMP_CLASS_ASYNC_RESPONSE);
-            lock();
-            msg->SetLocked(false);
+            // TODO: should we sleep here?
+            redoGetEntry = true;
+        }
+    } while (redoGetEntry);
 
-            if (!status)
+    if (!msg)
+    {
+        unlock();
+        LOG_BEGIN(loggerModuleName, INFO_LOG | 7);
+        LOG("MsgQueue: Ignore received message without outstanding "
+            "request (req id)");
+        LOG(tmppdu.get_request_id());
+        LOG_END;
+        // the sent message is gone! probably was canceled, ignore it
+        return;
+    }
+
+    // save pdu back into the message
+    status = msg->SetPdu(recv_status, tmppdu, fromaddress);
+
+    if (status)
+    {
+        // received pdu does not match
+        // TODO: if version is SNMPv3 we must return a report
+        //       unknown pdu handler!
+        unlock();
+        return;
+    }
+#ifdef POSIX_THREADS
+    msg->WakeWaiter();
+#endif
+
+    AddRttSample(msg);
+
+#ifdef _SNMPv3
+    if (engine_id.len() > 0)
+    {
+        SnmpTarget* target = msg->GetTarget();
+        if ((target->get_type() == SnmpTarget::type_utarget)
+            && (target->get_version() == version3))
+        {
+            if (tmppdu.get_type() == sNMP_PDU_REPORT
+                || tmppdu.get_type() == sNMP_PDU_RESPONSE)
             {
-                // this is an asynch response and the callback is done.
-                // no need to keep this message around;
-                // Dequeue the message
-                DeleteEntry(temp_req_id);
+                UdpAddress const addr = target->get_address();
+
+                LOG_BEGIN(loggerModuleName, DEBUG_LOG | 14);
+                LOG("MsgQueue: Adding engine id to table (addr) (id)");
+                LOG(addr.get_printable());
+                LOG(engine_id.get_printable());
+                LOG_END;
+                m_snmpSession->get_mpv3()->add_to_engine_id_table(engine_id,
+                    (char*)addr.IpAddress::get_printable(), addr.get_port());
             }
-            unlock();
-        } // if socket has data
-    }     // for all sockets
-    return SNMP_CLASS_SUCCESS;
+        }
+    }
+#else
+    (void)engine_id;
+#endif
+
+    // Do the callback
+    msg->SetLocked(true);
+    unlock();
+    status = msg->Callback(SNMP_CLASS_ASYNC_RESPONSE);
+    lock();
+    msg->SetLocked(false);
+
+    if (!status)
+    {
+        // this is an asynch response and the callback is done.
+        // no need to keep this message around;
+        // Dequeue the message
+        DeleteEntry(temp_req_id);
+    }
+    unlock();
 }
 
-#endif // HAVE_POLL_SYSCALL
+bool CSNMPMessageQueue::HandleViewResponse(const PduView& view)
+{
+    uint32_t const req_id = view.get_request_id();
+    CSNMPMessage*  msg    = nullptr;
+
+    lock(); // FIXME: not exception save! CK
+    while ((msg = GetEntry(req_id)) && msg->IsLocked())
+    {
+        unlock();
+        // TODO: should we sleep here?
+        lock();
+    }
+
+    if (!msg || !msg->IsViewRequest())
+    {
+        unlock();
+        return false;
+    }
+
+    if (!msg->SetViewReceived(view.get_type()))
+    {
+        unlock();
+        return true; // ignored like in HandleResponse()
+    }
+
+    AddRttSample(msg);
+
+    // Do the callback
+    msg->SetLocked(true);
+    unlock();
+    int const status = msg->Callback(SNMP_CLASS_ASYNC_RESPONSE, view);
+    lock();
+    msg->SetLocked(false);
+
+    if (!status)
+    {
+        DeleteEntry(req_id);
+    }
+    unlock();
+    return true;
+}
+
+void CSNMPMessageQueue::AddRttSample(CSNMPMessage* msg)
+{
+    uint32_t rtt = 0;
+    if (msg->GetTarget()->get_adaptive_timeout() && msg->GetRoundTripTime(rtt))
+    {
+        m_rtt.AddSample(msg->GetAddress(), rtt);
+
+        LOG_BEGIN(loggerModuleName, DEBUG_LOG | 14);
+        LOG("MsgQueue: Measured round trip time (addr) (rtt) (timeout)");
+        LOG(msg->GetAddress().get_printable());
+        LOG(rtt);
+        LOG(m_rtt.GetTimeout(msg->GetAddress(), 0));
+        LOG_END;
+    }
+}
 
 int CSNMPMessageQueue::DoRetries(const msec& now)
 {
-    CSNMPMessage* msg = nullptr;
-    msec          sendTime(0, 0);
-    int           status = SNMP_CLASS_SUCCESS;
+    CSNMPMessageQueueElt* msgEltPtr = nullptr;
+    msec                  sendTime(0, 0);
+    int                   status = SNMP_CLASS_SUCCESS;
 
     lock(); // FIXME: not exception save! CK
-    while ((msg = GetNextTimeoutEntry()))
+    while ((msgEltPtr = GetNextTimeoutElt()))
     {
+        CSNMPMessage* msg = msgEltPtr->GetMessage();
         msg->GetSendTime(sendTime);
 
         if (sendTime > now)
         {
             break; // the next timeout is still in the future...so we are done
         }
+        if (msg->GetLimiterState() == CSNMPMessage::limiter_queued)
+        {
+            // first queued message waiting for a token, reschedules it
+            SendQueued(msg->GetAddress(), now);
+            continue;
+        }
         if (msg->IsLocked())
         {
             unlock();
@@ -867,6 +1152,15 @@ int CSNMPMessageQueue::DoRetries(const msec& now)
         status = msg->ResendMessage();
         lock();
         msg->SetLocked(false);
+        // ResendMessage() has set the time for the next retry
+        msg->GetSendTime(sendTime);
+        m_timeouts.Update(msgEltPtr, sendTime);
+        if ((status == SNMP_CLASS_SUCCESS) && !msg->GetReceived()
+            && msg->GetTarget()->get_adaptive_timeout())
+        {
+            // following requests start with the backed off timeout
+            m_rtt.Backoff(msg->GetAddress(), msg->GetRetransmitTimeout());
+        }
         if (status != 0)
         {
             if (status == SNMP_CLASS_TIMEOUT)
@@ -902,6 +1196,80 @@ int CSNMPMessageQueue::DoRetries(const msec& now)
     return status;
 }
 
+void CSNMPMessageQueue::SendQueued(const Address& address, const msec& now)
+{
+    CSNMPMessage* msg = nullptr;
+
+    while ((msg = m_limiter.GetFirst(address)))
+    {
+        CSNMPMessageQueueElt* elt   = IndexFind(msg->GetId());
+        uint32_t              delay = 0;
+        msec                  sendTime(now);
+
+        if (!m_limiter.Acquire(address, now, delay))
+        {
+            if (!delay)
+            {
+                // sent when the response for another request arrives
+                m_timeouts.Remove(elt);
+                return;
+            }
+            // no token available, try again when the next one is
+            sendTime += delay;
+            msg->SetSendTime(sendTime);
+        }
+        else
+        {
+            m_limiter.Remove(msg);
+            msg->SetLimiterState(CSNMPMessage::limiter_in_flight);
+            if (msg->SendMessage() != SNMP_CLASS_SUCCESS)
+            {
+                // the retry will send it again
+                LOG_BEGIN(loggerModuleName, WARNING_LOG | 3);
+                LOG("MsgQueue: Failed to send queued message (req id)");
+                LOG(msg->GetId());
+                LOG_END;
+            }
+            msg->GetSendTime(sendTime);
+        }
+
+        if (elt->InTimeoutHeap())
+        {
+            m_timeouts.Update(elt, sendTime);
+        }
+        else
+        {
+            m_timeouts.Insert(elt, sendTime);
+        }
+        if (delay)
+        {
+            return;
+        }
+    }
+}
+
+void CSNMPMessageQueue::SetLimits(
+    const int maxInFlight, const uint32_t maxRate, const uint32_t burst)
+{
+    lock(); // FIXME: not exception save! CK
+    m_limiter.SetLimits(maxInFlight, maxRate, burst);
+    unlock();
+}
+
+void CSNMPMessageQueue::GetLimiterCounters(
+    uint32_t& queued, uint32_t& throttled)
+{
+    lock(); // FIXME: not exception save! CK
+    queued    = m_limiter.GetQueued();
+    throttled = m_limiter.GetThrottled();
+    unlock();
+}
+
+void CSNMPMessageQueue::DrainResponses(const SnmpSocket fd)
+{
+    while (ReceiveResponses(fd) > 0) { }
+}
+
 int CSNMPMessageQueue::Done() { return 0; }
 
 int CSNMPMessageQueue::Done(uint32_t id)
@@ -923,6 +1291,67 @@ int CSNMPMessageQueue::Done(uint32_t id)
     return 0;
 }
 
+bool CSNMPMessageQueue::WaitForResponse(
+    const uint32_t id, const int max_block_milliseconds)
+{
+#ifdef POSIX_THREADS
+    if (!m_snmpSession->is_running())
+    {
+        return false; // nobody else receives the response
+    }
+
+    CSNMPMessageWaiter waiter;
+    pthread_condattr_t attr;
+    struct timespec    deadline;
+
+    pthread_condattr_init(&attr);
+#    ifdef __APPLE__
+    clock_gettime(CLOCK_REALTIME, &deadline);
+#    else
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+#    endif
+    pthread_cond_init(&waiter.cond, &attr);
+    pthread_condattr_destroy(&attr);
+    waiter.done = false;
+
+    deadline.tv_sec += max_block_milliseconds / 1000;
+    deadline.tv_nsec += (max_block_milliseconds % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    lock(); // FIXME: not exception save! CK
+    CSNMPMessage* msg = GetEntry(id);
+    if (msg && !msg->GetReceived())
+    {
+        msg->SetWaiter(&waiter);
+        while (!waiter.done)
+        {
+            // on timeout the caller checks if the poll thread still runs
+            if (pthread_cond_timedwait(&waiter.cond, &_mutex, &deadline))
+            {
+                break;
+            }
+        }
+        if (!waiter.done)
+        {
+            msg->SetWaiter(nullptr); // not deleted, as done is not set
+        }
+    }
+    unlock();
+
+    pthread_cond_destroy(&waiter.cond);
+    return true;
+#else
+    (void)id;
+    (void)max_block_milliseconds;
+    return false;
+#endif
+}
+
 #ifdef SNMP_PP_NAMESPACE
 } // end of namespace Snmp_pp
 #endif
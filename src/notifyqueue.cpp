@@ -704,6 +704,9 @@ int CNotifyEventQueue::AddEntry(
             return SNMP_CLASS_TL_UNSUPPORTED;
 #endif
         } // not is_v4_address
+#ifdef HAVE_EPOLL_SYSCALL
+        my_holder->RegisterFd(m_notify_fd, POLLIN, this);
+#endif
     }
 
     auto* newEvent = new CNotifyEvent(snmp, trapids, targets);
@@ -722,6 +725,9 @@ void CNotifyEventQueue::cleanup()
 {
     if (m_notify_fd != INVALID_SOCKET)
     {
+#ifdef HAVE_EPOLL_SYSCALL
+        my_holder->UnregisterFd(m_notify_fd);
+#endif
         close(m_notify_fd);
         m_notify_fd = INVALID_SOCKET;
     }
@@ -766,6 +772,9 @@ CNotifyEvent* CNotifyEventQueue::GetEntry(Snmp* snmp) REENTRANT({
         {
             debugprintf(3, "Closing notifications port %s, fd %d.",
                 m_notify_addr.get_printable(), m_notify_fd);
+#ifdef HAVE_EPOLL_SYSCALL
+            my_holder->UnregisterFd(m_notify_fd);
+#endif
             close(m_notify_fd);
             m_notify_fd = INVALID_SOCKET;
         }
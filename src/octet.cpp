@@ -175,6 +175,20 @@ OctetStr::OctetStr(const OctetStr& octet)
     }
 }
 
+//============[ move constructor ]====================================
+OctetStr::OctetStr(OctetStr&& octet) noexcept
+    : output_buffer(nullptr), output_buffer_len(0), m_changed(true),
+      validity(octet.validity)
+{
+    smival.syntax           = sNMP_SYNTAX_OCTETS;
+    smival.value.string.ptr = octet.smival.value.string.ptr;
+    smival.value.string.len = octet.smival.value.string.len;
+
+    octet.smival.value.string.ptr = nullptr;
+    octet.smival.value.string.len = 0;
+    octet.m_changed               = true;
+}
+
 //=============[ destructor ]=========================================
 OctetStr::~OctetStr()
 {
@@ -250,6 +264,26 @@ OctetStr& OctetStr::operator=(const OctetStr& octet)
     return *this; // return self reference
 }
 
+//=============[ move assignment ]=====================================
+OctetStr& OctetStr::operator=(OctetStr&& octet) noexcept
+{
+    if ((this == &octet) || !octet.validity)
+    {
+        return *this; // don't assign from self or invalid objs
+    }
+    delete[] smival.value.string.ptr;
+    smival.value.string.ptr = octet.smival.value.string.ptr;
+    smival.value.string.len = octet.smival.value.string.len;
+    m_changed               = true;
+    validity                = true;
+
+    octet.smival.value.string.ptr = nullptr;
+    octet.smival.value.string.len = 0;
+    octet.m_changed               = true;
+
+    return *this;
+}
+
 //==============[ equivlence operator overloaded ]====================
 int operator==(const OctetStr& lhs, const OctetStr& rhs)
 {
@@ -149,15 +149,10 @@ Oid& Oid::operator+=(const char* a)
 // copy data from raw form...
 void Oid::set_data(const SmiUINT32* raw_oid, const size_t oid_len)
 {
-    if (smival.value.oid.len < oid_len)
+    if (oid_capacity() < oid_len)
     {
         delete_oid_ptr();
-
-        smival.value.oid.ptr = (SmiLPUINT32) new uint32_t[oid_len];
-        if (!smival.value.oid.ptr)
-        {
-            return;
-        }
+        alloc_oid_ptr((uint32_t)oid_len);
     }
     memcpy((SmiLPBYTE)smival.value.oid.ptr, (SmiLPBYTE)raw_oid,
         (size_t)(oid_len * sizeof(SmiUINT32)));
@@ -168,15 +163,10 @@ void Oid::set_data(const SmiUINT32* raw_oid, const size_t oid_len)
 // Set the data from raw form.
 void Oid::set_data(const char* str, const size_t str_len)
 {
-    if (smival.value.oid.len < str_len)
+    if (oid_capacity() < str_len)
     {
         delete_oid_ptr();
-
-        smival.value.oid.ptr = (SmiLPUINT32) new uint32_t[str_len];
-        if (!smival.value.oid.ptr)
-        {
-            return;
-        }
+        alloc_oid_ptr((uint32_t)str_len);
     }
 
     if ((!str) || (str_len == 0))
@@ -265,7 +255,10 @@ int Oid::StrToOid(const char* str, SmiLPOID dstOid) const
 {
     uint32_t index = 0;
 
-    // make a temp buffer to copy the data into first
+    // make a temp buffer to copy the data into first, on the stack
+    // for short strings
+    SmiUINT32   local[SNMP_PP_OID_INLINE_LEN * 4];
+    SmiLPUINT32 heap = nullptr;
     SmiLPUINT32 temp = nullptr;
     uint32_t    nz   = 0;
 
@@ -279,12 +272,11 @@ int Oid::StrToOid(const char* str, SmiLPOID dstOid) const
         dstOid->ptr = nullptr;
         return -1;
     }
-    temp = (SmiLPUINT32) new uint32_t[nz];
-
-    if (temp == nullptr)
+    if (nz > SNMP_PP_OID_INLINE_LEN * 4)
     {
-        return -1; // return if can't get the mem
+        heap = (SmiLPUINT32) new uint32_t[nz];
     }
+    temp = heap ? heap : local;
     while ((*str) && (index < nz))
     {
         // skip over the dot
@@ -307,7 +299,7 @@ int Oid::StrToOid(const char* str, SmiLPOID dstOid) const
             // there must be a dot or end of string now
             if ((*str) && (*str != '.'))
             {
-                delete[] temp;
+                delete[] heap;
                 return -1;
             }
         }
@@ -318,7 +310,7 @@ int Oid::StrToOid(const char* str, SmiLPOID dstOid) const
             // found String -> converting it into an oid
             if (*str != '$')
             {
-                delete[] temp;
+                delete[] heap;
                 return -1;
             }
 
@@ -335,7 +327,7 @@ int Oid::StrToOid(const char* str, SmiLPOID dstOid) const
 
             if (*str != '$')
             {
-                delete[] temp;
+                delete[] heap;
                 return -1;
             }
 
@@ -345,19 +337,20 @@ int Oid::StrToOid(const char* str, SmiLPOID dstOid) const
             // there must be a dot or end of string now
             if ((*str) && (*str != '.'))
             {
-                delete[] temp;
+                delete[] heap;
                 return -1;
             }
         }
     }
 
-    // get some space for the real oid
-    dstOid->ptr = (SmiLPUINT32) new uint32_t[index];
-    // return if can't get the mem needed
-    if (dstOid->ptr == nullptr)
+    // get some space for the real oid, the inline buffer if it is ours
+    if (dstOid == &smival.value.oid)
     {
-        delete[] temp;
-        return -1;
+        PP_CONST_CAST(Oid*, this)->alloc_oid_ptr(index);
+    }
+    else
+    {
+        dstOid->ptr = (SmiLPUINT32) new uint32_t[index];
     }
 
     // copy in the temp data
@@ -368,7 +361,7 @@ int Oid::StrToOid(const char* str, SmiLPOID dstOid) const
     dstOid->len = index;
 
     // free up temp data
-    delete[] temp;
+    delete[] heap;
 
     return (int)index;
 }
@@ -423,19 +416,17 @@ SnmpSyntax& Oid::operator=(const SnmpSyntax& val)
     {
         return *this; // protect against assignment from self
     }
-    delete_oid_ptr();
 
-    // assign new value
-    if (val.valid())
+    // assign new value, reusing the memory
+    if (val.valid() && (val.get_syntax() == sNMP_SYNTAX_OID)
+        && ((const Oid&)val).len())
     {
-        switch (val.get_syntax())
-        {
-        case sNMP_SYNTAX_OID: {
-            set_data(((Oid&)val).smival.value.oid.ptr,
-                (unsigned int)((Oid&)val).smival.value.oid.len);
-            break;
-        }
-        }
+        set_data(((Oid&)val).smival.value.oid.ptr,
+            (unsigned int)((Oid&)val).smival.value.oid.len);
+    }
+    else
+    {
+        delete_oid_ptr();
     }
     return *this;
 }
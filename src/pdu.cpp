@@ -60,13 +60,14 @@
 #include "snmp_pp/vb.h"
 
 #include <libsnmp.h>
+#include <new>
 
 #ifdef SNMP_PP_NAMESPACE
 namespace Snmp_pp
 {
 #endif
 
-#define PDU_INITIAL_SIZE 25
+#define PDU_INITIAL_SIZE 4
 
 //=====================[ constructor no args ]=========================
 Pdu::Pdu()
@@ -91,69 +92,24 @@ Pdu::Pdu(Vb* pvbs, const int pvb_count)
       maxsize_scopedpdu(0)
 #endif
 {
-    if (pvb_count == 0)
+    if (pvb_count <= 0)
     {
         return; // zero is ok
     }
-    vbs = new Vb*[pvb_count];
-    if (vbs)
-    {
-        vbs_size = pvb_count;
-    }
-    else
+    if (!copy_vbs(pvbs, pvb_count))
     {
-        vbs_size = 0;
         validity = false;
-        return;
-    }
-
-    // loop through and assign internal vbs
-    for (int z = 0; z < pvb_count; ++z)
-    {
-        if (pvbs[z].valid())
-        {
-            vbs[z] = new Vb(pvbs[z]);
-        }
-        else
-        {
-            vbs[z] = nullptr;
-        }
-
-        if ((vbs[z]) && !vbs[z]->valid())
-        {
-            delete vbs[z];
-            vbs[z] = nullptr;
-        }
-
-        if (vbs[z] == nullptr) // check for new fail
-        {
-            for (int y = 0; y < z; ++y)
-            {
-                delete vbs[y]; // free vbs
-            }
-            validity = false;
-            return;
-        }
     }
-
-    vb_count = pvb_count; // assign the vb count
 }
 
 //=====================[ destructor ]====================================
 Pdu::~Pdu()
 {
-    for (int z = 0; z < vb_count; ++z)
-    {
-        delete vbs[z];
-        vbs[z] = nullptr;
-    }
-
-    if (vbs)
-    {
-        delete[] vbs;
-        vbs      = nullptr;
-        vbs_size = 0;
-    }
+    destroy_vbs(0);
+    ::operator delete(vbs);
+    vbs      = nullptr;
+    vbs_size = 0;
+    vb_count = 0;
 }
 
 //=====================[ assignment to another Pdu object overloaded ]===
@@ -184,68 +140,87 @@ Pdu& Pdu::operator=(const Pdu& pdu)
         v1_trap_address = pdu.v1_trap_address;
     }
 
-    validity = true;
+    // the old vbs are overwritten, so their memory is reused
+    validity = copy_vbs(pdu.vbs, pdu.vb_count);
 
-    // free up old vbs
-    for (int z = 0; z < vb_count; ++z)
+    return *this;
+}
+
+//=====================[ move from another Pdu object ]=================
+Pdu& Pdu::operator=(Pdu&& pdu) noexcept
+{
+    if (this == &pdu)
     {
-        delete vbs[z];
-        vbs[z] = nullptr;
+        return *this; // check for self assignment
     }
-    vb_count = 0;
-
-    // check for zero case
-    if (pdu.vb_count == 0)
+    error_status      = pdu.error_status;
+    error_index       = pdu.error_index;
+    request_id        = pdu.request_id;
+    pdu_type          = pdu.pdu_type;
+    notify_id         = std::move(pdu.notify_id);
+    notify_timestamp  = pdu.notify_timestamp;
+    notify_enterprise = std::move(pdu.notify_enterprise);
+#ifdef _SNMPv3
+    security_level    = pdu.security_level;
+    message_id        = pdu.message_id;
+    context_name      = std::move(pdu.context_name);
+    context_engine_id = std::move(pdu.context_engine_id);
+    maxsize_scopedpdu = pdu.maxsize_scopedpdu;
+#endif
+    v1_trap_address_set = pdu.v1_trap_address_set;
+    if (pdu.v1_trap_address_set)
     {
-        return *this;
+        v1_trap_address = std::move(pdu.v1_trap_address);
     }
+    validity = pdu.validity;
+
+    // swap the arrays, so the source can reuse ours
+    destroy_vbs(0);
+    std::swap(vbs, pdu.vbs);
+    std::swap(vbs_size, pdu.vbs_size);
+    vb_count     = pdu.vb_count;
+    pdu.vb_count = 0;
 
-    // allocate array
-    if (vbs_size < pdu.vb_count)
+    return *this;
+}
+
+// append operator, appends a variable binding
+Pdu& Pdu::operator+=(const Vb& vb)
+{
+    if (!vb.valid())
+    {
+        return *this; // dont add invalid Vbs
+    }
+    if (vb_count + 1 > vbs_size)
     {
-        delete[] vbs;
-        vbs = new Vb*[pdu.vb_count];
-        if (vbs)
+        if ((&vb >= vbs) && (&vb < vbs + vb_count))
         {
-            vbs_size = pdu.vb_count;
+            Vb const copy(vb); // vb is moved by extend_vbs()
+            return *this += copy;
         }
-        else
+        if (!extend_vbs())
         {
-            vbs_size = 0;
-            validity = false;
             return *this;
         }
     }
 
-    // loop through and fill em up
-    for (int y = 0; y < pdu.vb_count; ++y)
-    {
-        vbs[y] = new Vb(*(pdu.vbs[y]));
-
-        if ((vbs[y]) && !vbs[y]->valid())
-        {
-            delete vbs[y];
-            vbs[y] = nullptr;
-        }
+    new (vbs + vb_count) Vb(vb); // add the new one
 
-        if (!vbs[y])
-        {
-            for (int x = 0; x < y; ++x)
-            {
-                delete vbs[x]; // free vbs
-                vbs[x] = nullptr;
-            }
-            validity = false;
-            return *this;
-        }
+    if (vbs[vb_count].valid()) // up the vb count on success
+    {
+        ++vb_count;
+        validity = true; // set up validity
+    }
+    else
+    {
+        vbs[vb_count].~Vb();
     }
 
-    vb_count = pdu.vb_count;
-    return *this;
+    return *this; // return self reference
 }
 
-// append operator, appends a variable binding
-Pdu& Pdu::operator+=(const Vb& vb)
+// append operator, moves a variable binding into the pdu
+Pdu& Pdu::operator+=(Vb&& vb)
 {
     if (!vb.valid())
     {
@@ -253,29 +228,46 @@ Pdu& Pdu::operator+=(const Vb& vb)
     }
     if (vb_count + 1 > vbs_size)
     {
+        if ((&vb >= vbs) && (&vb < vbs + vb_count))
+        {
+            Vb tmp(std::move(vb)); // vb is moved by extend_vbs()
+            return *this += std::move(tmp);
+        }
         if (!extend_vbs())
         {
             return *this;
         }
     }
 
-    vbs[vb_count] = new Vb(vb); // add the new one
+    new (vbs + vb_count++) Vb(std::move(vb));
+    validity = true;
+
+    return *this;
+}
 
-    if (vbs[vb_count])          // up the vb count on success
+// append an empty vb that is filled by the caller
+Vb* Pdu::append_vb()
+{
+    if ((vb_count + 1 > vbs_size) && !extend_vbs())
     {
-        if (vbs[vb_count]->valid())
-        {
-            ++vb_count;
-            validity = true; // set up validity
-        }
-        else
-        {
-            delete vbs[vb_count];
-            vbs[vb_count] = nullptr;
-        }
+        return nullptr;
     }
 
-    return *this; // return self reference
+    Vb* const vb = new (vbs + vb_count) Vb;
+    ++vb_count;
+    validity = true;
+
+    return vb;
+}
+
+// make room for count vbs
+bool Pdu::reserve(const int count)
+{
+    if (count <= vbs_size)
+    {
+        return true;
+    }
+    return extend_vbs(count);
 }
 
 //=====================[ extract Vbs from Pdu ]==========================
@@ -289,7 +281,7 @@ int Pdu::get_vblist(Vb* pvbs, const int pvb_count) const
     // loop through all vbs and assign to params
     for (int z = 0; z < pvb_count; ++z)
     {
-        pvbs[z] = *vbs[z];
+        pvbs[z] = vbs[z];
         if (!pvbs[z].valid())
         {
             return false;
@@ -308,13 +300,10 @@ int Pdu::set_vblist(Vb const* pvbs, const int pvb_count)
         return false;
     }
 
-    // free up current vbs
-    for (int z = 0; z < vb_count; ++z) { delete vbs[z]; }
-    vb_count = 0;
-
     // check for zero case
     if (pvb_count == 0)
     {
+        destroy_vbs(0);
         validity     = true;
         error_status = 0;
         error_index  = 0;
@@ -322,54 +311,13 @@ int Pdu::set_vblist(Vb const* pvbs, const int pvb_count)
         return false;
     }
 
-    // allocate array
-    if (vbs_size < pvb_count)
+    // the current vbs are overwritten, so their memory is reused
+    if (!copy_vbs(pvbs, pvb_count))
     {
-        delete[] vbs;
-        vbs = new Vb*[pvb_count];
-        if (vbs)
-        {
-            vbs_size = pvb_count;
-        }
-        else
-        {
-            vbs_size = 0;
-            validity = false;
-            return false;
-        }
-    }
-
-    // loop through all vbs and reassign them
-    for (int y = 0; y < pvb_count; ++y)
-    {
-        if (pvbs[y].valid())
-        {
-            vbs[y] = new Vb(pvbs[y]);
-            if ((vbs[y]) && !vbs[y]->valid())
-            {
-                delete vbs[y];
-                vbs[y] = nullptr;
-            }
-        }
-        else
-        {
-            vbs[y] = nullptr;
-        }
-
-        // check for errors
-        if (!vbs[y])
-        {
-            for (int x = 0; x < y; ++x)
-            {
-                delete vbs[x]; // free vbs
-            }
-            validity = false;
-            return false;
-        }
+        validity = false;
+        return false;
     }
 
-    vb_count = pvb_count;
-
     // clear error status and index since no longer valid
     // request id may still apply so don't reassign it
     error_status = 0;
@@ -392,7 +340,7 @@ int Pdu::get_vb(Vb& vb, const int index) const
     {
         return false; // can't ask for something not there
     }
-    vb = *vbs[index]; // asssign it
+    vb = vbs[index]; // asssign it
 
     return vb.valid();
 }
@@ -410,29 +358,10 @@ int Pdu::set_vb(Vb const& vb, const int index)
     }
     if (!vb.valid())
     {
-        return false;        // don't set invalid vbs
+        return false; // don't set invalid vbs
     }
-    Vb* victim = vbs[index]; // save in case new fails
-    vbs[index] = new Vb(vb);
-    if (vbs[index])
-    {
-        if (vbs[index]->valid())
-        {
-            delete victim;
-        }
-        else
-        {
-            delete vbs[index];
-            vbs[index] = victim;
-            return false;
-        }
-    }
-    else
-    {
-        vbs[index] = victim;
-        return false;
-    }
-    return true;
+    vbs[index] = vb;
+    return vbs[index].valid();
 }
 
 // trim off the last vb
@@ -444,18 +373,7 @@ int Pdu::trim(const int count)
         return false;
     }
 
-    int lp = count;
-
-    while (lp != 0)
-    {
-        if (vb_count > 0)
-        {
-            delete vbs[vb_count - 1];
-            vbs[vb_count - 1] = nullptr;
-            vb_count--;
-        }
-        lp--;
-    }
+    destroy_vbs(vb_count - count);
     return true;
 }
 
@@ -468,11 +386,9 @@ int Pdu::delete_vb(const int p)
         return false;
     }
 
-    delete vbs[p]; // safe to remove it
+    for (int z = p; z < vb_count - 1; ++z) { vbs[z] = std::move(vbs[z + 1]); }
 
-    for (int z = p; z < vb_count - 1; ++z) { vbs[z] = vbs[z + 1]; }
-
-    vb_count--;
+    destroy_vbs(vb_count - 1);
 
     return true;
 }
@@ -503,7 +419,7 @@ int Pdu::get_asn1_length() const
     int length = 0;
 
     // length for all vbs
-    for (int i = 0; i < vb_count; ++i) { length += vbs[i]->get_asn1_length(); }
+    for (int i = 0; i < vb_count; ++i) { length += vbs[i].get_asn1_length(); }
 
     // header for vbs
     if (length < 0x80)
@@ -578,37 +494,70 @@ int Pdu::get_asn1_length() const
     return length;
 }
 
-// extend the vbs array
-bool Pdu::extend_vbs()
+// extend the vbs array, only the used part holds constructed vbs
+bool Pdu::extend_vbs(const int count)
+{
+    int new_size = count;
+    if (new_size <= 0)
+    {
+        new_size = (vbs_size < PDU_INITIAL_SIZE) ? PDU_INITIAL_SIZE
+                                                 : vbs_size * 2;
+    }
+
+    auto* tmp = static_cast<Vb*>(
+        ::operator new(new_size * sizeof(Vb), std::nothrow));
+    if (!tmp)
+    {
+        return false;
+    }
+
+    for (int y = 0; y < vb_count; ++y)
+    {
+        new (tmp + y) Vb(std::move(vbs[y]));
+        vbs[y].~Vb();
+    }
+    ::operator delete(vbs);
+    vbs      = tmp;
+    vbs_size = new_size;
+    return true;
+}
+
+// copy count vbs, assigning to the constructed ones reuses their memory
+bool Pdu::copy_vbs(const Vb* src, const int count)
 {
-    if (vbs_size == 0)
+    if ((vbs_size < count) && !extend_vbs(count))
     {
-        vbs = new Vb*[PDU_INITIAL_SIZE];
-        if (vbs)
+        destroy_vbs(0);
+        return false;
+    }
+
+    for (int y = 0; y < count; ++y)
+    {
+        if (y < vb_count)
         {
-            vbs_size = PDU_INITIAL_SIZE;
-            return true;
+            vbs[y] = src[y];
         }
         else
         {
+            new (vbs + y) Vb(src[y]);
+            ++vb_count;
+        }
+        if (!vbs[y].valid())
+        {
+            destroy_vbs(0);
             return false;
         }
     }
-
-    Vb** tmp = vbs;
-    vbs      = new Vb*[vbs_size * 2];
-    if (!vbs)
-    {
-        vbs = tmp;
-        return false;
-    }
-
-    for (int y = 0; y < vb_count; ++y) { vbs[y] = tmp[y]; }
-    vbs_size *= 2;
-    delete[] tmp;
+    destroy_vbs(count);
     return true;
 }
 
+// destroy the vbs from the given index on
+void Pdu::destroy_vbs(const int from)
+{
+    while (vb_count > from) { vbs[--vb_count].~Vb(); }
+}
+
 // Clear all members of the object
 void Pdu::clear()
 {
@@ -622,8 +571,7 @@ void Pdu::clear()
     v1_trap_address_set = false;
     validity            = true;
 
-    for (int z = 0; z < vb_count; ++z) { delete vbs[z]; }
-    vb_count = 0;
+    destroy_vbs(0); // keep the vbs array for reuse
 
 #ifdef _SNMPv3
     security_level    = SNMP_SECURITY_LEVEL_NOAUTH_NOPRIV;
@@ -0,0 +1,567 @@
+/*_############################################################################
+ * _##
+ * _##  pduview.cpp
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+
+#include "snmp_pp/pduview.h"
+
+#include "snmp_pp/asn1.h"
+#include "snmp_pp/snmperrs.h"
+#include "snmp_pp/snmpmsg.h"
+
+#include <libsnmp.h>
+
+#ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#endif
+
+// Parse the tag and length of a BER element within [data, end).
+// Returns the start of the contents or nullptr on error.
+static const unsigned char* view_parse_header(const unsigned char* data,
+    const unsigned char* end, unsigned char& type, size_t& len)
+{
+    if (end - data < 2)
+    {
+        return nullptr;
+    }
+    type = *data++;
+    if (IS_EXTENSION_ID(type))
+    {
+        return nullptr;
+    }
+
+    len = *data++;
+    if (len & ASN_LONG_LEN)
+    {
+        size_t lenOctets = len & ~ASN_LONG_LEN;
+        if ((lenOctets == 0) || (lenOctets > sizeof(uint32_t))
+            || ((size_t)(end - data) < lenOctets))
+        {
+            return nullptr;
+        }
+        len = 0;
+        while (lenOctets--) { len = (len << 8) | *data++; }
+    }
+    if ((size_t)(end - data) < len)
+    {
+        return nullptr;
+    }
+    return data;
+}
+
+// Parse an INTEGER element and advance data behind it
+static bool view_parse_int(
+    const unsigned char*& data, const unsigned char* end, int32_t& value)
+{
+    unsigned char type = 0;
+    size_t        len  = 0;
+
+    const unsigned char* p = view_parse_header(data, end, type, len);
+    if (!p || (type != ASN_INTEGER) || (len < 1) || (len > sizeof(value)))
+    {
+        return false;
+    }
+    uint32_t v = (*p & 0x80) ? 0xFFFFFFFFU : 0;
+    for (size_t i = 0; i < len; ++i) { v = (v << 8) | p[i]; }
+
+    value = (int32_t)v;
+    data  = p + len;
+    return true;
+}
+
+// Decode the next subidentifier, returns nullptr on error
+static const unsigned char* view_next_subid(
+    const unsigned char* p, const unsigned char* end, SmiUINT32& subid)
+{
+    uint32_t v = 0;
+
+    do {
+        if ((p == end) || (v > (MAX_SUBID >> 7)))
+        {
+            return nullptr; // truncated or too large
+        }
+        v = (v << 7) | (*p & ~ASN_BIT8);
+    } while (*p++ & ASN_BIT8);
+
+    subid = v;
+    return p;
+}
+
+//----[ OidView ]------------------------------------------------------
+
+unsigned int OidView::len() const
+{
+    unsigned int count = 0;
+
+    for (size_t i = 0; i < m_len; ++i)
+    {
+        if (!(m_data[i] & ASN_BIT8))
+        {
+            ++count;
+        }
+    }
+    // the first octet contains the first two subidentifiers
+    return count ? count + 1 : 0;
+}
+
+int OidView::get_subids(SmiUINT32* subids, const unsigned int max) const
+{
+    const unsigned char*       p     = m_data;
+    const unsigned char* const end   = m_data + m_len;
+    unsigned int               count = 0;
+
+    if (!m_len)
+    {
+        return 0;
+    }
+    while (p < end)
+    {
+        SmiUINT32 subid = 0;
+
+        p = view_next_subid(p, end, subid);
+        if (!p)
+        {
+            return -1;
+        }
+        if (count == 0)
+        {
+            // same handling of the first subidentifier as asn_parse_objid()
+            if (max < 2)
+            {
+                return -1;
+            }
+            subids[0] = (subid < 40) ? 0 : ((subid < 80) ? 1 : 2);
+            subids[1] = subid - (subids[0] * 40);
+            count     = 2;
+        }
+        else
+        {
+            if (count >= max)
+            {
+                return -1;
+            }
+            subids[count++] = subid;
+        }
+    }
+    return (int)count;
+}
+
+int OidView::compare(const Oid& oid) const
+{
+    SmiUINT32 subids[MAX_OID_LEN];
+    int const count = get_subids(subids, MAX_OID_LEN);
+
+    if (count < 0)
+    {
+        return 1; // invalid or too long for any Oid
+    }
+    uint32_t const length =
+        ((uint32_t)count < oid.len()) ? (uint32_t)count : oid.len();
+
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        if (subids[i] != oid[i])
+        {
+            return (subids[i] < oid[i]) ? -1 : 1;
+        }
+    }
+    if ((uint32_t)count == oid.len())
+    {
+        return 0;
+    }
+    return ((uint32_t)count < oid.len()) ? -1 : 1;
+}
+
+bool OidView::starts_with(const Oid& prefix) const
+{
+    SmiUINT32 subids[MAX_OID_LEN];
+    int const count = get_subids(subids, MAX_OID_LEN);
+
+    if ((count < 0) || ((uint32_t)count < prefix.len()))
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < prefix.len(); ++i)
+    {
+        if (subids[i] != prefix[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool OidView::to_oid(Oid& oid) const
+{
+    SmiUINT32 subids[MAX_OID_LEN];
+    int const count = get_subids(subids, MAX_OID_LEN);
+
+    if (count < 0)
+    {
+        return false;
+    }
+    oid.set_data(subids, (size_t)count);
+    return true;
+}
+
+//----[ VbView ]-------------------------------------------------------
+
+int VbView::get_value(int32_t& i) const
+{
+    if ((m_syntax != sNMP_SYNTAX_INT) || (m_valueLen < 1)
+        || (m_valueLen > sizeof(i)))
+    {
+        return SNMP_CLASS_INVALID;
+    }
+    uint32_t v = (m_value[0] & 0x80) ? 0xFFFFFFFFU : 0;
+    for (size_t k = 0; k < m_valueLen; ++k) { v = (v << 8) | m_value[k]; }
+
+    i = (int32_t)v;
+    return SNMP_CLASS_SUCCESS;
+}
+
+int VbView::get_value(uint32_t& i) const
+{
+    if (((m_syntax != sNMP_SYNTAX_CNTR32) && (m_syntax != sNMP_SYNTAX_GAUGE32)
+            && (m_syntax != sNMP_SYNTAX_TIMETICKS))
+        || (m_valueLen < 1) || (m_valueLen > sizeof(i) + 1)
+        || ((m_valueLen == sizeof(i) + 1) && m_value[0]))
+    {
+        return SNMP_CLASS_INVALID;
+    }
+    uint32_t v = 0;
+    for (size_t k = 0; k < m_valueLen; ++k) { v = (v << 8) | m_value[k]; }
+
+    i = v;
+    return SNMP_CLASS_SUCCESS;
+}
+
+int VbView::get_value(pp_uint64& i) const
+{
+    if ((m_syntax != sNMP_SYNTAX_CNTR64) || (m_valueLen < 1)
+        || (m_valueLen > sizeof(i) + 1)
+        || ((m_valueLen == sizeof(i) + 1) && m_value[0]))
+    {
+        return SNMP_CLASS_INVALID;
+    }
+    pp_uint64 v = 0;
+    for (size_t k = 0; k < m_valueLen; ++k) { v = (v << 8) | m_value[k]; }
+
+    i = v;
+    return SNMP_CLASS_SUCCESS;
+}
+
+int VbView::get_value(OidView& oid) const
+{
+    if (m_syntax != sNMP_SYNTAX_OID)
+    {
+        return SNMP_CLASS_INVALID;
+    }
+    oid = OidView(m_value, m_valueLen);
+    return SNMP_CLASS_SUCCESS;
+}
+
+int VbView::to_vb(Vb& vb) const
+{
+    Oid oid;
+
+    if (!m_oid.to_oid(oid))
+    {
+        return SNMP_CLASS_INVALID;
+    }
+    vb.set_oid(oid);
+
+    switch (m_syntax)
+    {
+    case sNMP_SYNTAX_OCTETS: {
+        vb.set_value(OctetStr(m_value, (uint32_t)m_valueLen));
+        break;
+    }
+    case sNMP_SYNTAX_OPAQUE: {
+        vb.set_value(OpaqueStr(m_value, (uint32_t)m_valueLen));
+        break;
+    }
+    case sNMP_SYNTAX_OID: {
+        Oid value;
+        if (!OidView(m_value, m_valueLen).to_oid(value))
+        {
+            return SNMP_CLASS_INVALID;
+        }
+        vb.set_value(value);
+        break;
+    }
+    case sNMP_SYNTAX_INT: {
+        int32_t i = 0;
+        if (get_value(i) != SNMP_CLASS_SUCCESS)
+        {
+            return SNMP_CLASS_INVALID;
+        }
+        vb.set_value(SnmpInt32(i));
+        break;
+    }
+    case sNMP_SYNTAX_TIMETICKS:
+    case sNMP_SYNTAX_CNTR32:
+    case sNMP_SYNTAX_GAUGE32: {
+        uint32_t i = 0;
+        if (get_value(i) != SNMP_CLASS_SUCCESS)
+        {
+            return SNMP_CLASS_INVALID;
+        }
+        if (m_syntax == sNMP_SYNTAX_TIMETICKS)
+        {
+            vb.set_value(TimeTicks(i));
+        }
+        else if (m_syntax == sNMP_SYNTAX_CNTR32)
+        {
+            vb.set_value(Counter32(i));
+        }
+        else
+        {
+            vb.set_value(Gauge32(i));
+        }
+        break;
+    }
+    case sNMP_SYNTAX_CNTR64: {
+        pp_uint64 i = 0;
+        if (get_value(i) != SNMP_CLASS_SUCCESS)
+        {
+            return SNMP_CLASS_INVALID;
+        }
+        vb.set_value(Counter64(i));
+        break;
+    }
+    case sNMP_SYNTAX_IPADDR: {
+        char buffer[42] {}; // same formatting as SnmpMessage::unload()
+
+        if (m_valueLen == 16)
+        {
+            snprintf(buffer, sizeof(buffer),
+                "%02x%02x:%02x%02x:%02x%02x:%02x%02x:"
+                "%02x%02x:%02x%02x:%02x%02x:%02x%02x",
+                m_value[0], m_value[1], m_value[2], m_value[3], m_value[4],
+                m_value[5], m_value[6], m_value[7], m_value[8], m_value[9],
+                m_value[10], m_value[11], m_value[12], m_value[13],
+                m_value[14], m_value[15]);
+        }
+        else if (m_valueLen == 4)
+        {
+            snprintf(buffer, sizeof(buffer), "%d.%d.%d.%d", m_value[0],
+                m_value[1], m_value[2], m_value[3]);
+        }
+        vb.set_value(IpAddress(buffer));
+        break;
+    }
+    case sNMP_SYNTAX_NOSUCHOBJECT:
+    case sNMP_SYNTAX_NOSUCHINSTANCE:
+    case sNMP_SYNTAX_ENDOFMIBVIEW: {
+        vb.set_exception_status(m_syntax);
+        break;
+    }
+    default: {
+        vb.set_null();
+    }
+    }
+    return SNMP_CLASS_SUCCESS;
+}
+
+//----[ PduView ]------------------------------------------------------
+
+PduView::PduView()
+    : m_msg(nullptr), m_msgLen(0), m_version(version1), m_community(nullptr),
+      m_communityLen(0), m_type(0), m_requestId(0), m_errorStatus(0),
+      m_errorIndex(0), m_vbs(nullptr), m_vbsEnd(nullptr), m_vbCount(0)
+{ }
+
+int PduView::parse(const unsigned char* data, const size_t len)
+{
+    const unsigned char* const end  = data + len;
+    const unsigned char*       p    = nullptr;
+    unsigned char              type = 0;
+    size_t                     elen = 0;
+    int32_t                    value = 0;
+
+    m_msg = nullptr;
+
+    // Message ::= SEQUENCE { version, community, PDU }
+    p = view_parse_header(data, end, type, elen);
+    if (!p || (type != ASN_SEQ_CON))
+    {
+        return SNMP_CLASS_ASN1ERROR;
+    }
+    const unsigned char* const msgEnd = p + elen;
+
+    if (!view_parse_int(p, msgEnd, value))
+    {
+        return SNMP_CLASS_ASN1ERROR;
+    }
+    if (value == SNMP_VERSION_1)
+    {
+        m_version = version1;
+    }
+    else if (value == SNMP_VERSION_2C)
+    {
+        m_version = version2c;
+    }
+    else
+    {
+        return SNMP_CLASS_BADVERSION;
+    }
+
+    p = view_parse_header(p, msgEnd, type, elen);
+    if (!p || (type != ASN_OCTET_STR))
+    {
+        return SNMP_CLASS_ASN1ERROR;
+    }
+    m_community    = p;
+    m_communityLen = elen;
+    p += elen;
+
+    // PDU ::= [type] { request-id, error-status, error-index, vbs }
+    p = view_parse_header(p, msgEnd, type, elen);
+    if (!p || (type == TRP_REQ_MSG) || ((type & 0xF0) != 0xA0))
+    {
+        return SNMP_CLASS_ASN1ERROR; // v1 traps have another layout
+    }
+    m_type                     = type;
+    const unsigned char* pduEnd = p + elen;
+
+    if (!view_parse_int(p, pduEnd, value))
+    {
+        return SNMP_CLASS_ASN1ERROR;
+    }
+    m_requestId = (uint32_t)value;
+    if (!view_parse_int(p, pduEnd, value))
+    {
+        return SNMP_CLASS_ASN1ERROR;
+    }
+    m_errorStatus = value;
+    if (!view_parse_int(p, pduEnd, value))
+    {
+        return SNMP_CLASS_ASN1ERROR;
+    }
+    m_errorIndex = value;
+
+    p = view_parse_header(p, pduEnd, type, elen);
+    if (!p || (type != ASN_SEQ_CON))
+    {
+        return SNMP_CLASS_ASN1ERROR;
+    }
+    m_vbs    = p;
+    m_vbsEnd = p + elen;
+
+    // check the structure of all variable bindings once, so accessing
+    // them later cannot fail
+    m_vbCount = 0;
+    while (p < m_vbsEnd)
+    {
+        const unsigned char* vb = view_parse_header(p, m_vbsEnd, type, elen);
+        if (!vb || (type != ASN_SEQ_CON))
+        {
+            return SNMP_CLASS_ASN1ERROR;
+        }
+        p                            = vb + elen;
+        const unsigned char* oid_ptr = view_parse_header(vb, p, type, elen);
+        if (!oid_ptr || (type != ASN_OBJECT_ID)
+            || !view_parse_header(oid_ptr + elen, p, type, elen))
+        {
+            return SNMP_CLASS_ASN1ERROR;
+        }
+        ++m_vbCount;
+    }
+
+    m_msg    = data;
+    m_msgLen = len;
+    return SNMP_CLASS_SUCCESS;
+}
+
+bool PduView::get_first_vb(VbView& vb) const
+{
+    if (!m_msg)
+    {
+        return false;
+    }
+    vb.m_next = m_vbs;
+    return get_next_vb(vb);
+}
+
+bool PduView::get_next_vb(VbView& vb) const
+{
+    unsigned char type = 0;
+    size_t        len  = 0;
+
+    if (!m_msg || !vb.m_next || (vb.m_next >= m_vbsEnd))
+    {
+        return false;
+    }
+
+    // the structure was checked by parse()
+    const unsigned char* p =
+        view_parse_header(vb.m_next, m_vbsEnd, type, len);
+    const unsigned char* end = p + len;
+
+    p        = view_parse_header(p, end, type, len);
+    vb.m_oid = OidView(p, len);
+
+    p             = view_parse_header(p + len, end, type, len);
+    vb.m_syntax   = type;
+    vb.m_value    = p;
+    vb.m_valueLen = len;
+    vb.m_next     = end;
+    return true;
+}
+
+bool PduView::get_vb(const int index, VbView& vb) const
+{
+    if ((index < 0) || (index >= m_vbCount) || !get_first_vb(vb))
+    {
+        return false;
+    }
+    for (int i = 0; i < index; ++i) { get_next_vb(vb); }
+    return true;
+}
+
+int PduView::to_pdu(Pdu& pdu) const
+{
+    if (!m_msg)
+    {
+        return SNMP_CLASS_INVALID;
+    }
+    SnmpMessage  snmpmsg;
+    OctetStr     community;
+    snmp_version version = version1;
+
+    int status = snmpmsg.load((unsigned char*)m_msg, (uint32_t)m_msgLen);
+    if (status != SNMP_CLASS_SUCCESS)
+    {
+        return status;
+    }
+    return snmpmsg.unload(pdu, community, version);
+}
+
+#ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#endif
@@ -0,0 +1,257 @@
+/*_############################################################################
+ * _##
+ * _##  preparedrequest.cpp
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+#include "snmp_pp/preparedrequest.h"
+
+#include "snmp_pp/asn1.h"
+#include "snmp_pp/snmperrs.h"
+#include "snmp_pp/snmpmsg.h"
+#include "snmp_pp/uxsnmp.h"
+#include "snmp_pp/v3.h"
+
+#include <libsnmp.h>
+
+#ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#endif
+
+// Skip the BER element at data, returns the start of the next element
+static unsigned char* prepared_skip(unsigned char* data, unsigned char* end)
+{
+    unsigned char type   = 0;
+    int           length = SAFE_INT_CAST(end - data);
+
+    data = asn_parse_header(data, &length, &type);
+    return data ? data + length : nullptr;
+}
+
+PreparedRequest::PreparedRequest()
+    : m_version(version1), m_message(nullptr), m_messageLen(0),
+      m_ridOffset(0), m_ridLen(0), m_tailOffset(0)
+{ }
+
+PreparedRequest::PreparedRequest(const Pdu& pdu, const unsigned short type,
+    const OctetStr& community, const snmp_version version,
+    const int non_repeaters, const int max_reps)
+    : m_version(version1), m_message(nullptr), m_messageLen(0),
+      m_ridOffset(0), m_ridLen(0), m_tailOffset(0)
+{
+    prepare(pdu, type, community, version, non_repeaters, max_reps);
+}
+
+PreparedRequest::~PreparedRequest() { clear(); }
+
+void PreparedRequest::clear()
+{
+    delete[] m_message;
+    m_message    = nullptr;
+    m_messageLen = 0;
+    m_ridOffset  = 0;
+    m_ridLen     = 0;
+    m_tailOffset = 0;
+}
+
+int PreparedRequest::prepare(const Pdu& pdu, const unsigned short type,
+    const OctetStr& community, const snmp_version version,
+    const int non_repeaters, const int max_reps)
+{
+    unsigned short pdu_type = 0;
+
+    clear();
+
+    switch (type)
+    {
+    case sNMP_PDU_GET:
+    case sNMP_PDU_GET_ASYNC: pdu_type = sNMP_PDU_GET; break;
+    case sNMP_PDU_GETNEXT:
+    case sNMP_PDU_GETNEXT_ASYNC: pdu_type = sNMP_PDU_GETNEXT; break;
+    case sNMP_PDU_GETBULK:
+    case sNMP_PDU_GETBULK_ASYNC: pdu_type = sNMP_PDU_GETBULK; break;
+    case sNMP_PDU_SET:
+    case sNMP_PDU_SET_ASYNC: pdu_type = sNMP_PDU_SET; break;
+    default: return SNMP_CLASS_INVALID_OPERATION;
+    }
+
+    if ((version != version1) && (version != version2c))
+    {
+        debugprintf(0, "-- SNMP++, only v1 and v2c requests are prepared");
+        return SNMP_CLASS_UNSUPPORTED;
+    }
+    if (!pdu.valid())
+    {
+        return SNMP_CLASS_INVALID_PDU;
+    }
+
+    //---------[ map GetBulk over v1 to GetNext ]-------------------------
+    if ((pdu_type == sNMP_PDU_GETBULK) && (version == version1))
+    {
+        pdu_type = sNMP_PDU_GETNEXT;
+    }
+
+    Pdu request(pdu);
+    request.set_type(pdu_type);
+    request.set_request_id(PDU_MAX_RID);
+    if (pdu_type == sNMP_PDU_GETBULK)
+    {
+        request.set_error_status(non_repeaters);
+        request.set_error_index(max_reps);
+    }
+    else
+    {
+        request.set_error_status(0);
+        request.set_error_index(0);
+    }
+
+    SnmpMessage snmpmsg;
+    int const   status = snmpmsg.load(request, community, version);
+    if (status != SNMP_CLASS_SUCCESS)
+    {
+        return status;
+    }
+
+    // find the request id: sequence, version, community, pdu, request id
+    unsigned char* const data   = snmpmsg.data();
+    unsigned char* const end    = data + snmpmsg.len();
+    unsigned char        tag    = 0;
+    int                  length = SAFE_INT_CAST(end - data);
+    unsigned char*       cp     = asn_parse_header(data, &length, &tag);
+
+    if (cp)
+    {
+        cp = prepared_skip(cp, end); // version
+    }
+    if (cp)
+    {
+        cp = prepared_skip(cp, end); // community
+    }
+    if (cp)
+    {
+        length = SAFE_INT_CAST(end - cp);
+        cp     = asn_parse_header(cp, &length, &tag); // pdu
+    }
+    if (cp)
+    {
+        length = SAFE_INT_CAST(end - cp);
+        cp     = asn_parse_header(cp, &length, &tag); // request id
+    }
+    if (cp == nullptr)
+    {
+        return SNMP_CLASS_INTERNAL_ERROR;
+    }
+
+    m_messageLen = SAFE_INT_CAST(snmpmsg.len());
+    m_message    = new unsigned char[m_messageLen];
+    memcpy(m_message, data, m_messageLen);
+    m_ridOffset  = SAFE_INT_CAST(cp - data);
+    m_ridLen     = length;
+    m_tailOffset = m_ridOffset + m_ridLen;
+
+    m_pdu.set_type(pdu_type);
+    m_community = community;
+    m_version   = version;
+
+    return SNMP_CLASS_SUCCESS;
+}
+
+int PreparedRequest::build(
+    const long request_id, unsigned char* buf, int* buf_len) const
+{
+    if (!m_message)
+    {
+        return SNMP_CLASS_INVALID_PDU;
+    }
+
+    unsigned char  ridBuf[8];
+    int            ridSpace = sizeof(ridBuf);
+    unsigned char* rid      = asn_rbuild_int(ridBuf + sizeof(ridBuf),
+        &ridSpace, ASN_UNI_PRIM | ASN_INTEGER, (SmiINT32)request_id);
+
+    // the header of the request id is always two octets long
+    int const ridLen = SAFE_INT_CAST(ridBuf + sizeof(ridBuf) - rid) - 2;
+
+    if (ridLen == m_ridLen)
+    {
+        if (*buf_len < m_messageLen)
+        {
+            return SNMP_CLASS_RESOURCE_UNAVAIL;
+        }
+        memcpy(buf, m_message, m_messageLen);
+        memcpy(buf + m_ridOffset, rid + 2, ridLen);
+        *buf_len = m_messageLen;
+        return SNMP_CLASS_SUCCESS;
+    }
+
+    // the length of the request id differs, so the headers are encoded
+    // again in front of the error status, error index and vbs
+    int const            tailLen = m_messageLen - m_tailOffset;
+    int                  length  = *buf_len;
+    unsigned char* const end     = buf + length;
+
+    if (length < tailLen)
+    {
+        return SNMP_CLASS_RESOURCE_UNAVAIL;
+    }
+    unsigned char* cp = end - tailLen;
+    memcpy(cp, m_message + m_tailOffset, tailLen);
+    length -= tailLen;
+
+    cp = asn_rbuild_int(
+        cp, &length, ASN_UNI_PRIM | ASN_INTEGER, (SmiINT32)request_id);
+    if (cp)
+    {
+        cp = asn_rbuild_header(cp, &length, (unsigned char)m_pdu.get_type(),
+            SAFE_INT_CAST(end - cp));
+    }
+    if (cp)
+    {
+        cp = asn_rbuild_string(cp, &length, ASN_UNI_PRIM | ASN_OCTET_STR,
+            m_community.data(), (int)m_community.len());
+    }
+    if (cp)
+    {
+        cp = asn_rbuild_int(
+            cp, &length, ASN_UNI_PRIM | ASN_INTEGER, (SmiINT32)m_version);
+    }
+    if (cp)
+    {
+        cp = asn_rbuild_header(
+            cp, &length, ASN_SEQ_CON, SAFE_INT_CAST(end - cp));
+    }
+    if (cp == nullptr)
+    {
+        return SNMP_CLASS_RESOURCE_UNAVAIL;
+    }
+
+    *buf_len = SAFE_INT_CAST(end - cp);
+    memmove(buf, cp, *buf_len);
+    return SNMP_CLASS_SUCCESS;
+}
+
+#ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#endif
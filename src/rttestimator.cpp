@@ -0,0 +1,91 @@
+/*_############################################################################
+ * _##
+ * _##  rttestimator.cpp
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+#include "snmp_pp/rttestimator.h"
+
+#include <libsnmp.h>
+
+#ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#endif
+
+uint32_t CRttEstimator::GetTimeout(
+    const Address& address, const uint32_t initial) const
+{
+    auto const* entry = m_table.Find(address);
+
+    return Bound((entry && entry->rto) ? entry->rto : initial);
+}
+
+void CRttEstimator::AddSample(const Address& address, const uint32_t rtt)
+{
+    bool  added = false;
+    auto* entry = m_table.FindOrAdd(address, added);
+    if (!entry)
+    {
+        return;
+    }
+
+    if (!entry->measured)
+    {
+        entry->srtt     = rtt;
+        entry->rttvar   = rtt / 2;
+        entry->measured = true;
+    }
+    else
+    {
+        uint32_t const delta =
+            (entry->srtt > rtt) ? entry->srtt - rtt : rtt - entry->srtt;
+
+        // RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R|, SRTT = 7/8 SRTT + 1/8 R
+        entry->rttvar = (3 * entry->rttvar + delta) / 4;
+        entry->srtt   = (7 * entry->srtt + rtt) / 8;
+    }
+    // RTO = SRTT + 4 RTTVAR, at least one clock tick of 1 ms
+    entry->rto =
+        Bound(entry->srtt + ((entry->rttvar > 0) ? 4 * entry->rttvar : 1));
+}
+
+void CRttEstimator::Backoff(const Address& address, const uint32_t timeout)
+{
+    bool  added = false;
+    auto* entry = m_table.FindOrAdd(address, added);
+    if (!entry)
+    {
+        return;
+    }
+
+    if (timeout > entry->rto)
+    {
+        entry->rto = Bound(timeout);
+    }
+}
+
+#ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#endif
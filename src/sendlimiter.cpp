@@ -0,0 +1,191 @@
+/*_############################################################################
+ * _##
+ * _##  sendlimiter.cpp
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+
+#include "snmp_pp/sendlimiter.h"
+
+#include "snmp_pp/msgqueue.h"
+
+#include <libsnmp.h>
+
+#ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#endif
+
+CSendLimiter::CSendLimiter()
+    : m_maxInFlight(0), m_maxRate(0), m_burst(1), m_queued(0),
+      m_throttled(0)
+{ }
+
+void CSendLimiter::SetLimits(
+    const int maxInFlight, const uint32_t maxRate, const uint32_t burst)
+{
+    m_maxInFlight = (maxInFlight > 0) ? maxInFlight : 0;
+    m_maxRate     = maxRate;
+    m_burst       = (burst > 0) ? burst : 1;
+}
+
+CSendLimiter::Entry* CSendLimiter::FindOrAdd(
+    const Address& address, const msec& now)
+{
+    bool   added = false;
+    Entry* entry = m_table.FindOrAdd(address, added);
+
+    if (added)
+    {
+        entry->tokens     = m_burst * 1000;
+        entry->lastRefill = now;
+    }
+    return entry;
+}
+
+bool CSendLimiter::Acquire(
+    const Address& address, const msec& now, uint32_t& delay)
+{
+    delay = 0;
+
+    Entry* entry = FindOrAdd(address, now);
+    if (!entry)
+    {
+        return true; // not limited
+    }
+
+    if (m_maxRate > 0)
+    {
+        time_t const   elapsed = (time_t)now - (time_t)entry->lastRefill;
+        uint64_t const full    = (uint64_t)m_burst * 1000;
+
+        if (elapsed > 0)
+        {
+            uint64_t const tokens =
+                entry->tokens + ((uint64_t)elapsed * m_maxRate);
+
+            entry->tokens     = (uint32_t)((tokens < full) ? tokens : full);
+            entry->lastRefill = now;
+        }
+        else if (entry->tokens > full)
+        {
+            entry->tokens = (uint32_t)full; // burst was reduced
+        }
+    }
+
+    if ((m_maxInFlight > 0) && (entry->inFlight >= m_maxInFlight))
+    {
+        return false; // wait for a response or timeout
+    }
+    if (m_maxRate > 0)
+    {
+        if (entry->tokens < 1000)
+        {
+            delay = (1000 - entry->tokens + m_maxRate - 1) / m_maxRate;
+            return false;
+        }
+        entry->tokens -= 1000;
+    }
+    entry->inFlight++;
+    return true;
+}
+
+void CSendLimiter::Release(const Address& address)
+{
+    Entry* entry = m_table.Find(address);
+
+    if (entry && (entry->inFlight > 0))
+    {
+        entry->inFlight--;
+    }
+}
+
+void CSendLimiter::Append(CSNMPMessage* message)
+{
+    Entry* entry = FindOrAdd(message->GetAddress(), msec());
+    if (!entry)
+    {
+        return;
+    }
+
+    message->m_limiterNext = nullptr;
+    message->m_limiterPrev = entry->last;
+    if (entry->last)
+    {
+        entry->last->m_limiterNext = message;
+    }
+    else
+    {
+        entry->first = message;
+    }
+    entry->last = message;
+    message->SetLimiterState(CSNMPMessage::limiter_queued);
+    m_queued++;
+    m_throttled++;
+}
+
+void CSendLimiter::Remove(CSNMPMessage* message)
+{
+    if (message->GetLimiterState() != CSNMPMessage::limiter_queued)
+    {
+        return;
+    }
+    Entry* entry = m_table.Find(message->GetAddress());
+    if (!entry)
+    {
+        return;
+    }
+
+    if (message->m_limiterPrev)
+    {
+        message->m_limiterPrev->m_limiterNext = message->m_limiterNext;
+    }
+    else
+    {
+        entry->first = message->m_limiterNext;
+    }
+    if (message->m_limiterNext)
+    {
+        message->m_limiterNext->m_limiterPrev = message->m_limiterPrev;
+    }
+    else
+    {
+        entry->last = message->m_limiterPrev;
+    }
+    message->m_limiterNext = nullptr;
+    message->m_limiterPrev = nullptr;
+    message->SetLimiterState(CSNMPMessage::limiter_none);
+    m_queued--;
+}
+
+CSNMPMessage* CSendLimiter::GetFirst(const Address& address) const
+{
+    Entry const* entry = m_table.Find(address);
+
+    return entry ? entry->first : nullptr;
+}
+
+#ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#endif
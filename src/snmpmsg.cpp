@@ -397,6 +397,7 @@ int SnmpMessage::load(
 
         temppdu = *pdu;
         temppdu.trim(temppdu.get_vb_count());
+        temppdu.reserve(pdu->get_vb_count() + 2);
 
         // vb #1 is the timestamp
         TimeTicks timestamp;
@@ -415,8 +416,7 @@ int SnmpMessage::load(
         // append the remaining vbs
         for (int z = 0; z < pdu->get_vb_count(); z++)
         {
-            pdu->get_vb(tempvb, z);
-            temppdu += tempvb;
+            temppdu += pdu->get_vb(z);
         }
 
         pdu = &temppdu; // reassign the pdu to the temp one
@@ -477,6 +477,9 @@ int SnmpMessage::load(
             return SNMP_CLASS_INVALID_TARGET;
         }
 
+        // the buffer size is sent as msgMaxSize, larger SNMPv3 messages
+        // are not supported
+        bufflen = (buffsize > MAX_SNMP_PACKET) ? MAX_SNMP_PACKET : buffsize;
         status =
             mpv3->snmp_build(raw_pdu, databuff, (int*)&bufflen, *engine_id,
                 *security_name, security_model, pdu->get_security_level(),
@@ -507,8 +510,11 @@ int SnmpMessage::load(
     }
     else
 #endif
-        status = snmp_build(raw_pdu, databuff, (int*)&bufflen, version,
+    {
+        bufflen = buffsize;
+        status  = snmp_build(raw_pdu, databuff, (int*)&bufflen, version,
             community.data(), (int)community.len());
+    }
 
     LOG_BEGIN(loggerModuleName, DEBUG_LOG | 4);
     LOG("SNMPMessage: return value for build message");
@@ -555,13 +561,40 @@ int SnmpMessage::load(
     return SNMP_CLASS_SUCCESS;
 }
 
+SnmpMessage::SnmpMessage(const unsigned int max_size)
+    : databuff(inlinebuff), buffsize(MAX_SNMP_PACKET),
+      bufflen(MAX_SNMP_PACKET), valid_flag(false), arena(nullptr)
+{
+    reserve(max_size);
+    bufflen = buffsize;
+}
+
+void SnmpMessage::reserve(unsigned int size)
+{
+    if (size > SNMP_PP_MAX_MESSAGE_SIZE)
+    {
+        size = SNMP_PP_MAX_MESSAGE_SIZE;
+    }
+    if (size <= buffsize)
+    {
+        return;
+    }
+    if (databuff != inlinebuff)
+    {
+        delete[] databuff;
+    }
+    databuff = new unsigned char[size];
+    buffsize = size;
+}
+
 // load up a SnmpMessage
 int SnmpMessage::load(unsigned char* data, uint32_t len)
 {
-    bufflen    = MAX_SNMP_PACKET;
     valid_flag = false;
+    reserve(len);
+    bufflen = buffsize;
 
-    if (len <= MAX_SNMP_PACKET)
+    if (len <= buffsize)
     {
         memcpy(
             (unsigned char*)databuff, (unsigned char*)data, (unsigned int)len);
@@ -591,7 +624,8 @@ int SnmpMessage::unload(Pdu& pdu,           // Pdu object
         return SNMP_CLASS_INVALID;
     }
 
-    snmp_pdu* raw_pdu = snmp_pdu_create(0); // free with snmp_free_pdu(raw_pdu)
+    // free with snmp_free_pdu(raw_pdu)
+    snmp_pdu* raw_pdu = snmp_pdu_create(0, arena);
     int       status  = 0;
 
 #ifdef _SNMPv3
@@ -727,6 +761,11 @@ int SnmpMessage::unload(Pdu& pdu,           // Pdu object
     struct variable_list* vp    = nullptr;
     int                   vb_nr = 1;
 
+    // size the vbs array once, a reused pdu keeps its array anyway
+    for (vp = raw_pdu->variables; vp; vp = vp->next_variable) { ++vb_nr; }
+    pdu.reserve(vb_nr - 1);
+    vb_nr = 1;
+
     for (vp = raw_pdu->variables; vp; vp = vp->next_variable, vb_nr++)
     {
         // extract the oid portion
@@ -738,9 +777,8 @@ int SnmpMessage::unload(Pdu& pdu,           // Pdu object
         {
         // octet string
         case sNMP_SYNTAX_OCTETS: {
-            OctetStr const octets(
+            tempvb.set_value(
                 (unsigned char*)vp->val.string, (uint32_t)vp->val_len);
-            tempvb.set_value(octets);
         }
         break;
 
@@ -869,7 +907,7 @@ int SnmpMessage::unload(Pdu& pdu,           // Pdu object
         } // end switch
 
         // append the vb to the pdu
-        pdu += tempvb;
+        pdu += std::move(tempvb);
     }
 
     snmp_free_pdu(raw_pdu);
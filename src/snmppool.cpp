@@ -0,0 +1,171 @@
+/*_############################################################################
+ * _##
+ * _##  snmppool.cpp
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+#include "snmp_pp/snmppool.h"
+
+#include "snmp_pp/addresstable.h"
+#include "snmp_pp/log.h"
+#include "snmp_pp/pdu.h"
+#include "snmp_pp/snmperrs.h"
+
+#include <libsnmp.h>
+
+#ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#endif
+
+#ifndef _NO_LOGGING
+static const char* loggerModuleName = "snmp++.snmppool";
+#endif
+
+SnmpPool::SnmpPool(int& status, const int count, const bool bind_ipv6)
+    : m_shards(nullptr), m_count(0), m_next(0)
+{
+    init(status, count, nullptr, bind_ipv6);
+}
+
+SnmpPool::SnmpPool(int& status, const int count, const UdpAddress& addr)
+    : m_shards(nullptr), m_count(0), m_next(0)
+{
+    init(status, count, &addr, false);
+}
+
+SnmpPool::~SnmpPool()
+{
+    stop_poll_threads();
+    for (int i = 0; i < m_count; ++i) { delete m_shards[i]; }
+    delete[] m_shards;
+}
+
+void SnmpPool::init(int& status, const int count, const UdpAddress* addr,
+    const bool bind_ipv6)
+{
+    if (count <= 0)
+    {
+        status = SNMP_CLASS_INVALID;
+        return;
+    }
+
+    m_shards = new Snmp*[count];
+    status   = SNMP_CLASS_SUCCESS;
+
+    // split the request ids, so they are unique within the pool
+    long const range = ((long)PDU_MAX_RID - PDU_MIN_RID + 1) / count;
+
+    for (m_count = 0; m_count < count; ++m_count)
+    {
+        Snmp* shard = nullptr;
+        if (addr)
+        {
+            UdpAddress bind_addr(*addr);
+            bind_addr.set_port(0); // each shard needs its own port
+            shard = new Snmp(status, bind_addr);
+        }
+        else
+        {
+            shard = new Snmp(status, 0, bind_ipv6);
+        }
+
+        if (status != SNMP_CLASS_SUCCESS)
+        {
+            LOG_BEGIN(loggerModuleName, ERROR_LOG | 1);
+            LOG("SnmpPool: Could not create shard (index) (status)");
+            LOG(m_count);
+            LOG(status);
+            LOG_END;
+
+            delete shard;
+            return;
+        }
+
+        long const range_min = PDU_MIN_RID + (m_count * range);
+        shard->set_request_id_range(range_min, range_min + range - 1);
+        m_shards[m_count] = shard;
+    }
+}
+
+Snmp* SnmpPool::get_shard(const int index)
+{
+    if ((index < 0) || (index >= m_count))
+    {
+        return nullptr;
+    }
+    return m_shards[index];
+}
+
+Snmp* SnmpPool::get_shard(const SnmpTarget& target)
+{
+    if (m_count <= 0)
+    {
+        return nullptr;
+    }
+
+    // hash of the address and port
+    const char*    str  = target.get_address().get_printable();
+    uint32_t const hash = fnv1a_hash((const unsigned char*)str, strlen(str));
+
+    return m_shards[hash % (uint32_t)m_count];
+}
+
+Snmp* SnmpPool::get_next_shard()
+{
+    if (m_count <= 0)
+    {
+        return nullptr;
+    }
+
+    lock();
+    int const index = m_next;
+    m_next          = (m_next + 1) % m_count;
+    unlock();
+
+    return m_shards[index];
+}
+
+bool SnmpPool::start_poll_threads(const int timeout)
+{
+    bool ok = (m_count > 0);
+
+    for (int i = 0; i < m_count; ++i)
+    {
+        if (!m_shards[i]->start_poll_thread(timeout))
+        {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+void SnmpPool::stop_poll_threads()
+{
+    for (int i = 0; i < m_count; ++i) { m_shards[i]->stop_poll_thread(); }
+}
+
+#ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#endif
@@ -0,0 +1,377 @@
+/*_############################################################################
+ * _##
+ * _##  snmpuring.cpp
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+#include "snmp_pp/snmpuring.h"
+
+#ifdef HAVE_IO_URING
+
+#    include "snmp_pp/log.h"
+#    include "snmp_pp/uxsnmp.h"
+#    include "snmp_pp/v3.h"
+
+#    include <linux/io_uring.h>
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+
+#    include <libsnmp.h>
+
+#    ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#    endif
+
+#    ifndef _NO_LOGGING
+static const char* loggerModuleName = "snmp++.uring";
+#    endif
+
+#    define URING_BUFFER_GROUP 0
+#    define URING_RECV_DATA    1 // user_data of the recvmsg request
+
+#    if (SNMP_PP_URING_BUFFERS & (SNMP_PP_URING_BUFFERS - 1)) != 0
+#        error "SNMP_PP_URING_BUFFERS must be a power of 2"
+#    endif
+
+static int uring_enter(int fd, unsigned to_submit)
+{
+    int ret = 0;
+    do {
+        ret = (int)syscall(
+            __NR_io_uring_enter, fd, to_submit, 0, 0, nullptr, 0);
+    } while ((ret < 0) && (EINTR == errno));
+    return ret;
+}
+
+SnmpUring::SnmpUring()
+    : m_socket(INVALID_SOCKET), m_ringFd(-1), m_sqRing(MAP_FAILED),
+      m_sqRingSize(0), m_cqRing(MAP_FAILED), m_cqRingSize(0),
+      m_sqes((struct io_uring_sqe*)MAP_FAILED), m_sqesSize(0),
+      m_sqTail(nullptr), m_sqMask(nullptr), m_sqArray(nullptr),
+      m_cqHead(nullptr), m_cqTail(nullptr), m_cqMask(nullptr),
+      m_cqes(nullptr), m_bufRing((struct io_uring_buf_ring*)MAP_FAILED),
+      m_bufRingSize(0), m_buffers(nullptr), m_bufferSize(0), m_bufTail(0)
+{
+    memset(&m_msg, 0, sizeof(m_msg));
+}
+
+SnmpUring::~SnmpUring() { cleanup(); }
+
+void SnmpUring::cleanup()
+{
+    // closing the ring cancels the recvmsg request
+    if (m_ringFd >= 0)
+    {
+        close(m_ringFd);
+        m_ringFd = -1;
+    }
+    if (m_bufRing != MAP_FAILED)
+    {
+        munmap(m_bufRing, m_bufRingSize);
+        m_bufRing = (struct io_uring_buf_ring*)MAP_FAILED;
+    }
+    if (m_sqes != MAP_FAILED)
+    {
+        munmap(m_sqes, m_sqesSize);
+        m_sqes = (struct io_uring_sqe*)MAP_FAILED;
+    }
+    if ((m_cqRing != MAP_FAILED) && (m_cqRing != m_sqRing))
+    {
+        munmap(m_cqRing, m_cqRingSize);
+    }
+    m_cqRing = MAP_FAILED;
+    if (m_sqRing != MAP_FAILED)
+    {
+        munmap(m_sqRing, m_sqRingSize);
+        m_sqRing = MAP_FAILED;
+    }
+    delete[] m_buffers;
+    m_buffers = nullptr;
+}
+
+bool SnmpUring::init(const SnmpSocket sock, const int buffer_size)
+{
+    struct io_uring_params params;
+
+    memset(&params, 0, sizeof(params));
+    params.flags      = IORING_SETUP_CQSIZE;
+    params.cq_entries = SNMP_PP_URING_BUFFERS * 2;
+
+    m_socket = sock;
+    m_ringFd = (int)syscall(__NR_io_uring_setup, 4, &params);
+    if (m_ringFd < 0)
+    {
+        LOG_BEGIN(loggerModuleName, INFO_LOG | 3);
+        LOG("SnmpUring: io_uring_setup failed (errno)");
+        LOG(errno);
+        LOG_END;
+        return false;
+    }
+    setCloseOnExecFlag(m_ringFd);
+
+    //----[ map the rings ]-------------------------------------------
+    m_sqRingSize =
+        params.sq_off.array + (params.sq_entries * sizeof(unsigned));
+    m_cqRingSize =
+        params.cq_off.cqes + (params.cq_entries * sizeof(struct io_uring_cqe));
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (m_cqRingSize > m_sqRingSize)
+        {
+            m_sqRingSize = m_cqRingSize;
+        }
+        m_cqRingSize = m_sqRingSize;
+    }
+
+    m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQ_RING);
+    if (m_sqRing == MAP_FAILED)
+    {
+        cleanup();
+        return false;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        m_cqRing = m_sqRing;
+    }
+    else
+    {
+        m_cqRing = mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_CQ_RING);
+        if (m_cqRing == MAP_FAILED)
+        {
+            cleanup();
+            return false;
+        }
+    }
+    m_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    m_sqes     = (struct io_uring_sqe*)mmap(nullptr, m_sqesSize,
+            PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd,
+            IORING_OFF_SQES);
+    if (m_sqes == MAP_FAILED)
+    {
+        cleanup();
+        return false;
+    }
+
+    unsigned char* sq = (unsigned char*)m_sqRing;
+    unsigned char* cq = (unsigned char*)m_cqRing;
+    m_sqTail          = (unsigned*)(sq + params.sq_off.tail);
+    m_sqMask          = (unsigned*)(sq + params.sq_off.ring_mask);
+    m_sqArray         = (unsigned*)(sq + params.sq_off.array);
+    m_cqHead          = (unsigned*)(cq + params.cq_off.head);
+    m_cqTail          = (unsigned*)(cq + params.cq_off.tail);
+    m_cqMask          = (unsigned*)(cq + params.cq_off.ring_mask);
+    m_cqes            = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    //----[ register the provided buffers ]-----------------------------
+    m_bufRingSize = SNMP_PP_URING_BUFFERS * sizeof(struct io_uring_buf);
+    m_bufRing     = (struct io_uring_buf_ring*)mmap(nullptr, m_bufRingSize,
+            PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (m_bufRing == MAP_FAILED)
+    {
+        cleanup();
+        return false;
+    }
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr    = (uintptr_t)m_bufRing;
+    reg.ring_entries = SNMP_PP_URING_BUFFERS;
+    reg.bgid         = URING_BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, m_ringFd, IORING_REGISTER_PBUF_RING,
+            &reg, 1)
+        < 0)
+    {
+        LOG_BEGIN(loggerModuleName, INFO_LOG | 3);
+        LOG("SnmpUring: Provided buffer rings not supported (errno)");
+        LOG(errno);
+        LOG_END;
+        cleanup();
+        return false;
+    }
+
+    // each buffer holds the recvmsg header, the sender and the datagram
+    m_msg.msg_namelen = sizeof(SocketAddrType);
+    m_bufferSize      = sizeof(struct io_uring_recvmsg_out)
+        + sizeof(SocketAddrType) + buffer_size;
+    m_buffers = new unsigned char[SNMP_PP_URING_BUFFERS * m_bufferSize];
+    for (unsigned short bid = 0; bid < SNMP_PP_URING_BUFFERS; ++bid)
+    {
+        add_buffer(bid);
+    }
+    __atomic_store_n(&m_bufRing->tail, m_bufTail, __ATOMIC_RELEASE);
+
+    if (!arm())
+    {
+        cleanup();
+        return false;
+    }
+
+    // Kernels without multishot recvmsg fail the request right away
+    unsigned const head = *m_cqHead;
+    if (head != __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE))
+    {
+        const struct io_uring_cqe* cqe = &m_cqes[head & *m_cqMask];
+        if ((cqe->res < 0) && (cqe->res != -ENOBUFS))
+        {
+            LOG_BEGIN(loggerModuleName, INFO_LOG | 3);
+            LOG("SnmpUring: Multishot recvmsg not supported (error)");
+            LOG(-cqe->res);
+            LOG_END;
+            cleanup();
+            return false;
+        }
+    }
+
+    LOG_BEGIN(loggerModuleName, DEBUG_LOG | 5);
+    LOG("SnmpUring: Receiving with io_uring (socket) (ring fd)");
+    LOG(m_socket);
+    LOG(m_ringFd);
+    LOG_END;
+    return true;
+}
+
+// Submit the multishot recvmsg request. The request is bound to the
+// calling thread, if it exits the request completes with -ECANCELED
+// and is submitted again by the next receive().
+bool SnmpUring::arm()
+{
+    unsigned const     tail = *m_sqTail;
+    unsigned const     idx  = tail & *m_sqMask;
+    struct io_uring_sqe* sqe  = &m_sqes[idx];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode    = IORING_OP_RECVMSG;
+    sqe->fd        = m_socket;
+    sqe->addr      = (uintptr_t)&m_msg;
+    sqe->len       = 1;
+    sqe->flags     = IOSQE_BUFFER_SELECT;
+    sqe->ioprio    = IORING_RECV_MULTISHOT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = URING_RECV_DATA;
+
+    m_sqArray[idx] = idx;
+    __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+
+    if (uring_enter(m_ringFd, 1) != 1)
+    {
+        LOG_BEGIN(loggerModuleName, ERROR_LOG | 1);
+        LOG("SnmpUring: Could not submit recvmsg (errno)");
+        LOG(errno);
+        LOG_END;
+        return false;
+    }
+    return true;
+}
+
+// Give a buffer back to the kernel, the new tail is published by the
+// caller.
+void SnmpUring::add_buffer(const unsigned short bid)
+{
+    // Not m_bufRing->bufs, in C++ the flexible array of the kernel
+    // header is placed behind an empty struct of size 1.
+    struct io_uring_buf* buf = (struct io_uring_buf*)m_bufRing
+        + (m_bufTail & (SNMP_PP_URING_BUFFERS - 1));
+
+    buf->addr = (uintptr_t)(m_buffers + (bid * m_bufferSize));
+    buf->len  = (uint32_t)m_bufferSize;
+    buf->bid  = bid;
+    m_bufTail++;
+}
+
+int SnmpUring::receive(unsigned char* buffers, const int buffer_size,
+    long* lengths, SocketAddrType* from_addrs, const int max_count)
+{
+    unsigned head  = *m_cqHead;
+    int      count = 0;
+    bool     rearm = false;
+
+    while (count < max_count)
+    {
+        if (head == __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE))
+        {
+            break;
+        }
+
+        const struct io_uring_cqe* cqe = &m_cqes[head & *m_cqMask];
+        if (!(cqe->flags & IORING_CQE_F_MORE))
+        {
+            rearm = true; // the request has ended
+        }
+        if ((cqe->res >= 0) && (cqe->flags & IORING_CQE_F_BUFFER))
+        {
+            auto const bid =
+                (unsigned short)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+            unsigned char* buf = m_buffers + (bid * m_bufferSize);
+            const auto*    out = (const struct io_uring_recvmsg_out*)buf;
+            long           len = (long)out->payloadlen;
+
+            // a longer datagram is truncated, as with recvfrom()
+            if (len > buffer_size)
+            {
+                len = buffer_size;
+            }
+            memset(&from_addrs[count], 0, sizeof(SocketAddrType));
+            memcpy(&from_addrs[count], buf + sizeof(*out),
+                (out->namelen < sizeof(SocketAddrType))
+                    ? out->namelen
+                    : sizeof(SocketAddrType));
+            memcpy(buffers + (count * buffer_size),
+                buf + sizeof(*out) + m_msg.msg_namelen, len);
+            lengths[count++] = len;
+
+            add_buffer(bid);
+        }
+        else if ((cqe->res < 0) && (cqe->res != -ENOBUFS)
+            && (cqe->res != -ECANCELED))
+        {
+            LOG_BEGIN(loggerModuleName, WARNING_LOG | 3);
+            LOG("SnmpUring: recvmsg failed (socket) (error)");
+            LOG(m_socket);
+            LOG(-cqe->res);
+            LOG_END;
+        }
+        head++;
+    }
+    __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+    __atomic_store_n(&m_bufRing->tail, m_bufTail, __ATOMIC_RELEASE);
+
+    if (rearm)
+    {
+        arm();
+    }
+    if (count > 0)
+    {
+        debugprintf(6, "Received %i datagrams through io_uring", count);
+    }
+    return count;
+}
+
+#    ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#    endif
+
+#endif // HAVE_IO_URING
@@ -53,6 +53,7 @@
 #include "snmp_pp/v3.h"
 
 #include <libsnmp.h>
+#include <utility>
 
 #ifdef SNMP_PP_NAMESPACE
 namespace Snmp_pp
@@ -110,6 +111,7 @@ SnmpTarget* SnmpTarget::clone() const
 
     res->set_timeout(timeout);
     res->set_retry(retries);
+    res->set_adaptive_timeout(adaptive_timeout);
     res->set_address(addr);
     res->set_version(version);
     return res;
@@ -135,17 +137,22 @@ int SnmpTarget::operator==(const SnmpTarget& rhs) const
     {
         return 0;
     }
+    if (adaptive_timeout != rhs.adaptive_timeout)
+    {
+        return 0;
+    }
     return 1; // they are equal
 }
 
 // reset the object
 void SnmpTarget::clear()
 {
-    validity = false;
-    timeout  = default_timeout;
-    retries  = default_retries;
-    version  = version1;
-    ttype    = type_base;
+    validity         = false;
+    timeout          = default_timeout;
+    retries          = default_retries;
+    adaptive_timeout = false;
+    version          = version1;
+    ttype            = type_base;
     my_address.clear();
 }
 
@@ -194,12 +201,27 @@ CTarget::CTarget(const CTarget& target)
     : SnmpTarget(), read_community(target.read_community),
       write_community(target.write_community)
 {
-    my_address = target.my_address;
-    timeout    = target.timeout;
-    retries    = target.retries;
-    version    = target.version;
-    validity   = target.validity;
-    ttype      = type_ctarget; // overwrite value set in SnmpTarget()
+    my_address       = target.my_address;
+    timeout          = target.timeout;
+    retries          = target.retries;
+    adaptive_timeout = target.adaptive_timeout;
+    version          = target.version;
+    validity         = target.validity;
+    ttype            = type_ctarget; // overwrite value set in SnmpTarget()
+}
+
+//---------[ move constructor ]-----------------------------------------
+CTarget::CTarget(CTarget&& target) noexcept
+    : SnmpTarget(), read_community(std::move(target.read_community)),
+      write_community(std::move(target.write_community))
+{
+    my_address       = std::move(target.my_address);
+    timeout          = target.timeout;
+    retries          = target.retries;
+    adaptive_timeout = target.adaptive_timeout;
+    version          = target.version;
+    validity         = target.validity;
+    ttype            = type_ctarget; // overwrite value set in SnmpTarget()
 }
 
 //----------[ CTarget::resolve_to_V1 ]---------------------------------
@@ -232,13 +254,32 @@ CTarget& CTarget::operator=(const CTarget& target)
     {
         return *this; // check for self assignment
     }
-    timeout         = target.timeout;
-    retries         = target.retries;
-    read_community  = target.read_community;
-    write_community = target.write_community;
-    validity        = target.validity;
-    my_address      = target.my_address;
-    version         = target.version;
+    timeout          = target.timeout;
+    retries          = target.retries;
+    adaptive_timeout = target.adaptive_timeout;
+    read_community   = target.read_community;
+    write_community  = target.write_community;
+    validity         = target.validity;
+    my_address       = target.my_address;
+    version          = target.version;
+    return *this;
+}
+
+//=============[ move assignment CTarget = CTarget ]=========================
+CTarget& CTarget::operator=(CTarget&& target) noexcept
+{
+    if (this == &target)
+    {
+        return *this; // check for self assignment
+    }
+    timeout          = target.timeout;
+    retries          = target.retries;
+    adaptive_timeout = target.adaptive_timeout;
+    read_community   = std::move(target.read_community);
+    write_community  = std::move(target.write_community);
+    validity         = target.validity;
+    my_address       = std::move(target.my_address);
+    version          = target.version;
     return *this;
 }
 
@@ -341,12 +382,31 @@ UTarget::UTarget(const UTarget& target)
       engine_id(target.engine_id)
 #endif
 {
-    my_address = target.my_address;
-    timeout    = target.timeout;
-    retries    = target.retries;
-    version    = target.version;
-    validity   = target.validity;
-    ttype      = type_utarget;
+    my_address       = target.my_address;
+    timeout          = target.timeout;
+    retries          = target.retries;
+    adaptive_timeout = target.adaptive_timeout;
+    version          = target.version;
+    validity         = target.validity;
+    ttype            = type_utarget;
+}
+
+// move constructor
+UTarget::UTarget(UTarget&& target) noexcept
+    : SnmpTarget(), security_name(std::move(target.security_name)),
+      security_model(target.security_model)
+#ifdef _SNMPv3
+      ,
+      engine_id(std::move(target.engine_id))
+#endif
+{
+    my_address       = std::move(target.my_address);
+    timeout          = target.timeout;
+    retries          = target.retries;
+    adaptive_timeout = target.adaptive_timeout;
+    version          = target.version;
+    validity         = target.validity;
+    ttype            = type_utarget;
 }
 
 // set the address
@@ -385,8 +445,9 @@ UTarget& UTarget::operator=(const UTarget& target)
     {
         return *this; // check for self assignment
     }
-    timeout = target.timeout;
-    retries = target.retries;
+    timeout          = target.timeout;
+    retries          = target.retries;
+    adaptive_timeout = target.adaptive_timeout;
 
 #ifdef _SNMPv3
     engine_id = target.engine_id;
@@ -401,6 +462,30 @@ UTarget& UTarget::operator=(const UTarget& target)
     return *this;
 }
 
+//=============[ move assignment UTarget = UTarget ]=========================
+UTarget& UTarget::operator=(UTarget&& target) noexcept
+{
+    if (this == &target)
+    {
+        return *this; // check for self assignment
+    }
+    timeout          = target.timeout;
+    retries          = target.retries;
+    adaptive_timeout = target.adaptive_timeout;
+
+#ifdef _SNMPv3
+    engine_id = std::move(target.engine_id);
+#endif
+    security_name  = std::move(target.security_name);
+    security_model = target.security_model;
+    version        = target.version;
+
+    validity   = target.validity;
+    my_address = std::move(target.my_address);
+
+    return *this;
+}
+
 //=============[ int operator == UTarget, UTarget ]==========================
 // equivlence operator overloaded
 int UTarget::operator==(const UTarget& rhs) const
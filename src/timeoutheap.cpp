@@ -0,0 +1,146 @@
+/*_############################################################################
+ * _##
+ * _##  timeoutheap.cpp
+ * _##
+ * _##  SNMP++ v3.4
+ * _##  -----------------------------------------------
+ * _##  Copyright (c) 2001-2021 Jochen Katz, Frank Fock
+ * _##
+ * _##  This software is based on SNMP++2.6 from Hewlett Packard:
+ * _##
+ * _##    Copyright (c) 1996
+ * _##    Hewlett-Packard Company
+ * _##
+ * _##  ATTENTION: USE OF THIS SOFTWARE IS SUBJECT TO THE FOLLOWING TERMS.
+ * _##  Permission to use, copy, modify, distribute and/or sell this software
+ * _##  and/or its documentation is hereby granted without fee. User agrees
+ * _##  to display the above copyright notice and this license notice in all
+ * _##  copies of the software and any documentation of the software. User
+ * _##  agrees to assume all liability for the use of the software;
+ * _##  Hewlett-Packard, Frank Fock, and Jochen Katz make no representations
+ * _##  about the suitability of this software for any purpose. It is provided
+ * _##  "AS-IS" without warranty of any kind, either express or implied. User
+ * _##  hereby grants a royalty-free license to any and all derivatives based
+ * _##  upon this software code base.
+ * _##
+ * _##########################################################################*/
+
+#include "snmp_pp/timeoutheap.h"
+
+#include <libsnmp.h>
+
+#ifdef SNMP_PP_NAMESPACE
+namespace Snmp_pp
+{
+#endif
+
+void CTimeoutHeap::Insert(CTimeoutHeapEntry* entry, const msec& timeout)
+{
+    if (m_count >= m_size)
+    {
+        int const newSize    = (m_size > 0) ? m_size * 2 : 64;
+        auto**    newEntries = new CTimeoutHeapEntry*[newSize];
+
+        for (int i = 0; i < m_count; ++i) { newEntries[i] = m_entries[i]; }
+        delete[] m_entries;
+        m_entries = newEntries;
+        m_size    = newSize;
+    }
+    entry->m_heapTime = timeout;
+    Place(entry, m_count++);
+    SiftUp(entry->m_heapPos);
+}
+
+void CTimeoutHeap::Update(CTimeoutHeapEntry* entry, const msec& timeout)
+{
+    if (entry->m_heapPos < 0)
+    {
+        return;
+    }
+    bool const earlier = timeout < entry->m_heapTime;
+
+    entry->m_heapTime = timeout;
+    if (earlier)
+    {
+        SiftUp(entry->m_heapPos);
+    }
+    else
+    {
+        SiftDown(entry->m_heapPos);
+    }
+}
+
+void CTimeoutHeap::Remove(CTimeoutHeapEntry* entry)
+{
+    int const pos = entry->m_heapPos;
+
+    if (pos < 0)
+    {
+        return;
+    }
+    entry->m_heapPos = -1;
+    if (--m_count == pos)
+    {
+        return; // was the last one
+    }
+
+    // move the last element into the hole and restore the heap order
+    CTimeoutHeapEntry* last = m_entries[m_count];
+    Place(last, pos);
+    if ((pos > 0) && (last->m_heapTime < m_entries[(pos - 1) / 2]->m_heapTime))
+    {
+        SiftUp(pos);
+    }
+    else
+    {
+        SiftDown(pos);
+    }
+}
+
+void CTimeoutHeap::SiftUp(int pos)
+{
+    CTimeoutHeapEntry* entry = m_entries[pos];
+
+    while (pos > 0)
+    {
+        int const parent = (pos - 1) / 2;
+        if (!(entry->m_heapTime < m_entries[parent]->m_heapTime))
+        {
+            break;
+        }
+        Place(m_entries[parent], pos);
+        pos = parent;
+    }
+    Place(entry, pos);
+}
+
+void CTimeoutHeap::SiftDown(int pos)
+{
+    CTimeoutHeapEntry* entry = m_entries[pos];
+
+    for (;;)
+    {
+        int child = (2 * pos) + 1;
+        if (child >= m_count)
+        {
+            break;
+        }
+        if ((child + 1 < m_count)
+            && (m_entries[child + 1]->m_heapTime
+                < m_entries[child]->m_heapTime))
+        {
+            ++child;
+        }
+        if (!(m_entries[child]->m_heapTime < entry->m_heapTime))
+        {
+            break;
+        }
+        Place(m_entries[child], pos);
+        pos = child;
+    }
+    Place(entry, pos);
+}
+
+#ifdef SNMP_PP_NAMESPACE
+} // end of namespace Snmp_pp
+#endif
@@ -166,6 +166,9 @@ UdId CUDEventQueue::AddEntry(const int fd, const UdInputMask mask,
     (void)new CUDEventQueueElt(newEvent, m_head.GetNext(), &m_head);
     m_msgCount++;
     unlock();
+#ifdef HAVE_EPOLL_SYSCALL
+    UpdateFdRegistration(fd);
+#endif
     return uniqueId;
 }
 
@@ -186,6 +189,8 @@ CUDEvent* CUDEventQueue::GetEntry(const UdId uniqueId) REENTRANT({
 
     void CUDEventQueue::DeleteEntry(const UdId uniqueId)
 {
+    int fd = -1;
+
     lock(); // FIXME: not exception save! CK
     CUDEventQueueElt* msgEltPtr = m_head.GetNext();
 
@@ -193,6 +198,7 @@ CUDEvent* CUDEventQueue::GetEntry(const UdId uniqueId) REENTRANT({
     {
         if (msgEltPtr->TestId(uniqueId))
         {
+            fd = msgEltPtr->GetUDEvent()->GetFd();
             delete msgEltPtr;
             m_msgCount--;
             break;
@@ -200,7 +206,56 @@ CUDEvent* CUDEventQueue::GetEntry(const UdId uniqueId) REENTRANT({
         msgEltPtr = msgEltPtr->GetNext();
     }
     unlock();
+#ifdef HAVE_EPOLL_SYSCALL
+    if (fd >= 0)
+    {
+        UpdateFdRegistration(fd);
+    }
+#else
+    (void)fd;
+#endif
+}
+
+#ifdef HAVE_EPOLL_SYSCALL
+void CUDEventQueue::UpdateFdRegistration(const int fd)
+{
+    short events = 0;
+
+    lock(); // FIXME: not exception save! CK
+    CUDEventQueueElt* msgEltPtr = m_head.GetNext();
+
+    while (msgEltPtr)
+    {
+        if (msgEltPtr->GetUDEvent()->GetFd() == fd)
+        {
+            UdInputMask const mask = msgEltPtr->GetUDEvent()->GetMask();
+            if (mask & UdInputReadMask)
+            {
+                events |= POLLIN;
+            }
+            if (mask & UdInputWriteMask)
+            {
+                events |= POLLOUT;
+            }
+            if (mask & UdInputExceptMask)
+            {
+                events |= POLLPRI;
+            }
+        }
+        msgEltPtr = msgEltPtr->GetNext();
+    }
+    unlock();
+
+    if (events)
+    {
+        my_holder->RegisterFd(fd, events, this);
+    }
+    else
+    {
+        my_holder->UnregisterFd(fd);
+    }
 }
+#endif
 
 UdId CUDEventQueue::MakeId()
 {
@@ -215,6 +270,83 @@ UdId CUDEventQueue::MakeId()
     return id;
 }
 
+#ifdef HAVE_POLL_SYSCALL
+
+int CUDEventQueue::GetFdCount()
+{
+    SnmpSynchronize const _synchronize(*this); // instead of REENTRANT()
+
+    return m_msgCount;
+}
+
+bool CUDEventQueue::GetFdArray(struct pollfd* readfds, int& remaining)
+{
+    SnmpSynchronize const _synchronize(*this); // instead of REENTRANT()
+    CUDEventQueueElt*     msgEltPtr = m_head.GetNext();
+
+    while (msgEltPtr)
+    {
+        if (remaining <= 0)
+        {
+            return false;
+        }
+        UdInputMask const mask = msgEltPtr->GetUDEvent()->GetMask();
+
+        readfds->fd     = msgEltPtr->GetUDEvent()->GetFd();
+        readfds->events = 0;
+        if (mask & UdInputReadMask)
+        {
+            readfds->events |= POLLIN;
+        }
+        if (mask & UdInputWriteMask)
+        {
+            readfds->events |= POLLOUT;
+        }
+        if (mask & UdInputExceptMask)
+        {
+            readfds->events |= POLLPRI;
+        }
+        readfds++;
+        remaining--;
+        msgEltPtr = msgEltPtr->GetNext();
+    }
+    return true;
+}
+
+int CUDEventQueue::HandleEvents(const struct pollfd* readfds, const int fds)
+{
+    SnmpSynchronize const _synchronize(*this); // instead of REENTRANT()
+
+    for (int i = 0; i < fds; i++)
+    {
+        if (readfds[i].revents == 0)
+        {
+            continue;
+        }
+        CUDEventQueueElt* msgEltPtr = m_head.GetNext();
+
+        while (msgEltPtr)
+        {
+            int const         fd   = msgEltPtr->GetUDEvent()->GetFd();
+            UdInputMask const mask = msgEltPtr->GetUDEvent()->GetMask();
+
+            if ((fd == readfds[i].fd)
+                && (((mask & UdInputReadMask) && (readfds[i].revents & POLLIN))
+                    || ((mask & UdInputWriteMask)
+                        && (readfds[i].revents & POLLOUT))
+                    || ((mask & UdInputExceptMask)
+                        && (readfds[i].revents & POLLPRI))))
+            {
+                msgEltPtr->GetUDEvent()->Callback();
+            }
+            msgEltPtr = msgEltPtr->GetNext();
+        }
+    }
+    return SNMP_CLASS_SUCCESS;
+}
+
+#else
+
 void CUDEventQueue::GetFdSets(int& maxfds, fd_set& readfds, fd_set& writefds,
     fd_set& exceptfds) REENTRANT({
     CUDEventQueueElt* msgEltPtr = m_head.GetNext();
@@ -265,6 +397,8 @@ void CUDEventQueue::GetFdSets(int& maxfds, fd_set& readfds, fd_set& writefds,
         return SNMP_CLASS_SUCCESS;
     })
 
+#endif // HAVE_POLL_SYSCALL
+
 #ifdef SNMP_PP_NAMESPACE
 } // end of namespace Snmp_pp
 
@@ -160,11 +160,12 @@ UtId CUTEventQueue::AddEntry(
 
     /*---------------------------------------------------------*/
     /* Insert entry at head of list, done automagically by the */
-    /* constructor function, so don't use the return value.    */
+    /* constructor function.                                   */
     /*---------------------------------------------------------*/
     lock(); // FIXME: not exception save! CK
-    (void)new CUTEventQueueElt(newEvent, m_head.GetNext(), &m_head);
+    auto* newElt = new CUTEventQueueElt(newEvent, m_head.GetNext(), &m_head);
     m_msgCount++;
+    m_timeouts.Insert(newElt, timeout);
     unlock();
     return uniqueId;
 }
@@ -193,6 +194,7 @@ CUTEvent* CUTEventQueue::GetEntry(const UtId uniqueId) REENTRANT({
     {
         if (msgEltPtr->TestId(uniqueId))
         {
+            m_timeouts.Remove(msgEltPtr);
             delete msgEltPtr;
             m_msgCount--;
             break;
@@ -216,30 +218,13 @@ UtId CUTEventQueue::MakeId()
 }
 
 CUTEvent* CUTEventQueue::GetNextTimeoutEntry() REENTRANT({
-    CUTEventQueueElt* msgEltPtr = m_head.GetNext();
-    msec              bestTime(0, 0); // no need to be initialized...
-    msec              sendTime(0, 0); // no need to be initialized...
-    CUTEvent*         bestmsg = nullptr;
-
-    if (msgEltPtr)
-    {
-        bestmsg = msgEltPtr->GetUTEvent();
-        bestmsg->GetTimeout(bestTime);
-    }
+    auto* msgEltPtr = static_cast<CUTEventQueueElt*>(m_timeouts.Top());
 
-    // This would be much simpler if the queue was an ordered list!
-    while (msgEltPtr)
+    if (!msgEltPtr)
     {
-        CUTEvent* msg = msgEltPtr->GetUTEvent();
-        msg->GetTimeout(sendTime);
-        if (bestTime > sendTime)
-        {
-            bestTime = sendTime;
-            bestmsg  = msg;
-        }
-        msgEltPtr = msgEltPtr->GetNext();
+        return nullptr;
     }
-    return bestmsg;
+    return msgEltPtr->GetUTEvent();
 })
 
     int CUTEventQueue::GetNextTimeout(msec& sendTime)
@@ -31,6 +31,7 @@
 
 #ifdef _SNMPv3
 
+#    include "snmp_pp/addresstable.h" // fnv1a_hash()
 #    include "snmp_pp/asn1.h"
 #    include "snmp_pp/auth_priv.h"
 #    include "snmp_pp/log.h"
@@ -86,6 +87,157 @@ struct UsmKeyUpdate {
     int      type {};
 };
 
+/* ------------------------- UsmTableIndex -------------------------*/
+
+/**
+ * Hash index of the positions of entries in a table array.
+ *
+ * The hash of each entry is stored with its position, so the index
+ * can grow without access to the table. Entries with the same hash
+ * are told apart by the match function given to find(). The index
+ * is not synchronized, it is locked with the table it belongs to.
+ */
+class USMTableIndex {
+public:
+    USMTableIndex() : slots(nullptr), size(0), used(0), count(0) { }
+
+    ~USMTableIndex() { delete[] slots; }
+
+    /**
+     * Get the position of an entry with the given hash for which
+     * match(position) is true.
+     *
+     * @return - the position or -1 if not found
+     */
+    template <class Match> int find(const uint32_t hash, Match match) const
+    {
+        if (!slots)
+        {
+            return -1;
+        }
+        uint32_t slot = hash & (size - 1);
+
+        while (slots[slot].pos != EMPTY)
+        {
+            if ((slots[slot].hash == hash) && (slots[slot].pos >= 0)
+                && match(slots[slot].pos))
+            {
+                return slots[slot].pos;
+            }
+            slot = (slot + 1) & (size - 1);
+        }
+        return -1;
+    }
+
+    void add(const uint32_t hash, const int pos);
+    void remove(const uint32_t hash, const int pos);
+
+    // The entry at position from was moved to position to
+    void move(const uint32_t hash, const int from, const int to);
+
+private:
+    enum { EMPTY = -1, DELETED = -2 };
+
+    struct Slot {
+        uint32_t hash;
+        int      pos; // EMPTY, DELETED or the position in the table
+    };
+
+    // Find the slot of the entry at position pos
+    Slot* find_slot(const uint32_t hash, const int pos) const;
+    void  resize();
+
+    Slot*    slots; // open addressing, size is a power of two
+    uint32_t size;
+    uint32_t used;  // slots not EMPTY
+    uint32_t count; // slots with a position
+};
+
+USMTableIndex::Slot* USMTableIndex::find_slot(
+    const uint32_t hash, const int pos) const
+{
+    if (!slots)
+    {
+        return nullptr;
+    }
+    uint32_t slot = hash & (size - 1);
+
+    while (slots[slot].pos != EMPTY)
+    {
+        if (slots[slot].pos == pos)
+        {
+            return slots + slot;
+        }
+        slot = (slot + 1) & (size - 1);
+    }
+    return nullptr;
+}
+
+void USMTableIndex::resize()
+{
+    Slot* const    old_slots = slots;
+    uint32_t const old_size  = size;
+
+    // at most half of the slots are used after resizing
+    size = 16;
+    while (size < (count + 1) * 2) { size *= 2; }
+
+    slots = new Slot[size];
+    used  = 0;
+    count = 0;
+    for (uint32_t i = 0; i < size; ++i) { slots[i].pos = EMPTY; }
+
+    for (uint32_t i = 0; i < old_size; ++i)
+    {
+        if (old_slots[i].pos >= 0)
+        {
+            add(old_slots[i].hash, old_slots[i].pos);
+        }
+    }
+    delete[] old_slots;
+}
+
+void USMTableIndex::add(const uint32_t hash, const int pos)
+{
+    // keep at least one quarter of the slots empty
+    if ((used + 1) * 4 > size * 3)
+    {
+        resize();
+    }
+    uint32_t slot = hash & (size - 1);
+
+    while (slots[slot].pos >= 0) { slot = (slot + 1) & (size - 1); }
+
+    if (slots[slot].pos == EMPTY)
+    {
+        ++used; // a deleted slot is counted already
+    }
+    slots[slot].hash = hash;
+    slots[slot].pos  = pos;
+    ++count;
+}
+
+void USMTableIndex::remove(const uint32_t hash, const int pos)
+{
+    Slot* const slot = find_slot(hash, pos);
+
+    if (slot)
+    {
+        slot->pos = DELETED;
+        --count;
+    }
+}
+
+void USMTableIndex::move(const uint32_t hash, const int from, const int to)
+{
+    Slot* const slot = find_slot(hash, from);
+
+    if (slot)
+    {
+        slot->pos = to;
+    }
+}
+
 /* ------------------------- UsmTimeTable --------------------------*/
 
 /**
@@ -351,10 +503,21 @@ public:
         const UsmUserNameTableEntry* e) const;
 
 private:
+    // Get the position of the user in the table or -1
+    int find_user_name(const unsigned char* name, const long len) const;
+    int find_security_name(const unsigned char* name, const long len) const;
+
+    // Remove the entry at position nr from the indexes, it is
+    // replaced by the last entry
+    void unindex_entry(const int nr);
+
     struct UsmUserNameTableEntry* table;
 
     int max_entries; ///< the maximum number of entries
     int entries;     ///< the current amount of entries
+
+    USMTableIndex user_name_index;     ///< by usmUserName
+    USMTableIndex security_name_index; ///< by usmUserSecurityName
 };
 
 /* ---------------------------- UsmUserTable ------------------- */
@@ -364,7 +527,7 @@ private:
  */
 class USMUserTable : public SnmpSynchronized {
 public:
-    USMUserTable(int& result);
+    USMUserTable(AuthPriv* ap, int& result);
 
     ~USMUserTable() override;
 
@@ -569,10 +732,21 @@ public:
 private:
     void delete_entry(const int nr);
 
+    // Get the position of the user in the table or -1
+    int find_user_name(
+        const OctetStr& engine_id, const OctetStr& user_name) const;
+    int find_security_name(
+        const OctetStr& engine_id, const OctetStr& sec_name) const;
+
     struct UsmUserTableEntry* table;
 
     int max_entries; ///< the maximum number of entries
     int entries;     ///< the current amount of entries
+
+    USMTableIndex user_name_index;     ///< by engine id and userName
+    USMTableIndex security_name_index; ///< by engine id and securityName
+
+    AuthPriv* auth_priv; ///< creates the keyed HMAC states of the users
 };
 
 struct UsmSecurityParameters {
@@ -589,19 +763,21 @@ struct UsmSecurityParameters {
 };
 
 struct SecurityStateReference {
-    unsigned char  msgUserName[MAXLEN_USMUSERNAME];
-    int            msgUserNameLength;
-    unsigned char* securityName;
-    int            securityNameLength;
-    unsigned char* securityEngineID;
-    int            securityEngineIDLength;
-    int            authProtocol;
-    unsigned char* authKey;
-    int            authKeyLength;
-    int            privProtocol;
-    unsigned char* privKey;
-    int            privKeyLength;
-    int            securityLevel;
+    unsigned char    msgUserName[MAXLEN_USMUSERNAME];
+    int              msgUserNameLength;
+    unsigned char*   securityName;
+    int              securityNameLength;
+    unsigned char*   securityEngineID;
+    int              securityEngineIDLength;
+    int              authProtocol;
+    unsigned char*   authKey;
+    int              authKeyLength;
+    int              privProtocol;
+    unsigned char*   privKey;
+    int              privKeyLength;
+    int              securityLevel;
+    AuthHMACContext* authContext;
+    PrivKeyContext*  privContext;
 };
 
 void USM::inc_stats_unsupported_sec_levels()
@@ -699,6 +875,8 @@ void USM::delete_sec_state_reference(struct SecurityStateReference* ssr)
             memset(ssr->privKey, 0, ssr->privKeyLength);
             delete[] ssr->privKey;
         }
+        AuthHMACContext::unref(ssr->authContext);
+        PrivKeyContext::unref(ssr->privContext);
     }
     delete ssr;
 }
@@ -741,7 +919,7 @@ USM::USM(uint32_t engine_boots, const OctetStr& engine_id, const v3MP* v3_mp,
         return;
     }
 
-    usm_user_table = new USMUserTable(result);
+    usm_user_table = new USMUserTable(auth_priv, result);
     if (result != SNMPv3_USM_OK)
     {
         return;
@@ -802,7 +980,7 @@ int USM::remove_all_users()
         return result;
     }
 
-    usm_user_table = new USMUserTable(result);
+    usm_user_table = new USMUserTable(auth_priv, result);
     return result;
 }
 
@@ -1035,6 +1213,8 @@ struct UsmUser* USM::get_user(
                 res->privProtocol       = SNMP_PRIVPROTOCOL_NONE;
                 res->privKey            = nullptr;
                 res->privKeyLength      = 0;
+                res->authContext        = nullptr;
+                res->privContext        = nullptr;
 
                 if ((res->usmUserNameLength && !res->usmUserName)
                     || (res->securityNameLength && !res->securityName))
@@ -1075,6 +1255,8 @@ struct UsmUser* USM::get_user(
             res->privProtocol  = SNMP_PRIVPROTOCOL_NONE;
             res->privKey       = nullptr;
             res->privKeyLength = 0;
+            res->authContext   = nullptr;
+            res->privContext   = nullptr;
 
             if ((res->usmUserNameLength && !res->usmUserName)
                 || (res->securityNameLength && !res->securityName))
@@ -1165,12 +1347,16 @@ struct UsmUser* USM::get_user(
     res->privProtocol       = user_table_entry->usmUserPrivProtocol;
     res->privKey            = user_table_entry->usmUserPrivKey;
     res->privKeyLength      = user_table_entry->usmUserPrivKeyLength;
+    res->authContext        = user_table_entry->usmUserAuthContext;
+    res->privContext        = user_table_entry->usmUserPrivContext;
 
     user_table_entry->usmUserEngineID     = nullptr;
     user_table_entry->usmUserName         = nullptr;
     user_table_entry->usmUserSecurityName = nullptr;
     user_table_entry->usmUserAuthKey      = nullptr;
     user_table_entry->usmUserPrivKey      = nullptr;
+    user_table_entry->usmUserAuthContext  = nullptr;
+    user_table_entry->usmUserPrivContext  = nullptr;
 
     usm_user_table->delete_cloned_entry(user_table_entry);
 
@@ -1209,6 +1395,8 @@ void USM::free_user(struct UsmUser*& user)
         memset(user->privKey, 0, user->privKeyLength);
         delete[] user->privKey;
     }
+    AuthHMACContext::unref(user->authContext);
+    PrivKeyContext::unref(user->privContext);
 
     delete user;
 
@@ -1728,6 +1916,8 @@ int USM::generate_msg(unsigned char* globalData, // message header, admin data
         user->privProtocol  = securityStateReference->privProtocol;
         user->privKeyLength = securityStateReference->privKeyLength;
         user->privKey       = securityStateReference->privKey;
+        user->authContext   = securityStateReference->authContext;
+        user->privContext   = securityStateReference->privContext;
 
         debugprintf(20,
             "securityStateReference: secName %d, authProt %d, akey %d",
@@ -1820,9 +2010,10 @@ int USM::generate_msg(unsigned char* globalData, // message header, admin data
             new unsigned char[usmSecurityParams.msgPrivacyParametersLength];
 
         // encrypt Message
-        int const enc_result = auth_priv->encrypt_msg(user->privProtocol,
-            user->privKey, user->privKeyLength, scopedPDU, scopedPDULength,
-            buf2Ptr, &buf2Length, usmSecurityParams.msgPrivacyParameters,
+        int const enc_result = auth_priv->encrypt_msg(user->privContext,
+            user->privProtocol, user->privKey, user->privKeyLength, scopedPDU,
+            scopedPDULength, buf2Ptr, &buf2Length,
+            usmSecurityParams.msgPrivacyParameters,
             &usmSecurityParams.msgPrivacyParametersLength,
             usmSecurityParams.msgAuthoritativeEngineBoots,
             usmSecurityParams.msgAuthoritativeEngineTime);
@@ -1909,8 +2100,16 @@ int USM::generate_msg(unsigned char* globalData, // message header, admin data
         }
         *wholeMsgLength = SAFE_INT_CAST(wholeMsgPtr - wholeMsg);
 
-        rc = auth_priv->auth_out_msg(user->authProtocol, user->authKey,
-            wholeMsg, *wholeMsgLength, wholeMsg + startAuthPar);
+        if (user->authContext)
+        {
+            rc = auth_priv->auth_out_msg(user->authContext, wholeMsg,
+                *wholeMsgLength, wholeMsg + startAuthPar);
+        }
+        else
+        {
+            rc = auth_priv->auth_out_msg(user->authProtocol, user->authKey,
+                wholeMsg, *wholeMsgLength, wholeMsg + startAuthPar);
+        }
 
         if (rc != SNMPv3_USM_OK)
         {
@@ -2104,6 +2303,8 @@ int USM::process_msg(int maxMessageSize,     // of the sending SNMP entity
     securityStateReference->privProtocol       = 1;
     securityStateReference->authKey            = nullptr;
     securityStateReference->privKey            = nullptr;
+    securityStateReference->authContext        = nullptr;
+    securityStateReference->privContext        = nullptr;
 
     // in case we return with error,
     // perhaps v3MP can decode it (requestID!!!)
@@ -2188,9 +2389,18 @@ int USM::process_msg(int maxMessageSize,     // of the sending SNMP entity
 
     if (securityLevel > SNMP_SECURITY_LEVEL_NOAUTH_NOPRIV)
     {
-        rc = auth_priv->auth_inc_msg(user->authProtocol, user->authKey,
-            wholeMsg, wholeMsgLength, wholeMsg + authParametersPosition,
-            authParamLength);
+        if (user->authContext)
+        {
+            rc = auth_priv->auth_inc_msg(user->authContext, wholeMsg,
+                wholeMsgLength, wholeMsg + authParametersPosition,
+                authParamLength);
+        }
+        else
+        {
+            rc = auth_priv->auth_inc_msg(user->authProtocol, user->authKey,
+                wholeMsg, wholeMsgLength, wholeMsg + authParametersPosition,
+                authParamLength);
+        }
         if (rc != SNMPv3_USM_OK)
         {
             switch (rc)
@@ -2232,9 +2442,13 @@ int USM::process_msg(int maxMessageSize,     // of the sending SNMP entity
 
             securityStateReference->privKeyLength = user->privKeyLength;
             securityStateReference->privKey       = user->privKey;
+            securityStateReference->authContext   = user->authContext;
+            securityStateReference->privContext   = user->privContext;
 
-            user->authKey = nullptr;
-            user->privKey = nullptr;
+            user->authKey     = nullptr;
+            user->privKey     = nullptr;
+            user->authContext = nullptr;
+            user->privContext = nullptr;
 
             free_user(user);
             return rc;
@@ -2272,11 +2486,11 @@ int USM::process_msg(int maxMessageSize,     // of the sending SNMP entity
 
         // decrypt Message
         SmiUINT32 tmp_length = *scopedPDULength;
-        int const dec_result = auth_priv->decrypt_msg(user->privProtocol,
-            user->privKey, user->privKeyLength, encryptedScopedPDU.get_ptr(),
-            encryptedScopedPDULength, scopedPDU, &tmp_length,
-            (unsigned char*)&privParam, privParamLength, engineBoots,
-            engineTime);
+        int const dec_result = auth_priv->decrypt_msg(user->privContext,
+            user->privProtocol, user->privKey, user->privKeyLength,
+            encryptedScopedPDU.get_ptr(), encryptedScopedPDULength, scopedPDU,
+            &tmp_length, (unsigned char*)&privParam, privParamLength,
+            engineBoots, engineTime);
         *scopedPDULength     = tmp_length;
         if (dec_result != SNMPv3_USM_OK)
         {
@@ -2331,9 +2545,13 @@ int USM::process_msg(int maxMessageSize,     // of the sending SNMP entity
 
     securityStateReference->privKeyLength = user->privKeyLength;
     securityStateReference->privKey       = user->privKey;
+    securityStateReference->authContext   = user->authContext;
+    securityStateReference->privContext   = user->privContext;
 
-    user->authKey = nullptr;
-    user->privKey = nullptr;
+    user->authKey     = nullptr;
+    user->privKey     = nullptr;
+    user->authContext = nullptr;
+    user->privContext = nullptr;
 
     free_user(user);
 
@@ -2588,6 +2806,8 @@ inline void USM::delete_user_ptr(struct UsmUser* user)
         delete[] user->privKey;
         user->authKey = nullptr;
     }
+    AuthHMACContext::unref(user->authContext);
+    PrivKeyContext::unref(user->privContext);
 }
 
 // Save all localized users into a file.
@@ -3054,20 +3274,20 @@ int USMUserNameTable::add_entry(const OctetStr& user_name,
 
     BEGIN_REENTRANT_CODE_BLOCK;
 
-    int found = 0;
-    int i     = 0;
-    for (i = 0; i < entries; i++)
-    {
-        if (table[i].usmUserName == user_name)
-        {
-            found = 1;
-            break;
-        }
-    }
+    int i = find_user_name(user_name.data(), user_name.len());
 
-    if (found)
+    if (i >= 0)
     {
         /* replace user */
+        if (table[i].usmUserSecurityName != security_name)
+        {
+            security_name_index.remove(
+                fnv1a_hash(table[i].usmUserSecurityName.data(),
+                    table[i].usmUserSecurityName.len()),
+                i);
+            security_name_index.add(
+                fnv1a_hash(security_name.data(), security_name.len()), i);
+        }
         table[i].usmUserSecurityName = security_name;
         table[i].usmUserAuthProtocol = auth_proto;
         table[i].usmUserPrivProtocol = priv_proto;
@@ -3129,6 +3349,10 @@ int USMUserNameTable::add_entry(const OctetStr& user_name,
             return SNMPv3_USM_ERROR;
         }
 
+        user_name_index.add(
+            fnv1a_hash(user_name.data(), user_name.len()), entries);
+        security_name_index.add(
+            fnv1a_hash(security_name.data(), security_name.len()), entries);
         entries++;
     }
 
@@ -3144,25 +3368,65 @@ int USMUserNameTable::delete_security_name(const OctetStr& security_name)
 
     BEGIN_REENTRANT_CODE_BLOCK;
 
-    for (int i = 0; i < entries; i++)
+    int const i =
+        find_security_name(security_name.data(), security_name.len());
+
+    if (i >= 0)
     {
-        if (table[i].usmUserSecurityName == security_name)
+        memset(table[i].authPassword, 0, table[i].authPasswordLength);
+        delete[] table[i].authPassword;
+        memset(table[i].privPassword, 0, table[i].privPasswordLength);
+        delete[] table[i].privPassword;
+        unindex_entry(i);
+        entries--;
+        if (entries > i)
         {
-            memset(table[i].authPassword, 0, table[i].authPasswordLength);
-            delete[] table[i].authPassword;
-            memset(table[i].privPassword, 0, table[i].privPasswordLength);
-            delete[] table[i].privPassword;
-            entries--;
-            if (entries > i)
-            {
-                table[i] = table[entries];
-            }
-            break;
+            table[i] = table[entries];
         }
     }
     return SNMPv3_USM_OK;
 }
 
+int USMUserNameTable::find_user_name(
+    const unsigned char* name, const long len) const
+{
+    return user_name_index.find(fnv1a_hash(name, len), [&](const int i) {
+        return unsignedCharCompare(table[i].usmUserName.data(),
+            table[i].usmUserName.len(), name, len);
+    });
+}
+
+int USMUserNameTable::find_security_name(
+    const unsigned char* name, const long len) const
+{
+    return security_name_index.find(fnv1a_hash(name, len), [&](const int i) {
+        return unsignedCharCompare(table[i].usmUserSecurityName.data(),
+            table[i].usmUserSecurityName.len(), name, len);
+    });
+}
+
+void USMUserNameTable::unindex_entry(const int nr)
+{
+    const UsmUserNameTableEntry& e    = table[nr];
+    const UsmUserNameTableEntry& last = table[entries - 1];
+
+    user_name_index.remove(
+        fnv1a_hash(e.usmUserName.data(), e.usmUserName.len()), nr);
+    security_name_index.remove(
+        fnv1a_hash(e.usmUserSecurityName.data(), e.usmUserSecurityName.len()),
+        nr);
+
+    if (nr < entries - 1)
+    {
+        user_name_index.move(
+            fnv1a_hash(last.usmUserName.data(), last.usmUserName.len()),
+            entries - 1, nr);
+        security_name_index.move(fnv1a_hash(last.usmUserSecurityName.data(),
+                                       last.usmUserSecurityName.len()),
+            entries - 1, nr);
+    }
+}
+
 const struct UsmUserNameTableEntry* USMUserNameTable::get_entry(
     const OctetStr& security_name)
 {
@@ -3171,14 +3435,10 @@ const struct UsmUserNameTableEntry* USMUserNameTable::get_entry(
         return nullptr;
     }
 
-    for (int i = 0; i < entries; i++)
-    {
-        if (table[i].usmUserSecurityName == security_name)
-        {
-            return &table[i];
-        }
-    }
-    return nullptr;
+    int const i =
+        find_security_name(security_name.data(), security_name.len());
+
+    return (i >= 0) ? &table[i] : nullptr;
 }
 
 struct UsmUserNameTableEntry* USMUserNameTable::get_cloned_entry(
@@ -3250,21 +3510,19 @@ int USMUserNameTable::get_security_name(const unsigned char* user_name,
 
     BEGIN_REENTRANT_CODE_BLOCK;
 
-    for (int i = 0; i < entries; i++)
+    int const i = find_user_name(user_name, user_name_len);
+
+    if (i >= 0)
     {
-        if (unsignedCharCompare(table[i].usmUserName.data(),
-                table[i].usmUserName.len(), user_name, user_name_len))
-        {
-            security_name = table[i].usmUserSecurityName;
+        security_name = table[i].usmUserSecurityName;
 
-            LOG_BEGIN(loggerModuleName, INFO_LOG | 9);
-            LOG("USMUserNameTable: Translated (user name) to (security name)");
-            LOG(table[i].usmUserName.get_printable());
-            LOG(security_name.get_printable());
-            LOG_END;
+        LOG_BEGIN(loggerModuleName, INFO_LOG | 9);
+        LOG("USMUserNameTable: Translated (user name) to (security name)");
+        LOG(table[i].usmUserName.get_printable());
+        LOG(security_name.get_printable());
+        LOG_END;
 
-            return SNMPv3_USM_OK;
-        }
+        return SNMPv3_USM_OK;
     }
 
     if (user_name_len != 0)
@@ -3292,35 +3550,32 @@ int USMUserNameTable::get_user_name(unsigned char* user_name,
 
     BEGIN_REENTRANT_CODE_BLOCK;
 
-    for (int i = 0; i < entries; i++)
+    int const i = find_security_name(security_name, security_name_len);
+
+    if (i >= 0)
     {
-        if (unsignedCharCompare(table[i].usmUserSecurityName.data(),
-                table[i].usmUserSecurityName.len(), security_name,
-                security_name_len))
+        if (buf_len < table[i].usmUserName.len())
         {
-            if (buf_len < table[i].usmUserName.len())
-            {
-                LOG_BEGIN(loggerModuleName, ERROR_LOG | 1);
-                LOG("USMUserNameTable: Buffer for user name too small (is) "
-                    "(should)");
-                LOG(buf_len);
-                LOG(table[i].usmUserName.len());
-                LOG_END;
-
-                return SNMPv3_USM_ERROR;
-            }
-            *user_name_len = table[i].usmUserName.len();
-            memcpy(user_name, table[i].usmUserName.data(),
-                table[i].usmUserName.len());
-
-            LOG_BEGIN(loggerModuleName, INFO_LOG | 9);
-            LOG("USMUserNameTable: Translated (security name) to (user name)");
-            LOG(table[i].usmUserSecurityName.get_printable());
-            LOG(table[i].usmUserName.get_printable());
+            LOG_BEGIN(loggerModuleName, ERROR_LOG | 1);
+            LOG("USMUserNameTable: Buffer for user name too small (is) "
+                "(should)");
+            LOG(buf_len);
+            LOG(table[i].usmUserName.len());
             LOG_END;
 
-            return SNMPv3_USM_OK;
+            return SNMPv3_USM_ERROR;
         }
+        *user_name_len = table[i].usmUserName.len();
+        memcpy(user_name, table[i].usmUserName.data(),
+            table[i].usmUserName.len());
+
+        LOG_BEGIN(loggerModuleName, INFO_LOG | 9);
+        LOG("USMUserNameTable: Translated (security name) to (user name)");
+        LOG(table[i].usmUserSecurityName.get_printable());
+        LOG(table[i].usmUserName.get_printable());
+        LOG_END;
+
+        return SNMPv3_USM_OK;
     }
     if (security_name_len != 0)
     {
@@ -3689,7 +3944,7 @@ const UsmUserNameTableEntry* USMUserNameTable::peek_next(
 
 /* ---------------------------- USMUserTable ------------------- */
 
-USMUserTable::USMUserTable(int& result)
+USMUserTable::USMUserTable(AuthPriv* ap, int& result) : auth_priv(ap)
 {
     entries = 0;
 
@@ -3732,6 +3987,8 @@ USMUserTable::~USMUserTable()
                     table[i].usmUserPrivKey, 0, table[i].usmUserPrivKeyLength);
                 delete[] table[i].usmUserPrivKey;
             }
+            AuthHMACContext::unref(table[i].usmUserAuthContext);
+            PrivKeyContext::unref(table[i].usmUserPrivContext);
         }
         delete[] table;
         table       = nullptr;
@@ -3888,24 +4145,47 @@ int USMUserTable::delete_entry(
 
     BEGIN_REENTRANT_CODE_BLOCK;
 
-    for (int i = 0; i < entries; i++)
+    int const i = find_user_name(engine_id, user_name);
+
+    if (i >= 0)
     {
-        if (unsignedCharCompare(table[i].usmUserName,
-                table[i].usmUserNameLength, user_name.data(), user_name.len()))
-        {
-            if (unsignedCharCompare(table[i].usmUserEngineID,
-                    table[i].usmUserEngineIDLength, engine_id.data(),
-                    engine_id.len()))
-            {
-                /* delete this entry and recheck this position*/
-                delete_entry(i);
-                i--;
-            }
-        }
+        delete_entry(i); // add_entry() keeps the pair unique
     }
     return SNMPv3_USM_OK;
 }
 
+int USMUserTable::find_user_name(
+    const OctetStr& engine_id, const OctetStr& user_name) const
+{
+    uint32_t const hash = fnv1a_hash(user_name.data(), user_name.len(),
+        fnv1a_hash(engine_id.data(), engine_id.len()));
+
+    return user_name_index.find(hash, [&](const int i) {
+        return unsignedCharCompare(table[i].usmUserName,
+                   table[i].usmUserNameLength, user_name.data(),
+                   user_name.len())
+            && unsignedCharCompare(table[i].usmUserEngineID,
+                table[i].usmUserEngineIDLength, engine_id.data(),
+                engine_id.len());
+    });
+}
+
+int USMUserTable::find_security_name(
+    const OctetStr& engine_id, const OctetStr& sec_name) const
+{
+    uint32_t const hash = fnv1a_hash(sec_name.data(), sec_name.len(),
+        fnv1a_hash(engine_id.data(), engine_id.len()));
+
+    return security_name_index.find(hash, [&](const int i) {
+        return unsignedCharCompare(table[i].usmUserSecurityName,
+                   table[i].usmUserSecurityNameLength, sec_name.data(),
+                   sec_name.len())
+            && unsignedCharCompare(table[i].usmUserEngineID,
+                table[i].usmUserEngineIDLength, engine_id.data(),
+                engine_id.len());
+    });
+}
+
 const struct UsmUserTableEntry* USMUserTable::get_entry(const int number)
 {
     if ((entries < number) || (number < 1))
@@ -3924,21 +4204,9 @@ const struct UsmUserTableEntry* USMUserTable::get_entry(
         return nullptr;
     }
 
-    for (int i = 0; i < entries; i++)
-    {
-        if (unsignedCharCompare(table[i].usmUserSecurityName,
-                table[i].usmUserSecurityNameLength, sec_name.data(),
-                sec_name.len()))
-        {
-            if (unsignedCharCompare(table[i].usmUserEngineID,
-                    table[i].usmUserEngineIDLength, engine_id.data(),
-                    engine_id.len()))
-            {
-                return &table[i];
-            }
-        }
-    }
-    return nullptr;
+    int const i = find_security_name(engine_id, sec_name);
+
+    return (i >= 0) ? &table[i] : nullptr;
 }
 
 struct UsmUserTableEntry* USMUserTable::get_cloned_entry(
@@ -3971,6 +4239,10 @@ struct UsmUserTableEntry* USMUserTable::get_cloned_entry(
         res->usmUserPrivKey =
             v3strcpy(e->usmUserPrivKey, e->usmUserPrivKeyLength);
         res->usmUserPrivKeyLength = e->usmUserPrivKeyLength;
+        res->usmUserAuthContext =
+            e->usmUserAuthContext ? e->usmUserAuthContext->ref() : nullptr;
+        res->usmUserPrivContext =
+            e->usmUserPrivContext ? e->usmUserPrivContext->ref() : nullptr;
 
         if ((res->usmUserEngineIDLength && !res->usmUserEngineID)
             || (res->usmUserNameLength && !res->usmUserName)
@@ -4017,6 +4289,8 @@ void USMUserTable::delete_cloned_entry(struct UsmUserTableEntry*& entry)
         memset(entry->usmUserPrivKey, 0, entry->usmUserPrivKeyLength);
         delete[] entry->usmUserPrivKey;
     }
+    AuthHMACContext::unref(entry->usmUserAuthContext);
+    PrivKeyContext::unref(entry->usmUserPrivContext);
 
     delete entry;
 
@@ -4078,20 +4352,11 @@ int USMUserTable::add_entry(const OctetStr& engine_id,
         max_entries *= 4;
     }
 
-    for (int i = 0; i < entries; i++)
+    int const old = find_user_name(engine_id, user_name);
+    if (old >= 0)
     {
-        if (unsignedCharCompare(table[i].usmUserName,
-                table[i].usmUserNameLength, user_name.data(), user_name.len()))
-        {
-            if (unsignedCharCompare(table[i].usmUserEngineID,
-                    table[i].usmUserEngineIDLength, engine_id.data(),
-                    engine_id.len()))
-            {
-                /* delete this entry */
-                delete_entry(i);
-                break;
-            }
-        }
+        /* delete this entry */
+        delete_entry(old);
     }
 
     /* add user at the last position */
@@ -4109,6 +4374,16 @@ int USMUserTable::add_entry(const OctetStr& engine_id,
     table[entries].usmUserPrivProtocol  = priv_proto;
     table[entries].usmUserPrivKeyLength = priv_key.len();
     table[entries].usmUserPrivKey = v3strcpy(priv_key.data(), priv_key.len());
+    table[entries].usmUserAuthContext = auth_priv->create_hmac_context(
+        auth_proto, auth_key.data(), auth_key.len());
+    table[entries].usmUserPrivContext = auth_priv->create_key_context(
+        priv_proto, priv_key.data(), priv_key.len());
+
+    uint32_t const engine_hash = fnv1a_hash(engine_id.data(), engine_id.len());
+    user_name_index.add(
+        fnv1a_hash(user_name.data(), user_name.len(), engine_hash), entries);
+    security_name_index.add(
+        fnv1a_hash(sec_name.data(), sec_name.len(), engine_hash), entries);
     entries++;
     return SNMPv3_USM_OK;
 }
@@ -4130,60 +4405,61 @@ int USMUserTable::update_key(const OctetStr& user_name,
 
     BEGIN_REENTRANT_CODE_BLOCK;
 
-    for (int i = 0; i < entries; i++)
+    int const i = find_user_name(engine_id, user_name);
+
+    if (i >= 0)
     {
-        if (unsignedCharCompare(table[i].usmUserName,
-                table[i].usmUserNameLength, user_name.data(), user_name.len()))
+        LOG_BEGIN(loggerModuleName, DEBUG_LOG | 15);
+        LOG("USMUserTable: New key");
+        LOG(new_key.get_printable());
+        LOG_END;
+
+        /* update key: */
+        switch (key_type)
         {
-            if (unsignedCharCompare(table[i].usmUserEngineID,
-                    table[i].usmUserEngineIDLength, engine_id.data(),
-                    engine_id.len()))
+        case AUTHKEY:
+        case OWNAUTHKEY: {
+            if (table[i].usmUserAuthKey)
             {
-                LOG_BEGIN(loggerModuleName, DEBUG_LOG | 15);
-                LOG("USMUserTable: New key");
-                LOG(new_key.get_printable());
-                LOG_END;
+                memset(table[i].usmUserAuthKey, 0,
+                    table[i].usmUserAuthKeyLength);
+                delete[] table[i].usmUserAuthKey;
+            }
+            table[i].usmUserAuthKeyLength = new_key.len();
+            table[i].usmUserAuthKey = v3strcpy(new_key.data(), new_key.len());
 
-                /* update key: */
-                switch (key_type)
-                {
-                case AUTHKEY:
-                case OWNAUTHKEY: {
-                    if (table[i].usmUserAuthKey)
-                    {
-                        memset(table[i].usmUserAuthKey, 0,
-                            table[i].usmUserAuthKeyLength);
-                        delete[] table[i].usmUserAuthKey;
-                    }
-                    table[i].usmUserAuthKeyLength = new_key.len();
-                    table[i].usmUserAuthKey =
-                        v3strcpy(new_key.data(), new_key.len());
-                    return SNMPv3_USM_OK;
-                }
+            AuthHMACContext::unref(table[i].usmUserAuthContext);
+            table[i].usmUserAuthContext =
+                auth_priv->create_hmac_context(table[i].usmUserAuthProtocol,
+                    new_key.data(), new_key.len());
+            return SNMPv3_USM_OK;
+        }
 
-                case PRIVKEY:
-                case OWNPRIVKEY: {
-                    if (table[i].usmUserPrivKey)
-                    {
-                        memset(table[i].usmUserPrivKey, 0,
-                            table[i].usmUserPrivKeyLength);
-                        delete[] table[i].usmUserPrivKey;
-                    }
-                    table[i].usmUserPrivKeyLength = new_key.len();
-                    table[i].usmUserPrivKey =
-                        v3strcpy(new_key.data(), new_key.len());
-                    return SNMPv3_USM_OK;
-                }
+        case PRIVKEY:
+        case OWNPRIVKEY: {
+            if (table[i].usmUserPrivKey)
+            {
+                memset(table[i].usmUserPrivKey, 0,
+                    table[i].usmUserPrivKeyLength);
+                delete[] table[i].usmUserPrivKey;
+            }
+            table[i].usmUserPrivKeyLength = new_key.len();
+            table[i].usmUserPrivKey = v3strcpy(new_key.data(), new_key.len());
 
-                default: {
-                    LOG_BEGIN(loggerModuleName, WARNING_LOG | 3);
-                    LOG("USMUserTable: setting new key failed (wrong type).");
-                    LOG_END;
+            PrivKeyContext::unref(table[i].usmUserPrivContext);
+            table[i].usmUserPrivContext =
+                auth_priv->create_key_context(table[i].usmUserPrivProtocol,
+                    new_key.data(), new_key.len());
+            return SNMPv3_USM_OK;
+        }
 
-                    return SNMPv3_USM_ERROR;
-                }
-                }
-            }
+        default: {
+            LOG_BEGIN(loggerModuleName, WARNING_LOG | 3);
+            LOG("USMUserTable: setting new key failed (wrong type).");
+            LOG_END;
+
+            return SNMPv3_USM_ERROR;
+        }
         }
     }
 
@@ -4200,6 +4476,29 @@ void USMUserTable::delete_entry(const int nr)
     /* Table is locked through caller, so do NOT lock table!
      * All checks have been made, so dont check again!
      */
+    const UsmUserTableEntry& e    = table[nr];
+    const UsmUserTableEntry& last = table[entries - 1];
+    uint32_t engine_hash =
+        fnv1a_hash(e.usmUserEngineID, e.usmUserEngineIDLength);
+
+    user_name_index.remove(
+        fnv1a_hash(e.usmUserName, e.usmUserNameLength, engine_hash), nr);
+    security_name_index.remove(
+        fnv1a_hash(e.usmUserSecurityName, e.usmUserSecurityNameLength,
+            engine_hash),
+        nr);
+    if (nr < entries - 1)
+    {
+        engine_hash =
+            fnv1a_hash(last.usmUserEngineID, last.usmUserEngineIDLength);
+        user_name_index.move(
+            fnv1a_hash(last.usmUserName, last.usmUserNameLength, engine_hash),
+            entries - 1, nr);
+        security_name_index.move(fnv1a_hash(last.usmUserSecurityName,
+                                       last.usmUserSecurityNameLength,
+                                       engine_hash),
+            entries - 1, nr);
+    }
 
     if (table[nr].usmUserEngineID)
     {
@@ -4223,6 +4522,8 @@ void USMUserTable::delete_entry(const int nr)
         memset(table[nr].usmUserPrivKey, 0, table[nr].usmUserPrivKeyLength);
         delete[] table[nr].usmUserPrivKey;
     }
+    AuthHMACContext::unref(table[nr].usmUserAuthContext);
+    PrivKeyContext::unref(table[nr].usmUserPrivContext);
 
     /* We have now one entry less */
     entries--;
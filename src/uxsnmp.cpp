@@ -53,8 +53,10 @@
 #include "snmp_pp/msgqueue.h"    // message queue
 #include "snmp_pp/notifyqueue.h" // notification queue
 #include "snmp_pp/oid_def.h"     // class def for well known trap oids
+#include "snmp_pp/preparedrequest.h"
 #include "snmp_pp/snmperrs.h"    // pv3Errs, nErrs
 #include "snmp_pp/snmpmsg.h"     // asn serialization class
+#include "snmp_pp/snmpuring.h"
 #include "snmp_pp/usm_v3.h"
 #include "snmp_pp/uxsnmp.h"      // class def for this module
 #include "snmp_pp/v3.h"
@@ -325,12 +327,20 @@ bool setCloseOnExecFlag(SnmpSocket fd)
 
 //--------[ make the pdu request id ]-----------------------------------
 // return a unique rid, clock can be too slow , so use current_rid
+// Ids are handed out sequentially and the message queue looks them up
+// in O(1), so with a large id range this hardly ever has to skip an id.
 long Snmp::MyMakeReqId()
 {
-    long rid = 0;
+    long rid   = 0;
+    long tries = 0;
 
     eventListHolder->snmpEventList()->lock(); // FIXME: not exception save! CK
     do {
+        // wrap before the increment, so current_rid can not overflow
+        if ((current_rid < min_rid) || (current_rid >= max_rid))
+        {
+            current_rid = min_rid - 1;
+        }
         rid = ++current_rid;
 
 #ifdef INVALID_REQID
@@ -338,10 +348,10 @@ long Snmp::MyMakeReqId()
         rid = 0xc0de;
 #endif
 
-        if (current_rid > PDU_MAX_RID)
+        if (++tries > max_rid - min_rid)
         {
-            current_rid = rid = PDU_MIN_RID;
-            // let other tasks proceed
+            // all ids are in use, let other tasks proceed
+            tries = 0;
             eventListHolder->snmpEventList()->unlock();
             struct timeval tv { };
             tv.tv_sec  = 0;
@@ -356,42 +366,122 @@ long Snmp::MyMakeReqId()
     return rid;
 }
 
-//---------[ Send SNMP Request ]---------------------------------------
-// Send out a snmp request
-DLLOPT int send_snmp_request(SnmpSocket sock, unsigned char* send_buf,
-    size_t send_len, const Address& address)
+void Snmp::set_destination_limits(
+    const int max_in_flight, const uint32_t max_rate, const uint32_t burst)
+{
+    eventListHolder->snmpEventList()->SetLimits(
+        max_in_flight, max_rate, burst);
+}
+
+void Snmp::get_destination_limit_counters(
+    uint32_t& queued, uint32_t& throttled)
+{
+    eventListHolder->snmpEventList()->GetLimiterCounters(queued, throttled);
+}
+
+bool Snmp::set_request_id_range(const long range_min, const long range_max)
+{
+    if ((range_min < PDU_MIN_RID) || (range_max > PDU_MAX_RID)
+        || (range_min >= range_max))
+    {
+        return false;
+    }
+
+    eventListHolder->snmpEventList()->lock(); // FIXME: not exception save! CK
+    min_rid     = range_min;
+    max_rid     = range_max;
+    current_rid = (rand() % (max_rid - min_rid + 1)) + min_rid;
+    debugprintf(4, "Initialized request_id to %li.", current_rid);
+    eventListHolder->snmpEventList()->unlock();
+    return true;
+}
+
+bool Snmp::set_max_message_size(const int size)
+{
+    if ((size < 484) || (size > SNMP_PP_MAX_MESSAGE_SIZE))
+    {
+        return false;
+    }
+#ifdef HAVE_IO_URING
+    // no other thread may receive from the rings while they are replaced
+    eventListHolder->LockEvents();
+
+    // process the datagrams already received with the old size
+    for (auto* uring : m_uring)
+    {
+        if (uring)
+        {
+            eventListHolder->snmpEventList()->DrainResponses(
+                uring->get_fd());
+        }
+    }
+
+    eventListHolder->snmpEventList()->lock();
+    max_message_size = size;
+
+    // the provided buffers are owned by the kernel, restart the rings
+    SnmpSocket const socks[2] = { iv_snmp_session,
+#    ifdef SNMP_PP_IPv6
+        iv_snmp_session_ipv6
+#    else
+        INVALID_SOCKET
+#    endif
+    };
+    for (int i = 0; i < 2; ++i)
+    {
+        if (!m_uring[i])
+        {
+            continue;
+        }
+#    ifdef HAVE_EPOLL_SYSCALL
+        eventListHolder->UnregisterFd(m_uring[i]->get_fd());
+#    endif
+        delete m_uring[i];
+        m_uring[i] = nullptr;
+        start_uring(i, socks[i]);
+#    ifdef HAVE_EPOLL_SYSCALL
+        eventListHolder->RegisterFd(get_poll_fd(socks[i]), POLLIN,
+            eventListHolder->snmpEventList());
+#    endif
+    }
+    eventListHolder->snmpEventList()->unlock();
+    eventListHolder->UnlockEvents();
+#else
+    max_message_size = size;
+#endif
+    return true;
+}
+
+//---------[ convert a send address ]----------------------------------
+// Fill the socket address for sending to the given UDP address.
+// Returns 0 on success or -1 if the address can not be used.
+static int snmp_sockaddr(const Address& address, SocketAddrType& sock_addr,
+    SocketLengthType& sock_addr_len)
 {
     // UX only supports UDP type addresses (addr and port) right now
     if (address.get_type() != Address::type_udp)
     {
         return -1; // unsupported address type
     }
-    debugprintf(1, "++ SNMP++: sending to %s:",
-        ((UdpAddress&)address).UdpAddress::get_printable());
-    debughexprintf(5, send_buf, SAFE_UINT_CAST(send_len));
 
-    int send_result = 0;
+    memset(&sock_addr, 0, sizeof(sock_addr));
 
     if (((UdpAddress&)address).get_ip_version() == Address::version_ipv4)
     {
         // prepare the destination address
-        struct sockaddr_in agent_addr { }; // send socket struct
-        memset(&agent_addr, 0, sizeof(agent_addr));
+        auto& agent_addr           = (struct sockaddr_in&)sock_addr;
         agent_addr.sin_family      = AF_INET;
         agent_addr.sin_addr.s_addr = inet_addr(
             ((IpAddress&)address)
                 .IpAddress::get_printable()); // TODO: Use inet_pton()! CK
         agent_addr.sin_port = htons(((UdpAddress&)address).get_port());
-
-        send_result = sendto(sock, (char*)send_buf, SAFE_INT_CAST(send_len), 0,
-            (struct sockaddr*)&agent_addr, sizeof(agent_addr));
+        sock_addr_len       = sizeof(struct sockaddr_in);
     }
     else
     {
 #ifdef SNMP_PP_IPv6
-        struct sockaddr_in6 agent_addr { };
-        memset(&agent_addr, 0, sizeof(agent_addr));
-        unsigned int scope = 0;
+        auto&        agent_addr = (struct sockaddr_in6&)sock_addr;
+        unsigned int scope      = 0;
 
         OctetStr addrstr = ((IpAddress&)address).IpAddress::get_printable();
 
@@ -424,13 +514,34 @@ DLLOPT int send_snmp_request(SnmpSocket sock, unsigned char* send_buf,
         agent_addr.sin6_family   = AF_INET6;
         agent_addr.sin6_port     = htons(((UdpAddress&)address).get_port());
         agent_addr.sin6_scope_id = scope;
-        send_result              = sendto(sock, (char*)send_buf, send_len, 0,
-                         (struct sockaddr*)&agent_addr, sizeof(agent_addr));
+        sock_addr_len            = sizeof(struct sockaddr_in6);
 #else
         debugprintf(0, "User error: Enable IPv6 and recompile snmp++.");
         return -1;
 #endif
     }
+    return 0;
+}
+
+//---------[ Send SNMP Request ]---------------------------------------
+// Send out a snmp request
+DLLOPT int send_snmp_request(SnmpSocket sock, unsigned char* send_buf,
+    size_t send_len, const Address& address)
+{
+    SocketAddrType   agent_addr;
+    SocketLengthType agent_addr_len = 0;
+
+    if (snmp_sockaddr(address, agent_addr, agent_addr_len) != 0)
+    {
+        return -1;
+    }
+    debugprintf(1, "++ SNMP++: sending to %s:",
+        ((UdpAddress&)address).UdpAddress::get_printable());
+    debughexprintf(5, send_buf, SAFE_UINT_CAST(send_len));
+
+    int const send_result = sendto(sock, (char*)send_buf,
+        SAFE_INT_CAST(send_len), 0, (struct sockaddr*)&agent_addr,
+        agent_addr_len);
 
     if (send_result < 0)
     {
@@ -441,6 +552,225 @@ DLLOPT int send_snmp_request(SnmpSocket sock, unsigned char* send_buf,
     return 0;
 }
 
+//---------[ batch of requests to send ]-------------------------------
+// Collects the encoded messages of Snmp::send_batch() until they
+// are sent by send_snmp_batch().
+class SnmpSendBatch {
+public:
+    struct Entry {
+        SnmpSocket       sock;
+        SocketAddrType   addr;
+        SocketLengthType addr_len;
+        size_t           offset; // of the message in data
+        size_t           len;
+        long             req_id;
+        int              request; // index in the SnmpBatchRequest array
+        void*            v3_callback_data;
+        bool             failed;
+    };
+
+    SnmpSendBatch()
+        : entries(nullptr), count(0), size(0), data(nullptr), data_len(0),
+          data_size(0), request(0)
+    { }
+
+    ~SnmpSendBatch()
+    {
+        delete[] entries;
+        delete[] data;
+    }
+
+    // copy the message, returns -1 if the address can not be used
+    int add(SnmpSocket sock, const unsigned char* buf, const size_t len,
+        const Address& address, const long req_id, void* v3_callback_data);
+
+    Entry*         entries;
+    int            count;
+    int            size;
+    unsigned char* data;
+    size_t         data_len;
+    size_t         data_size;
+    int            request; // current request index
+};
+
+int SnmpSendBatch::add(SnmpSocket sock, const unsigned char* buf,
+    const size_t len, const Address& address, const long req_id,
+    void* v3_callback_data)
+{
+    if (count >= size)
+    {
+        int const newSize    = (size > 0) ? size * 2 : 64;
+        auto*     newEntries = new Entry[newSize];
+
+        for (int i = 0; i < count; ++i) { newEntries[i] = entries[i]; }
+        delete[] entries;
+        entries = newEntries;
+        size    = newSize;
+    }
+    if (data_len + len > data_size)
+    {
+        size_t newSize = (data_size > 0) ? data_size * 2 : MAX_SNMP_PACKET;
+        while (newSize < data_len + len) { newSize *= 2; }
+        auto* newData = new unsigned char[newSize];
+
+        if (data_len)
+        {
+            memcpy(newData, data, data_len);
+        }
+        delete[] data;
+        data      = newData;
+        data_size = newSize;
+    }
+
+    Entry& entry = entries[count];
+    if (snmp_sockaddr(address, entry.addr, entry.addr_len) != 0)
+    {
+        return -1;
+    }
+    memcpy(data + data_len, buf, len);
+    entry.sock             = sock;
+    entry.offset           = data_len;
+    entry.len              = len;
+    entry.req_id           = req_id;
+    entry.request          = request;
+    entry.v3_callback_data = v3_callback_data;
+    entry.failed           = false;
+    data_len += len;
+    count++;
+
+    return 0;
+}
+
+//---------[ Send a batch of SNMP Requests ]---------------------------
+// Send all messages of the batch, with sendmmsg() if available.
+// Messages that could not be sent are marked as failed.
+static void send_snmp_batch(SnmpSendBatch& batch)
+{
+#ifdef HAVE_SENDMMSG
+    struct mmsghdr msgs[SNMP_PP_SEND_BATCH_SIZE];
+    struct iovec   iovecs[SNMP_PP_SEND_BATCH_SIZE];
+    int            first = 0;
+
+    while (first < batch.count)
+    {
+        // messages of one sendmmsg() call must use the same socket
+        SnmpSocket const sock = batch.entries[first].sock;
+        int              n    = 0;
+
+        memset(msgs, 0, sizeof(msgs));
+        while ((n < SNMP_PP_SEND_BATCH_SIZE) && (first + n < batch.count)
+            && (batch.entries[first + n].sock == sock))
+        {
+            SnmpSendBatch::Entry& entry = batch.entries[first + n];
+
+            iovecs[n].iov_base          = batch.data + entry.offset;
+            iovecs[n].iov_len           = entry.len;
+            msgs[n].msg_hdr.msg_iov     = &iovecs[n];
+            msgs[n].msg_hdr.msg_iovlen  = 1;
+            msgs[n].msg_hdr.msg_name    = &entry.addr;
+            msgs[n].msg_hdr.msg_namelen = entry.addr_len;
+            n++;
+        }
+
+        int sent = 0;
+        do {
+            sent = sendmmsg(sock, msgs, n, 0);
+        } while ((sent < 0) && (EINTR == errno));
+
+        if (sent <= 0)
+        {
+            // the first message failed, skip it and go on with the rest
+            debugprintf(0, "Error sending packet: %s", strerror(errno));
+            batch.entries[first].failed = true;
+            sent                        = 1;
+        }
+        debugprintf(4, "++ SNMP++: sent %i of %i messages", sent, n);
+        first += sent;
+    }
+#else
+    for (int i = 0; i < batch.count; ++i)
+    {
+        SnmpSendBatch::Entry& entry = batch.entries[i];
+
+        if (sendto(entry.sock, (char*)(batch.data + entry.offset),
+                SAFE_INT_CAST(entry.len), 0, (struct sockaddr*)&entry.addr,
+                entry.addr_len)
+            < 0)
+        {
+            debugprintf(0, "Error sending packet: %s", strerror(errno));
+            entry.failed = true;
+        }
+    }
+#endif
+}
+
+//---------[ receive snmp datagrams ]-----------------------------------
+// Receive up to max_count datagrams from the specified socket into
+// buffers, each buffer_size bytes long. With recvmmsg() all of them
+// are fetched with one system call without blocking, otherwise
+// exactly one datagram is read. Returns the number of datagrams
+// received or -1 on error.
+
+int receive_snmp_datagrams(SnmpSocket sock, unsigned char* buffers,
+    const int buffer_size, long* lengths, SocketAddrType* from_addrs,
+    const int max_count)
+{
+#ifdef HAVE_RECVMMSG
+    struct mmsghdr msgs[SNMP_PP_RECV_BATCH_SIZE];
+    struct iovec   iovecs[SNMP_PP_RECV_BATCH_SIZE];
+    int            count = max_count;
+
+    if (count > SNMP_PP_RECV_BATCH_SIZE)
+    {
+        count = SNMP_PP_RECV_BATCH_SIZE;
+    }
+    memset(msgs, 0, sizeof(msgs));
+    memset(from_addrs, 0, count * sizeof(SocketAddrType));
+    for (int i = 0; i < count; ++i)
+    {
+        iovecs[i].iov_base          = buffers + (i * buffer_size);
+        iovecs[i].iov_len           = buffer_size;
+        msgs[i].msg_hdr.msg_iov     = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen  = 1;
+        msgs[i].msg_hdr.msg_name    = &from_addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(SocketAddrType);
+    }
+
+    int received = 0;
+    do {
+        received = recvmmsg(sock, msgs, count, MSG_DONTWAIT, nullptr);
+    } while ((received < 0) && (EINTR == errno));
+
+    if (received < 0)
+    {
+        return -1;
+    }
+    for (int i = 0; i < received; ++i) { lengths[i] = (long)msgs[i].msg_len; }
+    debugprintf(6, "Received %i datagrams from socket %i", received, sock);
+
+    return received;
+#else
+    SocketLengthType fromlen = sizeof(SocketAddrType);
+
+    if (max_count < 1)
+    {
+        return 0;
+    }
+    memset(from_addrs, 0, sizeof(SocketAddrType));
+    do {
+        lengths[0] = (long)recvfrom(sock, (char*)buffers, buffer_size, 0,
+            (struct sockaddr*)from_addrs, &fromlen);
+    } while ((lengths[0] < 0) && (EINTR == errno));
+
+    return (lengths[0] < 0) ? -1 : 1;
+#endif
+}
+
+int process_snmp_response(unsigned char* receive_buffer,
+    long receive_buffer_len, const SocketAddrType& from_addr,
+    Snmp& snmp_session, Pdu& pdu, UdpAddress& fromaddress,
+    OctetStr& engine_id, bool process_msg, SnmpArena* arena = nullptr);
+
 //---------[ receive a snmp response ]---------------------------------
 // Receive a response from the specified socket.
 // This function does not set the request id in the pdu if
@@ -454,17 +784,20 @@ DLLOPT int send_snmp_request(SnmpSocket sock, unsigned char* send_buf,
 int receive_snmp_response(SnmpSocket sock, Snmp& snmp_session, Pdu& pdu,
     UdpAddress& fromaddress, OctetStr& engine_id, bool process_msg = true)
 {
-    unsigned char    receive_buffer[MAX_SNMP_PACKET + 1];
-    long             receive_buffer_len = 0; // len of received data
-    SocketAddrType   from_addr;
-    SocketLengthType fromlen = sizeof(from_addr);
+    int const buffer_size = snmp_session.get_max_message_size() + 1;
+
+    Buffer<unsigned char> receive_buffer(buffer_size);
+    long                  receive_buffer_len = 0; // len of received data
+    SocketAddrType        from_addr;
+    SocketLengthType      fromlen = sizeof(from_addr);
 
     memset(&from_addr, 0, sizeof(from_addr));
 
     // do the read
     do {
-        receive_buffer_len = (long)recvfrom(sock, (char*)receive_buffer,
-            MAX_SNMP_PACKET + 1, 0, (struct sockaddr*)&from_addr, &fromlen);
+        receive_buffer_len =
+            (long)recvfrom(sock, (char*)receive_buffer.get_ptr(), buffer_size,
+                0, (struct sockaddr*)&from_addr, &fromlen);
         debugprintf(2, "++ SNMP++: something received...");
     } while ((receive_buffer_len < 0) && (EINTR == errno));
 
@@ -475,7 +808,21 @@ int receive_snmp_response(SnmpSocket sock, Snmp& snmp_session, Pdu& pdu,
     debugprintf(6, "Length received %i from socket %i; fromlen %i",
         receive_buffer_len, sock, fromlen);
 
-    if (receive_buffer_len == MAX_SNMP_PACKET + 1)
+    return process_snmp_response(receive_buffer.get_ptr(),
+        receive_buffer_len, from_addr, snmp_session, pdu, fromaddress,
+        engine_id, process_msg);
+}
+
+//---------[ process a snmp response ]---------------------------------
+// Parse a received datagram, same return values and pdu handling
+// as receive_snmp_response().
+
+int process_snmp_response(unsigned char* receive_buffer,
+    long receive_buffer_len, const SocketAddrType& from_addr,
+    Snmp& snmp_session, Pdu& pdu, UdpAddress& fromaddress,
+    OctetStr& engine_id, bool process_msg, SnmpArena* arena)
+{
+    if (receive_buffer_len > snmp_session.get_max_message_size())
     {
         LOG_BEGIN(loggerModuleName, WARNING_LOG | 1);
         LOG("Snmp: Received message is ignored (packet too long)");
@@ -528,6 +875,7 @@ int receive_snmp_response(SnmpSocket sock, Snmp& snmp_session, Pdu& pdu,
     {
         return SNMP_CLASS_ERROR;
     }
+    snmpmsg.set_arena(arena);
 
     OctetStr     community_name;
     snmp_version version = version1;
@@ -589,17 +937,20 @@ int receive_snmp_response(SnmpSocket sock, Snmp& snmp_session, Pdu& pdu,
 int receive_snmp_notification(
     SnmpSocket sock, Snmp& snmp_session, Pdu& pdu, SnmpTarget** target)
 {
-    unsigned char    receive_buffer[MAX_SNMP_PACKET + 1];
-    long             receive_buffer_len = 0; // len of received data
-    SocketAddrType   from_addr;
-    SocketLengthType fromlen = sizeof(from_addr);
+    int const buffer_size = snmp_session.get_max_message_size() + 1;
+
+    Buffer<unsigned char> receive_buffer(buffer_size);
+    long                  receive_buffer_len = 0; // len of received data
+    SocketAddrType        from_addr;
+    SocketLengthType      fromlen = sizeof(from_addr);
 
     memset(&from_addr, 0, sizeof(from_addr));
 
     // do the read
     do {
-        receive_buffer_len = (long)recvfrom(sock, (char*)receive_buffer,
-            MAX_SNMP_PACKET + 1, 0, (struct sockaddr*)&from_addr, &fromlen);
+        receive_buffer_len =
+            (long)recvfrom(sock, (char*)receive_buffer.get_ptr(), buffer_size,
+                0, (struct sockaddr*)&from_addr, &fromlen);
     } while (receive_buffer_len < 0 && EINTR == errno);
 
     if (receive_buffer_len < 0) // error or no data pending
@@ -607,7 +958,7 @@ int receive_snmp_notification(
         return SNMP_CLASS_TL_FAILED;
     }
 
-    if (receive_buffer_len == MAX_SNMP_PACKET + 1)
+    if (receive_buffer_len >= buffer_size)
     {
         // Message is too long...
         debugprintf(1, "Received message is ignored (packet too long)");
@@ -650,10 +1001,11 @@ int receive_snmp_notification(
 
     debugprintf(
         1, "++ SNMP++: data received from %s.", fromaddress.get_printable());
-    debughexprintf(5, receive_buffer, receive_buffer_len);
+    debughexprintf(5, receive_buffer.get_ptr(), receive_buffer_len);
 
     SnmpMessage snmpmsg;
-    if (snmpmsg.load(receive_buffer, receive_buffer_len) != SNMP_CLASS_SUCCESS)
+    if (snmpmsg.load(receive_buffer.get_ptr(), receive_buffer_len)
+        != SNMP_CLASS_SUCCESS)
     {
         return SNMP_CLASS_ERROR;
     }
@@ -779,12 +1131,14 @@ void Snmp::map_action(unsigned short action, unsigned short& pdu_action)
 
 //------[ Snmp Class Constructor ]--------------------------------------
 
-Snmp::Snmp(int& status, const unsigned short port, const bool bind_ipv6)
+Snmp::Snmp(int& status, const unsigned short port, const bool bind_ipv6,
+    const transport_type transport)
     : SnmpSynchronized(),
 #ifdef _SNMPv3
       mpv3(v3MP::instance),
 #endif
-      m_isThreadRunning(false), m_pollTimeOut(DEFAULT_TIMEOUT)
+      m_isThreadRunning(false), m_pollTimeOut(DEFAULT_TIMEOUT),
+      m_transport(transport)
 {
     IpAddress* addresses[2];
 
@@ -808,12 +1162,14 @@ Snmp::Snmp(int& status, const unsigned short port, const bool bind_ipv6)
     }
 }
 
-Snmp::Snmp(int& status, const UdpAddress& addr)
+Snmp::Snmp(
+    int& status, const UdpAddress& addr, const transport_type transport)
     : SnmpSynchronized(),
 #ifdef _SNMPv3
       mpv3(v3MP::instance),
 #endif
-      m_isThreadRunning(false), m_pollTimeOut(DEFAULT_TIMEOUT)
+      m_isThreadRunning(false), m_pollTimeOut(DEFAULT_TIMEOUT),
+      m_transport(transport)
 {
     IpAddress* addresses[2];
 
@@ -833,12 +1189,14 @@ Snmp::Snmp(int& status, const UdpAddress& addr)
     }
 }
 
-Snmp::Snmp(int& status, const UdpAddress& addr_v4, const UdpAddress& addr_v6)
+Snmp::Snmp(int& status, const UdpAddress& addr_v4, const UdpAddress& addr_v6,
+    const transport_type transport)
     : SnmpSynchronized(),
 #ifdef _SNMPv3
       mpv3(v3MP::instance),
 #endif
-      m_isThreadRunning(false), m_pollTimeOut(DEFAULT_TIMEOUT)
+      m_isThreadRunning(false), m_pollTimeOut(DEFAULT_TIMEOUT),
+      m_transport(transport)
 {
     IpAddress* addresses[2];
 
@@ -874,13 +1232,20 @@ void Snmp::init(int& status, IpAddress* addresses[2],
     m_hThread = INVALID_HANDLE_VALUE;
 #    endif
 #endif
+#ifdef HAVE_IO_URING
+    m_uring[0] = nullptr;
+    m_uring[1] = nullptr;
+#endif
+    max_message_size = MAX_SNMP_PACKET;
 
     eventListHolder = new EventListHolder(this);
     // initialize the request_id
     eventListHolder->snmpEventList()->lock(); // FIXME: not exception save! CK
     //  srand(time(0)); // better than nothing
+    min_rid     = PDU_MIN_RID;
+    max_rid     = PDU_MAX_RID;
     current_rid = (rand() % (PDU_MAX_RID - PDU_MIN_RID + 1)) + PDU_MIN_RID;
-    debugprintf(4, "Initialized request_id to %i.", current_rid);
+    debugprintf(4, "Initialized request_id to %li.", current_rid);
     eventListHolder->snmpEventList()->unlock();
 
     // initialize all the trap receiving member variables
@@ -1020,6 +1385,13 @@ void Snmp::init(int& status, IpAddress* addresses[2],
                 int enable_broadcast = 1;
                 setsockopt(iv_snmp_session, SOL_SOCKET, SO_BROADCAST,
                     (char*)&enable_broadcast, sizeof(enable_broadcast));
+#endif
+#ifdef HAVE_IO_URING
+                start_uring(0, iv_snmp_session);
+#endif
+#ifdef HAVE_EPOLL_SYSCALL
+                eventListHolder->RegisterFd(get_poll_fd(iv_snmp_session),
+                    POLLIN, eventListHolder->snmpEventList());
 #endif
             }
         }
@@ -1175,6 +1547,13 @@ void Snmp::init(int& status, IpAddress* addresses[2],
                 int enable_broadcast = 1;
                 setsockopt(iv_snmp_session_ipv6, SOL_SOCKET, SO_BROADCAST,
                     (char*)&enable_broadcast, sizeof(enable_broadcast));
+#    endif
+#    ifdef HAVE_IO_URING
+                start_uring(1, iv_snmp_session_ipv6);
+#    endif
+#    ifdef HAVE_EPOLL_SYSCALL
+                eventListHolder->RegisterFd(get_poll_fd(iv_snmp_session_ipv6),
+                    POLLIN, eventListHolder->snmpEventList());
 #    endif
             }
         }
@@ -1185,6 +1564,71 @@ void Snmp::init(int& status, IpAddress* addresses[2],
     return;
 }
 
+#ifdef HAVE_IO_URING
+void Snmp::start_uring(const int index, const SnmpSocket sock)
+{
+    if (m_transport != transport_io_uring)
+    {
+        return;
+    }
+
+    m_uring[index] = new SnmpUring();
+    if (!m_uring[index]->init(sock, max_message_size + 1))
+    {
+        LOG_BEGIN(loggerModuleName, WARNING_LOG | 1);
+        LOG("Snmp: io_uring not available, polling the socket (socket)");
+        LOG(sock);
+        LOG_END;
+
+        delete m_uring[index];
+        m_uring[index] = nullptr;
+    }
+}
+#endif
+
+Snmp::transport_type Snmp::get_transport() const
+{
+#ifdef HAVE_IO_URING
+    if (m_uring[0] || m_uring[1])
+    {
+        return transport_io_uring;
+    }
+#endif
+    return transport_socket;
+}
+
+SnmpSocket Snmp::get_poll_fd(const SnmpSocket sock) const
+{
+#ifdef HAVE_IO_URING
+    for (auto* uring : m_uring)
+    {
+        if (uring && (uring->get_socket() == sock))
+        {
+            return uring->get_fd();
+        }
+    }
+#endif
+    return sock;
+}
+
+int Snmp::receive_datagrams(const SnmpSocket poll_fd, unsigned char* buffers,
+    const int buffer_size, long* lengths, SocketAddrType* from_addrs,
+    const int max_count)
+{
+#ifdef HAVE_IO_URING
+    for (auto* uring : m_uring)
+    {
+        if (uring && (uring->get_fd() == poll_fd))
+        {
+            return uring->receive(
+                buffers, buffer_size, lengths, from_addrs, max_count);
+        }
+    }
+#endif
+    return receive_snmp_datagrams(
+        poll_fd, buffers, buffer_size, lengths, from_addrs, max_count);
+}
+
 //---------[ Snmp Class Destructor ]----------------------------------
 Snmp::~Snmp()
 {
@@ -1197,6 +1641,13 @@ Snmp::~Snmp()
         // go through the snmpEventList and delete any outstanding
         // events on this socket
         eventListHolder->snmpEventList()->DeleteSocketEntry(iv_snmp_session);
+#ifdef HAVE_EPOLL_SYSCALL
+        eventListHolder->UnregisterFd(get_poll_fd(iv_snmp_session));
+#endif
+#ifdef HAVE_IO_URING
+        delete m_uring[0];
+        m_uring[0] = nullptr;
+#endif
 
         close(iv_snmp_session); // close the dynamic socket
     }
@@ -1208,6 +1659,13 @@ Snmp::~Snmp()
         // events on this socket
         eventListHolder->snmpEventList()->DeleteSocketEntry(
             iv_snmp_session_ipv6);
+#    ifdef HAVE_EPOLL_SYSCALL
+        eventListHolder->UnregisterFd(get_poll_fd(iv_snmp_session_ipv6));
+#    endif
+#    ifdef HAVE_IO_URING
+        delete m_uring[1];
+        m_uring[1] = nullptr;
+#    endif
 
         close(iv_snmp_session_ipv6); // close the dynamic socket
     }
@@ -1323,6 +1781,15 @@ int Snmp::get(Pdu& pdu, SnmpTarget& target, const snmp_callback callback,
     return snmp_engine(pdu, 0, 0, target, callback, callback_data);
 }
 
+//------------------------[ get async view ]-----------------------------
+int Snmp::get(Pdu& pdu, SnmpTarget& target, const snmp_view_callback callback,
+    const void* callback_data)
+{
+    pdu.set_type(sNMP_PDU_GET_ASYNC);
+    return snmp_engine(pdu, 0, 0, target, nullptr, callback_data,
+        INVALID_SOCKET, 0, nullptr, callback);
+}
+
 //------------------------[ get next ]-----------------------------------
 int Snmp::get_next(Pdu& pdu, SnmpTarget& target)
 {
@@ -1338,6 +1805,15 @@ int Snmp::get_next(Pdu& pdu, SnmpTarget& target, const snmp_callback callback,
     return snmp_engine(pdu, 0, 0, target, callback, callback_data);
 }
 
+//------------------------[ get next async view ]------------------------
+int Snmp::get_next(Pdu& pdu, SnmpTarget& target,
+    const snmp_view_callback callback, const void* callback_data)
+{
+    pdu.set_type(sNMP_PDU_GETNEXT_ASYNC);
+    return snmp_engine(pdu, 0, 0, target, nullptr, callback_data,
+        INVALID_SOCKET, 0, nullptr, callback);
+}
+
 //-------------------------[ set ]---------------------------------------
 int Snmp::set(Pdu& pdu, SnmpTarget& target)
 {
@@ -1376,6 +1852,281 @@ int Snmp::get_bulk(Pdu& pdu,           // pdu to use
         pdu, non_repeaters, max_reps, target, callback, callback_data);
 }
 
+//-----------------------[ get bulk async view ]-------------------------
+int Snmp::get_bulk(Pdu& pdu,              // pdu to use
+    SnmpTarget&              target,        // destination target
+    const int                non_repeaters, // number of non repeaters
+    const int                max_reps,      // maximum number of repetitions
+    const snmp_view_callback callback,      // callback to use
+    const void*              callback_data) // callback data
+{
+    pdu.set_type(sNMP_PDU_GETBULK_ASYNC);
+    return snmp_engine(pdu, non_repeaters, max_reps, target, nullptr,
+        callback_data, INVALID_SOCKET, 0, nullptr, callback);
+}
+
+//-----------------------[ send batch ]----------------------------------
+int Snmp::send_batch(SnmpBatchRequest* requests, const int count)
+{
+    SnmpSendBatch batch;
+    int           sent = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        SnmpBatchRequest& request = requests[i];
+
+        if ((request.type != sNMP_PDU_GET_ASYNC)
+            && (request.type != sNMP_PDU_GETNEXT_ASYNC)
+            && (request.type != sNMP_PDU_SET_ASYNC)
+            && (request.type != sNMP_PDU_GETBULK_ASYNC)
+            && (request.type != sNMP_PDU_INFORM_ASYNC))
+        {
+            request.status = SNMP_CLASS_INVALID_OPERATION;
+            continue;
+        }
+        if (!request.pdu)
+        {
+            request.status = SNMP_CLASS_INVALID_PDU;
+            continue;
+        }
+        if (!request.target)
+        {
+            request.status = SNMP_CLASS_INVALID_TARGET;
+            continue;
+        }
+        if (request.type == sNMP_PDU_INFORM_ASYNC)
+        {
+            if (request.target->get_version() == version1)
+            {
+                request.status = SNMP_CLASS_INVALID_OPERATION;
+                continue;
+            }
+            check_notify_timestamp(*request.pdu);
+        }
+        request.pdu->set_type(request.type);
+        batch.request  = i;
+        request.status = snmp_engine(*request.pdu, request.non_repeaters,
+            request.max_reps, *request.target, request.callback,
+            request.callback_data, INVALID_SOCKET, 0, &batch);
+    }
+
+    lock(); // FIXME: not exception save! CK
+    send_snmp_batch(batch);
+    unlock();
+
+    for (int i = 0; i < batch.count; i++)
+    {
+        SnmpSendBatch::Entry const& entry = batch.entries[i];
+
+        if (!entry.failed)
+        {
+            sent++;
+            continue;
+        }
+        // remove the id from message queue
+        eventListHolder->snmpEventList()->lock();
+        eventListHolder->snmpEventList()->DeleteEntry(entry.req_id);
+        eventListHolder->snmpEventList()->unlock();
+#ifdef _SNMPv3
+        auto* v3CallBackData = (struct V3CallBackData*)entry.v3_callback_data;
+        if (v3CallBackData)
+        {
+            deleteV3Callback(v3CallBackData);
+        }
+#endif
+        requests[entry.request].status = SNMP_CLASS_TL_FAILED;
+    }
+    return sent;
+}
+
+//-----------------------[ send prepared ]-------------------------------
+int Snmp::send_prepared(const PreparedRequest& request, SnmpTarget& target,
+    const snmp_callback callback, const void* callback_data)
+{
+    return prepared_engine(
+        request, target, callback, callback_data, nullptr, nullptr);
+}
+
+//-----------------------[ send prepared view ]--------------------------
+int Snmp::send_prepared(const PreparedRequest& request, SnmpTarget& target,
+    const snmp_view_callback callback, const void* callback_data)
+{
+    return prepared_engine(
+        request, target, nullptr, callback_data, nullptr, callback);
+}
+
+//-----------------------[ send prepared batch ]-------------------------
+int Snmp::send_prepared(const PreparedRequest& request,
+    SnmpTarget* const* targets, const int count, const snmp_callback callback,
+    const void* callback_data, int* status)
+{
+    SnmpSendBatch batch;
+    int           sent = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        int result = SNMP_CLASS_INVALID_TARGET;
+
+        if (targets[i])
+        {
+            batch.request = i;
+            result        = prepared_engine(request, *targets[i], callback,
+                callback_data, &batch, nullptr);
+        }
+        if (status)
+        {
+            status[i] = result;
+        }
+    }
+
+    lock(); // FIXME: not exception save! CK
+    send_snmp_batch(batch);
+    unlock();
+
+    for (int i = 0; i < batch.count; i++)
+    {
+        SnmpSendBatch::Entry const& entry = batch.entries[i];
+
+        if (!entry.failed)
+        {
+            sent++;
+            continue;
+        }
+        // remove the id from message queue
+        eventListHolder->snmpEventList()->lock();
+        eventListHolder->snmpEventList()->DeleteEntry(entry.req_id);
+        eventListHolder->snmpEventList()->unlock();
+        if (status)
+        {
+            status[entry.request] = SNMP_CLASS_TL_FAILED;
+        }
+    }
+    return sent;
+}
+
+//---------[ prepared request engine ]-----------------------------------
+// Like snmp_engine() for async requests, but the message is copied
+// from the prepared request and only the request id is set.
+int Snmp::prepared_engine(const PreparedRequest& request,
+    SnmpTarget& target, const snmp_callback cb, const void* cbd,
+    SnmpSendBatch* batch, const snmp_view_callback view_cb)
+{
+    if (!request.valid())
+    {
+        return SNMP_CLASS_INVALID_PDU;
+    }
+    if ((cb == nullptr) && (view_cb == nullptr))
+    {
+        return SNMP_CLASS_INVALID_CALLBACK;
+    }
+    if (!target.valid())
+    {
+        return SNMP_CLASS_INVALID_TARGET;
+    }
+    if (target.get_version() != request.get_version())
+    {
+        debugprintf(0, "-- SNMP++, target does not match prepared version");
+        return SNMP_CLASS_INVALID_TARGET;
+    }
+
+    GenAddress address;
+    target.get_address(address);
+    if (!address.valid())
+    {
+        debugprintf(0, "-- SNMP++, Target contains invalid address");
+        return SNMP_CLASS_INVALID_TARGET;
+    }
+
+    //----------[ validate the target address ]--------------------------
+    if ((address.get_type() != Address::type_ip)
+        && (address.get_type() != Address::type_udp))
+    {
+        debugprintf(0, "-- SNMP++, Bad address type");
+        return SNMP_CLASS_TL_UNSUPPORTED;
+    }
+
+    UdpAddress udp_address(address);
+    if (!udp_address.valid())
+    {
+        debugprintf(0, "-- SNMP++, Bad address");
+        return SNMP_CLASS_RESOURCE_UNAVAIL;
+    }
+
+    //----------[ choose the target address port ]-----------------------
+    if ((address.get_type() == Address::type_ip) || !udp_address.get_port())
+    {
+        udp_address.set_port(SNMP_PP_DEFAULT_SNMP_PORT);
+
+        // We need the port information within the target!
+        target.set_address(udp_address);
+    }
+
+    // check socket to use
+#ifdef SNMP_PP_IPv6
+    SnmpSocket iv_session_used = iv_snmp_session_ipv6;
+
+    if (udp_address.get_ip_version() == Address::version_ipv4)
+    {
+        if (iv_snmp_session != INVALID_SOCKET)
+        {
+            iv_session_used = iv_snmp_session;
+        }
+        else
+        {
+            udp_address.map_to_ipv6();
+        }
+    }
+#else
+    SnmpSocket iv_session_used = iv_snmp_session;
+#endif
+
+    long const            req_id = MyMakeReqId();
+    int                   len    = max_message_size;
+    Buffer<unsigned char> buffer(len);
+    unsigned char*        buf    = buffer.get_ptr();
+    int                   status = request.build(req_id, buf, &len);
+
+    if (status != SNMP_CLASS_SUCCESS)
+    {
+        return status;
+    }
+
+    // first add the message to the queue
+    bool queued = false;
+    eventListHolder->snmpEventList()->AddEntry(req_id, this, iv_session_used,
+        target, request.get_pdu(), buf, (size_t)len, udp_address, cb,
+        (void*)cbd, &queued, view_cb);
+
+    //------[ send the request ]
+    if (queued)
+    {
+        // sent by the message queue as soon as the limits allow
+        status = 0;
+    }
+    else if (batch)
+    {
+        status = batch->add(
+            iv_session_used, buf, (size_t)len, udp_address, req_id, nullptr);
+    }
+    else
+    {
+        lock(); // FIXME: not exception save! CK
+        status = send_snmp_request(
+            iv_session_used, buf, (size_t)len, udp_address);
+        unlock();
+    }
+
+    if (status != 0)
+    {
+        // remove the id from message queue
+        eventListHolder->snmpEventList()->lock();
+        eventListHolder->snmpEventList()->DeleteEntry(req_id);
+        eventListHolder->snmpEventList()->unlock();
+        return SNMP_CLASS_TL_FAILED;
+    }
+    return SNMP_CLASS_SUCCESS;
+}
+
 //------------------------[ inform_response ]----------------------------
 int Snmp::response(Pdu& pdu,    // pdu to use
     SnmpTarget&         target, // response target
@@ -1627,7 +2378,7 @@ int Snmp::trap(Pdu&   pdu,    // pdu to send
         pdu.set_type(sNMP_PDU_TRAP);
     }
 
-    SnmpMessage snmpmsg;
+    SnmpMessage snmpmsg(max_message_size);
 
 #ifdef _SNMPv3
     if (version == version3)
@@ -1823,7 +2574,8 @@ int Snmp::snmp_engine(Pdu& pdu,      // pdu to use
     SnmpTarget&            target,   // from this target
     const snmp_callback    cb,       // callback for async calls
     const void*            cbd,      // callback data
-    SnmpSocket fd, int reports_received)
+    SnmpSocket fd, int reports_received, SnmpSendBatch* batch,
+    const snmp_view_callback view_cb) // callback for async view calls
 
 {
     long req_id = 0; // pdu request id
@@ -1860,7 +2612,7 @@ int Snmp::snmp_engine(Pdu& pdu,      // pdu to use
         //---------[ check for correct mode ]---------------------------
         // if the class was constructed as a blocked model, callback=0
         // and async calls are attempted, an error is returned
-        if ((cb == nullptr)
+        if ((cb == nullptr) && (view_cb == nullptr)
             && ((action == sNMP_PDU_GET_ASYNC)
                 || (action == sNMP_PDU_SET_ASYNC)
                 || (action == sNMP_PDU_GETNEXT_ASYNC)
@@ -1873,7 +2625,7 @@ int Snmp::snmp_engine(Pdu& pdu,      // pdu to use
         //---------[ more mode checking ]--------------------------------
         // if the class was constructed as an async model, callback = something
         // and blocked calls are attempted, an error is returned
-        if ((cb != nullptr)
+        if (((cb != nullptr) || (view_cb != nullptr))
             && ((action == sNMP_PDU_GET) || (action == sNMP_PDU_SET)
                 || (action == sNMP_PDU_GETNEXT) || (action == sNMP_PDU_GETBULK)
                 || (action == sNMP_PDU_INFORM)))
@@ -1998,6 +2750,15 @@ int Snmp::snmp_engine(Pdu& pdu,      // pdu to use
             return SNMP_CLASS_INVALID_TARGET;
         }
 
+#ifdef _SNMPv3
+        // a view needs the plain message, SNMPv3 responses are decoded
+        if (view_cb && (version == version3))
+        {
+            debugprintf(0, "-- SNMP++, PduView not supported for SNMPv3");
+            return SNMP_CLASS_UNSUPPORTED;
+        }
+#endif
+
         //----------[ validate the target address ]--------------------------
         if ((address.get_type() != Address::type_ip)
             && (address.get_type() != Address::type_udp))
@@ -2081,7 +2842,7 @@ int Snmp::snmp_engine(Pdu& pdu,      // pdu to use
         }
 
         pdu.set_type(pdu_action);
-        SnmpMessage snmpmsg;
+        SnmpMessage snmpmsg(max_message_size);
 
 #ifdef _SNMPv3
         struct V3CallBackData* v3CallBackData = nullptr;
@@ -2156,6 +2917,7 @@ int Snmp::snmp_engine(Pdu& pdu,      // pdu to use
         }
 
         // first add the message to the queue
+        bool queued = false;
         if ((pdu_action != sNMP_PDU_RESPONSE)
             && (pdu_action != sNMP_PDU_REPORT))
         {
@@ -2184,22 +2946,41 @@ int Snmp::snmp_engine(Pdu& pdu,      // pdu to use
                 eventListHolder->snmpEventList()->AddEntry(req_id, this,
                     iv_session_used, target, pdu, snmpmsg.data(),
                     (size_t)snmpmsg.len(), udp_address, v3CallBack,
-                    (void*)v3CallBackData);
+                    (void*)v3CallBackData, &queued);
             }
             else
 #endif
             {
                 eventListHolder->snmpEventList()->AddEntry(req_id, this,
                     iv_session_used, target, pdu, snmpmsg.data(),
-                    (size_t)snmpmsg.len(), udp_address, cb, (void*)cbd);
+                    (size_t)snmpmsg.len(), udp_address, cb, (void*)cbd,
+                    &queued, view_cb);
             }
         }
 
         //------[ send the request ]
-        lock(); // FIXME: not exception save! CK
-        status = send_snmp_request(iv_session_used, snmpmsg.data(),
-            (size_t)snmpmsg.len(), udp_address);
-        unlock();
+        if (queued)
+        {
+            // sent by the message queue as soon as the limits allow
+            status = 0;
+        }
+        else if (batch)
+        {
+            void* v3_callback_data = nullptr;
+#ifdef _SNMPv3
+            v3_callback_data = v3CallBackData;
+#endif
+            // only async requests are collected, sent by send_batch()
+            status = batch->add(iv_session_used, snmpmsg.data(),
+                (size_t)snmpmsg.len(), udp_address, req_id, v3_callback_data);
+        }
+        else
+        {
+            lock(); // FIXME: not exception save! CK
+            status = send_snmp_request(iv_session_used, snmpmsg.data(),
+                (size_t)snmpmsg.len(), udp_address);
+            unlock();
+        }
 
         if (status != 0)
         {
@@ -2368,6 +3149,13 @@ int Snmp::engine_id_discovery(
     sock = iv_snmp_session;
 #    endif
 
+    if (get_poll_fd(sock) != sock)
+    {
+        // the socket is read by io_uring, responses would not show up here
+        debugprintf(0, "Discovery is not supported with io_uring.");
+        return SNMP_CLASS_TL_UNSUPPORTED;
+    }
+
     lock(); // FIXME: not exception save! CK
     if (send_snmp_request(sock, message, message_length, uaddr) < 0)
     {
@@ -2535,6 +3323,13 @@ int Snmp::broadcast_discovery(UdpAddressCollection& addresses,
     sock = iv_snmp_session;
 #endif
 
+    if (get_poll_fd(sock) != sock)
+    {
+        // the socket is read by io_uring, responses would not show up here
+        debugprintf(0, "Discovery is not supported with io_uring.");
+        return SNMP_CLASS_TL_UNSUPPORTED;
+    }
+
     lock(); // FIXME: not exception save! CK
     if (send_snmp_request(sock, message, message_length, uaddr) < 0)
     {
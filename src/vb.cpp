@@ -55,6 +55,7 @@
 #include "snmp_pp/vb.h" // include vb class defs
 
 #include <libsnmp.h>
+#include <typeinfo>
 
 #ifdef SNMP_PP_NAMESPACE
 namespace Snmp_pp
@@ -70,6 +71,7 @@ namespace Snmp_pp
 // must have a valid oid and value
 bool Vb::valid() const
 {
+    // values stored inside the vb are always valid
     if (iv_vb_oid.valid()
         && ((iv_vb_value == nullptr) || (iv_vb_value && iv_vb_value->valid())))
     {
@@ -94,7 +96,13 @@ Vb& Vb::operator=(const Vb& vb)
     vb.get_oid(iv_vb_oid);
 
     //-----[ next set the vb value portion ]
-    if (vb.iv_vb_value)
+    if (vb.m_inlineType != inline_none)
+    {
+        m_inlineType = vb.m_inlineType;
+        m_valueLen   = vb.m_valueLen;
+        m_value      = vb.m_value;
+    }
+    else if (vb.iv_vb_value)
     {
         iv_vb_value = vb.iv_vb_value->clone();
     }
@@ -104,6 +112,31 @@ Vb& Vb::operator=(const Vb& vb)
     return *this; // return self reference
 }
 
+//---------------[ Vb& Vb::operator=(Vb &&vb) ]-------------------------
+// move assignment takes the oid and the value of the source vb
+Vb& Vb::operator=(Vb&& vb) noexcept
+{
+    if (this == &vb)
+    {
+        return *this; // check for self assignment
+    }
+    free_vb();
+
+    iv_vb_oid        = std::move(vb.iv_vb_oid);
+    iv_vb_value      = vb.iv_vb_value;
+    m_printable      = vb.m_printable;
+    m_inlineType     = vb.m_inlineType;
+    m_valueLen       = vb.m_valueLen;
+    m_value          = vb.m_value;
+    exception_status = vb.exception_status;
+
+    vb.iv_vb_value  = nullptr;
+    vb.m_printable  = nullptr;
+    vb.m_inlineType = inline_none;
+
+    return *this;
+}
+
 //----------------[ void Vb::free_vb() ]--------------------------------
 // protected method to free memory
 // this method is used to free memory when assigning new vbs
@@ -116,14 +149,226 @@ void Vb::free_vb()
         delete iv_vb_value;
         iv_vb_value = nullptr;
     }
+    if (m_printable)
+    {
+        delete m_printable;
+        m_printable = nullptr;
+    }
+    m_inlineType     = inline_none;
     exception_status = SNMP_CLASS_SUCCESS;
 }
 
+//----------------[ Vb::set_value(const SnmpSyntax &val) ]---------------
+// store the value inside the vb if possible, else clone it
+void Vb::set_value(const SnmpSyntax& val)
+{
+    free_vb();
+    if (!set_inline_value(val))
+    {
+        iv_vb_value = val.clone();
+    }
+}
+
+void Vb::set_value(const unsigned char* ptr, const uint32_t len)
+{
+    free_vb();
+    if (!ptr || (len <= SNMP_PP_VB_INLINE_SIZE))
+    {
+        m_inlineType = inline_octets;
+        m_valueLen   = ptr ? len : 0;
+        if (m_valueLen)
+        {
+            memcpy(m_value.octets, ptr, len);
+        }
+    }
+    else
+    {
+        iv_vb_value = new OctetStr(ptr, len);
+    }
+}
+
+// Only objects of exactly these classes are stored inside the vb, so
+// subclasses keep their behavior.
+bool Vb::set_inline_value(const SnmpSyntax& val)
+{
+    if (!val.valid())
+    {
+        return false;
+    }
+
+    std::type_info const& type = typeid(val);
+    switch (val.get_syntax())
+    {
+    case sNMP_SYNTAX_INT32: {
+        if (type != typeid(SnmpInt32))
+        {
+            return false;
+        }
+        m_value.i32 = (int32_t)(const SnmpInt32&)val;
+        m_inlineType = inline_int32;
+        return true;
+    }
+
+    case sNMP_SYNTAX_CNTR32:
+    case sNMP_SYNTAX_GAUGE32: // same as sNMP_SYNTAX_UINT32
+    case sNMP_SYNTAX_TIMETICKS: {
+        if (type == typeid(Counter32))
+        {
+            m_inlineType = inline_counter32;
+        }
+        else if (type == typeid(Gauge32))
+        {
+            m_inlineType = inline_gauge32;
+        }
+        else if (type == typeid(TimeTicks))
+        {
+            m_inlineType = inline_timeticks;
+        }
+        else if (type == typeid(SnmpUInt32))
+        {
+            m_inlineType = inline_uint32;
+        }
+        else
+        {
+            return false;
+        }
+        m_value.u32 = (uint32_t)(const SnmpUInt32&)val;
+        return true;
+    }
+
+    case sNMP_SYNTAX_CNTR64: {
+        if (type != typeid(Counter64))
+        {
+            return false;
+        }
+        m_value.u64  = (pp_uint64)(const Counter64&)val;
+        m_inlineType = inline_counter64;
+        return true;
+    }
+
+    case sNMP_SYNTAX_OCTETS: {
+        auto const& octets = (const OctetStr&)val;
+        if ((type != typeid(OctetStr))
+            || (octets.len() > SNMP_PP_VB_INLINE_SIZE))
+        {
+            return false;
+        }
+        m_valueLen = octets.len();
+        if (m_valueLen)
+        {
+            memcpy(m_value.octets, octets.data(), m_valueLen);
+        }
+        m_inlineType = inline_octets;
+        return true;
+    }
+
+    case sNMP_SYNTAX_IPADDR: {
+        auto const& address = (const IpAddress&)val;
+        int const   len     = address.get_length();
+        // IPv4 and IPv6 addresses without scope
+        if ((type != typeid(IpAddress)) || ((len != 4) && (len != 16)))
+        {
+            return false;
+        }
+        for (int i = 0; i < len; ++i) { m_value.octets[i] = address[i]; }
+        m_valueLen   = len;
+        m_inlineType = inline_ipaddress;
+        return true;
+    }
+
+    case sNMP_SYNTAX_OID: {
+        auto const& oid = (const Oid&)val;
+        if ((type != typeid(Oid)) || (oid.len() == 0)
+            || (oid.len() > SNMP_PP_VB_INLINE_SIZE / sizeof(SmiUINT32)))
+        {
+            return false;
+        }
+        m_valueLen = oid.len();
+        memcpy(m_value.oid, ((Oid&)oid).oidval()->ptr,
+            m_valueLen * sizeof(SmiUINT32));
+        m_inlineType = inline_oid;
+        return true;
+    }
+    }
+    return false;
+}
+
+template <class Func> void Vb::with_inline_value(Func func) const
+{
+    switch (m_inlineType)
+    {
+    case inline_int32: {
+        SnmpInt32 const tmp(m_value.i32);
+        func(tmp);
+        break;
+    }
+    case inline_uint32: {
+        SnmpUInt32 const tmp(m_value.u32);
+        func(tmp);
+        break;
+    }
+    case inline_counter32: {
+        Counter32 const tmp(m_value.u32);
+        func(tmp);
+        break;
+    }
+    case inline_gauge32: {
+        Gauge32 const tmp(m_value.u32);
+        func(tmp);
+        break;
+    }
+    case inline_timeticks: {
+        TimeTicks const tmp(m_value.u32);
+        func(tmp);
+        break;
+    }
+    case inline_counter64: {
+        Counter64 const tmp(m_value.u64);
+        func(tmp);
+        break;
+    }
+    case inline_octets: {
+        OctetStr const tmp(m_value.octets, m_valueLen);
+        func(tmp);
+        break;
+    }
+    case inline_ipaddress: {
+        IpAddress tmp;
+        tmp = OctetStr(m_value.octets, m_valueLen);
+        func(tmp);
+        break;
+    }
+    case inline_oid: {
+        Oid const tmp(m_value.oid, (int)m_valueLen);
+        func(tmp);
+        break;
+    }
+    case inline_none: {
+        break;
+    }
+    }
+}
+
+SnmpSyntax* Vb::new_value() const
+{
+    SnmpSyntax* value = nullptr;
+
+    with_inline_value([&value](const SnmpSyntax& tmp) {
+        value = tmp.clone();
+    });
+    return value;
+}
+
 //---------------------[ Vb::get_value(int &i) ]----------------------
 // get value int
 // returns 0 on success and value
 int Vb::get_value(int32_t& i) const
 {
+    if (m_inlineType == inline_int32)
+    {
+        i = m_value.i32;
+        return SNMP_CLASS_SUCCESS;
+    }
     if (iv_vb_value && iv_vb_value->valid()
         && (iv_vb_value->get_syntax() == sNMP_SYNTAX_INT32))
     {
@@ -140,6 +385,11 @@ int Vb::get_value(int32_t& i) const
 // returns 0 on success and a value
 int Vb::get_value(uint32_t& i) const
 {
+    if ((m_inlineType >= inline_uint32) && (m_inlineType <= inline_timeticks))
+    {
+        i = m_value.u32;
+        return SNMP_CLASS_SUCCESS;
+    }
     if (iv_vb_value && iv_vb_value->valid()
         && ((iv_vb_value->get_syntax() == sNMP_SYNTAX_UINT32)
             || (iv_vb_value->get_syntax() == sNMP_SYNTAX_CNTR32)
@@ -195,6 +445,11 @@ int Vb::get_value(uint32_t&i) const
 // returns 0 on success and a value
 int Vb::get_value(pp_uint64& i) const
 {
+    if (m_inlineType == inline_counter64)
+    {
+        i = m_value.u64;
+        return SNMP_CLASS_SUCCESS;
+    }
     if (iv_vb_value && iv_vb_value->valid()
         && (iv_vb_value->get_syntax() == sNMP_SYNTAX_CNTR64))
     {
@@ -213,6 +468,13 @@ int Vb::get_value(pp_uint64& i) const
 // which is big enough to hold the string
 int Vb::get_value(unsigned char* ptr, uint32_t& len) const
 {
+    if (m_inlineType == inline_octets)
+    {
+        len = m_valueLen;
+        memcpy(ptr, m_value.octets, len);
+        ptr[len] = 0;
+        return SNMP_CLASS_SUCCESS;
+    }
     if (iv_vb_value && iv_vb_value->valid()
         && (iv_vb_value->get_syntax() == sNMP_SYNTAX_OCTETS))
     {
@@ -237,16 +499,30 @@ int Vb::get_value(unsigned char* ptr, uint32_t& len) const
 int Vb::get_value(unsigned char* ptr, uint32_t& len, const uint32_t maxlen,
     const bool add_null_byte) const
 {
-    if (iv_vb_value && iv_vb_value->valid()
+    const unsigned char* data  = nullptr;
+    bool                 found = false;
+
+    if ((m_inlineType == inline_octets) && (maxlen > 0))
+    {
+        data  = m_value.octets;
+        len   = m_valueLen;
+        found = true;
+    }
+    else if (iv_vb_value && iv_vb_value->valid()
         && (iv_vb_value->get_syntax() == sNMP_SYNTAX_OCTETS) && (maxlen > 0))
     {
         auto* p_os = dynamic_cast<OctetStr*>(iv_vb_value);
+        data       = p_os->data();
         len        = p_os->len();
+        found      = true;
+    }
+    if (found)
+    {
         if (len > maxlen)
         {
             len = maxlen;
         }
-        memcpy(ptr, p_os->data(), len);
+        memcpy(ptr, data, len);
         if (add_null_byte)
         {
             if (len == maxlen)
@@ -272,6 +548,24 @@ int Vb::get_value(unsigned char* ptr, uint32_t& len, const uint32_t maxlen,
 //---------------[ Vb::get_value(Value &val) ]--------
 int Vb::get_value(SnmpSyntax& val) const
 {
+    if (m_inlineType != inline_none)
+    {
+        // assign without a temporary object where the class matches
+        if ((m_inlineType == inline_octets)
+            && (typeid(val) == typeid(OctetStr)))
+        {
+            ((OctetStr&)val).set_data(m_value.octets, m_valueLen);
+        }
+        else if ((m_inlineType == inline_oid) && (typeid(val) == typeid(Oid)))
+        {
+            ((Oid&)val).set_data(m_value.oid, m_valueLen);
+        }
+        else
+        {
+            with_inline_value([&val](const SnmpSyntax& tmp) { val = tmp; });
+        }
+        return val.valid() ? SNMP_CLASS_SUCCESS : SNMP_CLASS_INVALID;
+    }
     if (iv_vb_value)
     {
         val = *iv_vb_value;
@@ -294,6 +588,12 @@ int Vb::get_value(char* ptr) const
 {
     if (ptr)
     {
+        if (m_inlineType == inline_octets)
+        {
+            memcpy(ptr, m_value.octets, m_valueLen);
+            ptr[m_valueLen] = 0;
+            return SNMP_CLASS_SUCCESS;
+        }
         if (iv_vb_value && iv_vb_value->valid()
             && (iv_vb_value->get_syntax() == sNMP_SYNTAX_OCTETS))
         {
@@ -313,6 +613,11 @@ int Vb::get_value(char* ptr) const
 
 int Vb::get_value(std::string& str) const
 {
+    if (m_inlineType == inline_octets)
+    {
+        str.assign(reinterpret_cast<const char*>(m_value.octets), m_valueLen);
+        return SNMP_CLASS_SUCCESS;
+    }
     if (iv_vb_value && iv_vb_value->valid()
         && (iv_vb_value->get_syntax() == sNMP_SYNTAX_OCTETS))
     {
@@ -341,10 +646,20 @@ SmiUINT32 Vb::get_syntax() const
     {
         return exception_status;
     }
-    else
+    switch (m_inlineType)
     {
-        return iv_vb_value ? iv_vb_value->get_syntax() : sNMP_SYNTAX_NULL;
-    }
+    case inline_int32: return sNMP_SYNTAX_INT32;
+    case inline_uint32: return sNMP_SYNTAX_UINT32;
+    case inline_counter32: return sNMP_SYNTAX_CNTR32;
+    case inline_gauge32: return sNMP_SYNTAX_GAUGE32;
+    case inline_timeticks: return sNMP_SYNTAX_TIMETICKS;
+    case inline_counter64: return sNMP_SYNTAX_CNTR64;
+    case inline_octets: return sNMP_SYNTAX_OCTETS;
+    case inline_ipaddress: return sNMP_SYNTAX_IPADDR;
+    case inline_oid: return sNMP_SYNTAX_OID;
+    case inline_none: break;
+    }
+    return iv_vb_value ? iv_vb_value->get_syntax() : sNMP_SYNTAX_NULL;
 }
 
 void Vb::set_syntax(const SmiUINT32 syntax)
@@ -353,25 +668,29 @@ void Vb::set_syntax(const SmiUINT32 syntax)
 
     exception_status = SNMP_CLASS_SUCCESS;
 
+    // zero values are stored inside the vb
+    m_value.u64 = 0;
+    m_valueLen  = 0;
+
     switch (syntax)
     {
     case sNMP_SYNTAX_INT32: {
-        iv_vb_value = new SnmpInt32();
+        m_inlineType = inline_int32;
         break;
     }
 
     case sNMP_SYNTAX_TIMETICKS: {
-        iv_vb_value = new TimeTicks();
+        m_inlineType = inline_timeticks;
         break;
     }
 
     case sNMP_SYNTAX_CNTR32: {
-        iv_vb_value = new Counter32();
+        m_inlineType = inline_counter32;
         break;
     }
 
     case sNMP_SYNTAX_GAUGE32: {
-        iv_vb_value = new Gauge32();
+        m_inlineType = inline_gauge32;
         break;
     }
 
@@ -381,13 +700,13 @@ void Vb::set_syntax(const SmiUINT32 syntax)
      *              break;
      */
     case sNMP_SYNTAX_CNTR64: {
-        iv_vb_value = new Counter64();
+        m_inlineType = inline_counter64;
         break;
     }
 
     case sNMP_SYNTAX_BITS:
     case sNMP_SYNTAX_OCTETS: {
-        iv_vb_value = new OctetStr();
+        m_inlineType = inline_octets;
         break;
     }
 
@@ -436,6 +755,16 @@ const static char blank_string[] = "";
 // return the printabel value
 const char* Vb::get_printable_value() const
 {
+    if (m_inlineType != inline_none)
+    {
+        // the returned string is owned by the object, keep it until the
+        // value changes
+        if (!m_printable)
+        {
+            m_printable = new_value();
+        }
+        return m_printable->get_printable();
+    }
     if (iv_vb_value)
     {
         return iv_vb_value->get_printable();
@@ -446,6 +775,21 @@ const char* Vb::get_printable_value() const
 int Vb::get_asn1_length() const
 {
     // FIXME: Header for vbs is always 4 Bytes!
+    if ((m_inlineType == inline_octets) || (m_inlineType == inline_ipaddress))
+    {
+        int const header = (m_valueLen < 0x80) ? 2 : 3;
+
+        return iv_vb_oid.get_asn1_length() + header + (int)m_valueLen + 4;
+    }
+    if (m_inlineType != inline_none)
+    {
+        int length = 0;
+
+        with_inline_value([&length](const SnmpSyntax& tmp) {
+            length = tmp.get_asn1_length();
+        });
+        return iv_vb_oid.get_asn1_length() + length + 4;
+    }
     if (iv_vb_value)
     {
         return iv_vb_oid.get_asn1_length() + iv_vb_value->get_asn1_length()